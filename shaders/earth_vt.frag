@@ -0,0 +1,59 @@
+#version 450
+
+layout(location = 0) in vec3 inColor;
+layout(location = 1) in vec2 inUV;
+layout(location = 2) flat in uint inTextureIndex;
+layout(location = 0) out vec4 outFragColor;
+
+layout(set = 0, binding = 3) uniform VirtualTextureParams {
+    uvec4 info;       // levelCount, tileSize, border, pagesPerSide
+    uvec4 extent;     // level 0 width, level 0 height, cache size in texels, feedback phase
+    uvec4 levels[16]; // width, height, tilesX, firstPage
+} vt;
+
+// bits 0-7 slot x, 8-15 slot y, 16-23 level of the resident page covering this page.
+layout(set = 0, binding = 4) readonly buffer PageTable {
+    uint entries[];
+} pageTable;
+
+layout(set = 0, binding = 5) buffer Feedback {
+    uint requested[];
+} feedback;
+
+layout(set = 0, binding = 6) uniform sampler2D pageCache;
+
+void main() {
+    uint levelCount = vt.info.x;
+    uint tileSize = vt.info.y;
+    float border = float(vt.info.z);
+    vec2 uv = vec2(fract(inUV.x), clamp(inUV.y, 0.0, 1.0));
+
+    // Level from the screen-space footprint in level 0 texels; finest level wins ties.
+    vec2 texel0 = inUV * vec2(vt.extent.xy);
+    vec2 dx = dFdx(texel0);
+    vec2 dy = dFdy(texel0);
+    float lod = 0.5 * log2(max(max(dot(dx, dx), dot(dy, dy)), 1e-8));
+    uint level = uint(clamp(floor(lod), 0.0, float(levelCount - 1u)));
+
+    uvec4 wanted = vt.levels[level];
+    uvec2 wantedTexel = min(uvec2(uv * vec2(wanted.xy)), wanted.xy - 1u);
+    uvec2 wantedTile = wantedTexel / tileSize;
+    uint page = wanted.w + wantedTile.y * wanted.z + wantedTile.x;
+
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    if (uint((pixel.x & 3) | ((pixel.y & 3) << 2)) == vt.extent.w) {
+        atomicOr(feedback.requested[page >> 5], 1u << (page & 31u));
+    }
+
+    uint entry = pageTable.entries[page];
+    uvec2 slot = uvec2(entry & 0xFFu, (entry >> 8) & 0xFFu);
+    uvec4 resident = vt.levels[(entry >> 16) & 0xFFu];
+    vec2 residentPos = uv * vec2(resident.xy);
+    uvec2 residentTile = min(uvec2(residentPos), resident.xy - 1u) / tileSize;
+    vec2 inPage = clamp(residentPos - vec2(residentTile * tileSize), vec2(0.0), vec2(float(tileSize)));
+
+    float pagePixels = float(tileSize) + 2.0 * border;
+    vec2 cacheTexel = vec2(slot) * pagePixels + border + inPage;
+    vec3 texColor = textureLod(pageCache, cacheTexel / float(vt.extent.z), 0.0).rgb;
+    outFragColor = vec4(texColor * inColor, 1.0);
+}
@@ -0,0 +1,11 @@
+#version 450
+
+layout(set = 0, binding = 0) uniform sampler2DArray tiles;
+
+layout(location = 0) in vec3 inTexCoord;
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+    outColor = texture(tiles, inTexCoord);
+}
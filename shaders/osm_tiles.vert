@@ -0,0 +1,35 @@
+#version 450
+
+layout(push_constant) uniform PushConstants
+{
+    mat4 projection;
+    mat4 modelView;
+} pc;
+
+layout(constant_id = 0) const float equatorialRadius = 1.0;
+layout(constant_id = 1) const float polarRadius = 1.0;
+
+// Grid position within the tile, (0,0) at the north-west corner.
+layout(location = 0) in vec2 inGrid;
+// Per tile: sin and cos of the west longitude / north latitude and the tile's extent in radians.
+// Only the small in-tile angle goes through sin/cos here, so positions keep float precision.
+layout(location = 1) in vec4 inLon;
+layout(location = 2) in vec4 inLat;
+// Per tile: uv offset, uv scale and texture array layer.
+layout(location = 3) in vec4 inTexture;
+
+layout(location = 0) out vec3 outTexCoord;
+
+void main()
+{
+    float dLon = inLon.z * inGrid.x;
+    float dLat = inLat.z * inGrid.y;
+    float sinLon = inLon.x * cos(dLon) + inLon.y * sin(dLon);
+    float cosLon = inLon.y * cos(dLon) - inLon.x * sin(dLon);
+    float sinLat = inLat.x * cos(dLat) + inLat.y * sin(dLat);
+    float cosLat = inLat.y * cos(dLat) - inLat.x * sin(dLat);
+    vec3 position = vec3(sinLon * cosLat * equatorialRadius, -cosLon * cosLat * equatorialRadius, sinLat * polarRadius);
+
+    gl_Position = (pc.projection * pc.modelView) * vec4(position, 1.0);
+    outTexCoord = vec3(inTexture.xy + inGrid * inTexture.z, inTexture.w);
+}
@@ -1,11 +1,15 @@
 #include "core/AppRunner.h"
 
+#include "core/mesh/MeshOptimize.h"
 #include "core/runtime/VkVisualizerApp.h"
+#include "vkscene/GltfModelObject.h"
 
+#include <chrono>
 #include <cstdlib>
 #include <iostream>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 /*
 Main app entry flow (runtime handoff):
@@ -29,12 +33,57 @@ void printHelp(const char* appName)
               << "  --help                    Show this help\n"
               << "  --seconds <value>         Run duration in seconds\n"
               << "  --duration <value>        Alias for --seconds\n"
-              << "  --earth-texture <path>    Texture image path (.jpg/.jpeg/.png";
+              << "  --earth-texture <path>    Texture image path (.vktx/.vktp/.jpg/.jpeg/.png";
 #if defined(VKRAW_ENABLE_IMAGE_FILE_IO)
     std::cout << "/.tif/.tiff";
 #endif
     std::cout << ")\n"
-              << "  --model <path>            glTF model path (.gltf/.glb) for vkScene\n";
+              << "  --model <path>            glTF model path (.gltf/.glb) for vkScene\n"
+              << "  --model-cache <dir>       Keep cooked model meshes in <dir> (default: next to the model)\n"
+              << "  --no-model-cache          Always load the model from its glTF files\n"
+              << "  --optimize-meshes         Deduplicate and reorder scene meshes for vertex cache and fetch\n"
+              << "  --model-load-bench <path> Load a glTF model a few times, print [BENCH] and exit\n";
+}
+
+// With the mesh cache on, the first pass cooks the cache (unless it is already current) and the
+// later ones load from it; with it off, every pass converts the glTF. Each pass also times
+// buildMesh, the copy the runtime makes before upload, since a cached model defers its reads to it.
+// With optimize, the last pass also runs the mesh optimizer over the result.
+int runModelLoadBenchmark(const std::string& path, const vkscene::MeshCacheOptions& cacheOptions, bool optimize)
+{
+    constexpr int kPasses = 3;
+    for (int pass = 0; pass < kPasses; ++pass) {
+        const auto start = std::chrono::steady_clock::now();
+        const vkscene::GltfModelObject model(path, 0, cacheOptions);
+        const double loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!model.loaded()) {
+            std::cerr << "error: failed to load '" << path << "': " << model.error() << '\n';
+            return EXIT_FAILURE;
+        }
+        const auto meshStart = std::chrono::steady_clock::now();
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        model.buildMesh(vertices, indices);
+        const double meshSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - meshStart).count();
+        const double seconds = loadSeconds + meshSeconds;
+
+        const char* source = !cacheOptions.enabled ? "gltf" : (model.fromCache() ? "cache" : "gltf_cooked");
+        std::cout << "[BENCH] model_load path=" << path << " pass=" << pass << " source=" << source << " vertices=" << vertices.size()
+                  << " indices=" << indices.size() << " load_s=" << loadSeconds << " mesh_s=" << meshSeconds << " seconds=" << seconds
+                  << " mvertices_per_s=" << (seconds > 0.0 ? static_cast<double>(vertices.size()) * 1e-6 / seconds : 0.0) << std::endl;
+
+        if (optimize && pass + 1 == kPasses) {
+            std::vector<core::mesh::IndexRange> ranges;
+            for (const vkscene::MeshRange& range : model.meshRanges()) ranges.push_back({range.firstIndex, range.indexCount});
+            const auto optimizeStart = std::chrono::steady_clock::now();
+            const core::mesh::MeshOptimizeStats stats = core::mesh::optimizeMesh(vertices, indices, ranges);
+            const double optimizeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - optimizeStart).count();
+            std::cout << "[BENCH] mesh_optimize path=" << path << " vertices_before=" << stats.verticesBefore << " vertices_after=" << stats.verticesAfter
+                      << " acmr_before=" << stats.before.acmr << " acmr_after=" << stats.after.acmr << " atvr_before=" << stats.before.atvr
+                      << " atvr_after=" << stats.after.atvr << " seconds=" << optimizeSeconds << std::endl;
+        }
+    }
+    return EXIT_SUCCESS;
 }
 
 } // namespace
@@ -45,6 +94,9 @@ int runVisualizerApp(int argc, char** argv, bool sceneMode, const char* appName)
         core::runtime::VkVisualizerApp visualizer;
         visualizer.setSceneMode(sceneMode);
 
+        vkscene::MeshCacheOptions modelCache{};
+        std::string modelLoadBenchPath;
+        bool optimizeMeshes = false;
         for (int i = 1; i < argc; ++i) {
             const std::string arg = argv[i];
             if (arg == "--help") {
@@ -57,8 +109,19 @@ int runVisualizerApp(int argc, char** argv, bool sceneMode, const char* appName)
                 visualizer.setEarthTexturePath(argv[++i]);
             } else if (arg == "--model" && (i + 1) < argc) {
                 visualizer.setSceneModelPath(argv[++i]);
+            } else if (arg == "--model-cache" && (i + 1) < argc) {
+                modelCache.directory = argv[++i];
+            } else if (arg == "--no-model-cache") {
+                modelCache.enabled = false;
+            } else if (arg == "--optimize-meshes") {
+                optimizeMeshes = true;
+            } else if (arg == "--model-load-bench" && (i + 1) < argc) {
+                modelLoadBenchPath = argv[++i];
             }
         }
+        if (!modelLoadBenchPath.empty()) return runModelLoadBenchmark(modelLoadBenchPath, modelCache, optimizeMeshes);
+        visualizer.setSceneModelCache(modelCache);
+        visualizer.setOptimizeSceneMeshes(optimizeMeshes);
 
         visualizer.run();
     } catch (const std::exception& e) {
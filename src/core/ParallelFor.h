@@ -0,0 +1,41 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace core {
+
+// Splits [0, count) into contiguous bands and calls fn(begin, end) once per band, one band per
+// hardware thread. The calling thread runs the first band itself. Meant for bulk startup work
+// (texture generation, image resampling/decoding); fn must not throw.
+template<class Fn>
+void parallelForBands(size_t count, size_t minBandSize, Fn&& fn)
+{
+    if (count == 0) return;
+
+    const size_t hardwareThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    const size_t maxBands = std::max<size_t>(1, count / std::max<size_t>(1, minBandSize));
+    const size_t bands = std::min(hardwareThreads, maxBands);
+    if (bands <= 1) {
+        fn(size_t{0}, count);
+        return;
+    }
+
+    const size_t baseSize = count / bands;
+    const size_t remainder = count % bands;
+    auto bandBegin = [&](size_t band) { return band * baseSize + std::min(band, remainder); };
+
+    std::vector<std::thread> workers;
+    workers.reserve(bands - 1);
+    for (size_t band = 1; band < bands; ++band) {
+        workers.emplace_back([&fn, begin = bandBegin(band), end = bandBegin(band + 1)]() { fn(begin, end); });
+    }
+    fn(bandBegin(0), bandBegin(1));
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+} // namespace core
@@ -50,6 +50,13 @@ struct ObjectUniformData {
     glm::uvec4 material;
 };
 
+// std140 layout of the virtual texture parameters (binding 3), see shaders/earth_vt.frag.
+struct VirtualTextureParams {
+    glm::uvec4 info{0};   // levelCount, tileSize, border, pagesPerSide
+    glm::uvec4 extent{0}; // level 0 width, level 0 height, cache size in texels, feedback phase
+    std::array<glm::uvec4, 16> levels{}; // width, height, tilesX, firstPage
+};
+
 struct PushConstantData {
     alignas(16) uint32_t objectIndex = 0;
     uint32_t _pad0 = 0;
@@ -0,0 +1,389 @@
+#include "core/image/BlockCompression.h"
+
+#include "core/ParallelFor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace core::image {
+
+namespace {
+
+using Block = uint8_t[16][4];
+
+constexpr size_t kMinBlockRowsPerBand = 4;
+
+// Gathers the 4x4 block at (bx, by); texels past the right/bottom edge repeat the last column/row.
+void loadBlock(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t bx, uint32_t by, Block& block)
+{
+    for (uint32_t y = 0; y < 4; ++y) {
+        const uint32_t sy = std::min(by * 4U + y, height - 1U);
+        for (uint32_t x = 0; x < 4; ++x) {
+            const uint32_t sx = std::min(bx * 4U + x, width - 1U);
+            std::memcpy(block[y * 4U + x], rgba + (static_cast<size_t>(sy) * width + sx) * 4U, 4);
+        }
+    }
+}
+
+void storeBlock(const Block& block, uint32_t width, uint32_t height, uint32_t bx, uint32_t by, uint8_t* rgba)
+{
+    for (uint32_t y = 0; y < 4; ++y) {
+        const uint32_t dy = by * 4U + y;
+        if (dy >= height) break;
+        for (uint32_t x = 0; x < 4; ++x) {
+            const uint32_t dx = bx * 4U + x;
+            if (dx >= width) break;
+            std::memcpy(rgba + (static_cast<size_t>(dy) * width + dx) * 4U, block[y * 4U + x], 4);
+        }
+    }
+}
+
+// Endpoints of the block's colour line: the extremes of the texels projected onto the principal
+// axis (power iteration on the covariance matrix) over the first `channels` channels.
+void principalEndpoints(const Block& block, int channels, float lo[4], float hi[4])
+{
+    float mean[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (const auto& texel : block) {
+        for (int c = 0; c < channels; ++c) mean[c] += texel[c];
+    }
+    for (int c = 0; c < channels; ++c) mean[c] /= 16.0f;
+
+    float cov[4][4] = {};
+    for (const auto& texel : block) {
+        float d[4] = {};
+        for (int c = 0; c < channels; ++c) d[c] = texel[c] - mean[c];
+        for (int i = 0; i < channels; ++i) {
+            for (int j = 0; j < channels; ++j) cov[i][j] += d[i] * d[j];
+        }
+    }
+
+    float axis[4] = {1.0f, 1.0f, 1.0f, channels > 3 ? 1.0f : 0.0f};
+    for (int iteration = 0; iteration < 8; ++iteration) {
+        float next[4] = {};
+        for (int i = 0; i < channels; ++i) {
+            for (int j = 0; j < channels; ++j) next[i] += cov[i][j] * axis[j];
+        }
+        float length = 0.0f;
+        for (int c = 0; c < channels; ++c) length = std::max(length, std::abs(next[c]));
+        if (length < 1e-6f) break;
+        for (int c = 0; c < channels; ++c) axis[c] = next[c] / length;
+    }
+    float axisLengthSq = 0.0f;
+    for (int c = 0; c < channels; ++c) axisLengthSq += axis[c] * axis[c];
+
+    float tMin = 0.0f;
+    float tMax = 0.0f;
+    if (axisLengthSq > 1e-12f) {
+        tMin = 1e30f;
+        tMax = -1e30f;
+        for (const auto& texel : block) {
+            float t = 0.0f;
+            for (int c = 0; c < channels; ++c) t += (texel[c] - mean[c]) * axis[c];
+            t /= axisLengthSq;
+            tMin = std::min(tMin, t);
+            tMax = std::max(tMax, t);
+        }
+    }
+    for (int c = 0; c < 4; ++c) {
+        lo[c] = std::clamp(mean[c] + axis[c] * tMin, 0.0f, 255.0f);
+        hi[c] = std::clamp(mean[c] + axis[c] * tMax, 0.0f, 255.0f);
+    }
+    if (channels < 4) {
+        lo[3] = 255.0f;
+        hi[3] = 255.0f;
+    }
+}
+
+template<int Channels>
+uint32_t distanceSq(const uint8_t* a, const uint8_t* b)
+{
+    uint32_t sum = 0;
+    for (int c = 0; c < Channels; ++c) {
+        const int d = static_cast<int>(a[c]) - static_cast<int>(b[c]);
+        sum += static_cast<uint32_t>(d * d);
+    }
+    return sum;
+}
+
+template<int Channels, int PaletteSize>
+uint8_t nearestIndex(const uint8_t* texel, const uint8_t (&palette)[PaletteSize][4])
+{
+    uint8_t best = 0;
+    uint32_t bestDistance = ~0U;
+    for (int i = 0; i < PaletteSize; ++i) {
+        const uint32_t d = distanceSq<Channels>(texel, palette[i]);
+        if (d < bestDistance) {
+            bestDistance = d;
+            best = static_cast<uint8_t>(i);
+        }
+    }
+    return best;
+}
+
+// ---- BC1 ----------------------------------------------------------------------------------
+
+uint16_t packRgb565(const float rgb[3])
+{
+    const auto r = static_cast<uint16_t>(std::lround(rgb[0] * 31.0f / 255.0f));
+    const auto g = static_cast<uint16_t>(std::lround(rgb[1] * 63.0f / 255.0f));
+    const auto b = static_cast<uint16_t>(std::lround(rgb[2] * 31.0f / 255.0f));
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+void unpackRgb565(uint16_t c, uint8_t out[4])
+{
+    const uint32_t r = (c >> 11) & 31U;
+    const uint32_t g = (c >> 5) & 63U;
+    const uint32_t b = c & 31U;
+    out[0] = static_cast<uint8_t>((r << 3) | (r >> 2));
+    out[1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+    out[2] = static_cast<uint8_t>((b << 3) | (b >> 2));
+    out[3] = 255U;
+}
+
+void bc1Palette(uint16_t c0, uint16_t c1, uint8_t (&palette)[4][4])
+{
+    unpackRgb565(c0, palette[0]);
+    unpackRgb565(c1, palette[1]);
+    for (int c = 0; c < 3; ++c) {
+        if (c0 > c1) {
+            palette[2][c] = static_cast<uint8_t>((2U * palette[0][c] + palette[1][c]) / 3U);
+            palette[3][c] = static_cast<uint8_t>((palette[0][c] + 2U * palette[1][c]) / 3U);
+        } else {
+            palette[2][c] = static_cast<uint8_t>((palette[0][c] + palette[1][c]) / 2U);
+            palette[3][c] = 0U;
+        }
+    }
+    palette[2][3] = 255U;
+    palette[3][3] = (c0 > c1) ? 255U : 0U;
+}
+
+void encodeBc1Block(const Block& block, uint8_t* out)
+{
+    float lo[4];
+    float hi[4];
+    principalEndpoints(block, 3, lo, hi);
+    uint16_t c0 = packRgb565(hi);
+    uint16_t c1 = packRgb565(lo);
+    if (c0 < c1) std::swap(c0, c1);
+
+    uint32_t indices = 0;
+    if (c0 != c1) {
+        uint8_t palette[4][4];
+        bc1Palette(c0, c1, palette);
+        for (int i = 0; i < 16; ++i) {
+            indices |= static_cast<uint32_t>(nearestIndex<3>(block[i], palette)) << (i * 2);
+        }
+    }
+
+    out[0] = static_cast<uint8_t>(c0 & 0xFFU);
+    out[1] = static_cast<uint8_t>(c0 >> 8);
+    out[2] = static_cast<uint8_t>(c1 & 0xFFU);
+    out[3] = static_cast<uint8_t>(c1 >> 8);
+    for (int i = 0; i < 4; ++i) out[4 + i] = static_cast<uint8_t>((indices >> (i * 8)) & 0xFFU);
+}
+
+void decodeBc1Block(const uint8_t* in, Block& block)
+{
+    const auto c0 = static_cast<uint16_t>(in[0] | (in[1] << 8));
+    const auto c1 = static_cast<uint16_t>(in[2] | (in[3] << 8));
+    const uint32_t indices = static_cast<uint32_t>(in[4]) | (static_cast<uint32_t>(in[5]) << 8) | (static_cast<uint32_t>(in[6]) << 16) |
+                             (static_cast<uint32_t>(in[7]) << 24);
+    uint8_t palette[4][4];
+    bc1Palette(c0, c1, palette);
+    for (int i = 0; i < 16; ++i) std::memcpy(block[i], palette[(indices >> (i * 2)) & 3U], 4);
+}
+
+// ---- BC7 mode 6 ---------------------------------------------------------------------------
+
+constexpr uint8_t kBc7Weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+struct Bc7Endpoint {
+    uint8_t rgba7[4];
+    uint8_t pbit;
+};
+
+uint8_t expandBc7Endpoint(uint8_t value7, uint8_t pbit)
+{
+    return static_cast<uint8_t>((value7 << 1) | pbit);
+}
+
+// Picks the shared p-bit that reproduces the endpoint with the least error.
+Bc7Endpoint quantizeBc7Endpoint(const float rgba[4])
+{
+    Bc7Endpoint best{};
+    float bestError = 1e30f;
+    for (uint8_t pbit = 0; pbit < 2; ++pbit) {
+        Bc7Endpoint candidate{};
+        candidate.pbit = pbit;
+        float error = 0.0f;
+        for (int c = 0; c < 4; ++c) {
+            const long q = std::lround((rgba[c] - pbit) / 2.0f);
+            candidate.rgba7[c] = static_cast<uint8_t>(std::clamp(q, 0L, 127L));
+            const float d = static_cast<float>(expandBc7Endpoint(candidate.rgba7[c], pbit)) - rgba[c];
+            error += d * d;
+        }
+        if (error < bestError) {
+            bestError = error;
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+void bc7Palette(const Bc7Endpoint& e0, const Bc7Endpoint& e1, uint8_t (&palette)[16][4])
+{
+    for (int c = 0; c < 4; ++c) {
+        const uint32_t a = expandBc7Endpoint(e0.rgba7[c], e0.pbit);
+        const uint32_t b = expandBc7Endpoint(e1.rgba7[c], e1.pbit);
+        for (int i = 0; i < 16; ++i) {
+            palette[i][c] = static_cast<uint8_t>(((64U - kBc7Weights4[i]) * a + kBc7Weights4[i] * b + 32U) >> 6);
+        }
+    }
+}
+
+class Bits128 {
+public:
+    void write(uint32_t value, int count)
+    {
+        for (int i = 0; i < count; ++i, ++position_) {
+            if ((value >> i) & 1U) bytes_[position_ / 8] |= static_cast<uint8_t>(1U << (position_ % 8));
+        }
+    }
+    uint32_t read(int count)
+    {
+        uint32_t value = 0;
+        for (int i = 0; i < count; ++i, ++position_) {
+            value |= static_cast<uint32_t>((bytes_[position_ / 8] >> (position_ % 8)) & 1U) << i;
+        }
+        return value;
+    }
+    uint8_t* bytes() { return bytes_; }
+
+private:
+    uint8_t bytes_[16] = {};
+    int position_ = 0;
+};
+
+void encodeBc7Block(const Block& block, uint8_t* out)
+{
+    float lo[4];
+    float hi[4];
+    principalEndpoints(block, 4, lo, hi);
+    Bc7Endpoint e0 = quantizeBc7Endpoint(lo);
+    Bc7Endpoint e1 = quantizeBc7Endpoint(hi);
+
+    uint8_t palette[16][4];
+    bc7Palette(e0, e1, palette);
+    uint8_t indices[16];
+    for (int i = 0; i < 16; ++i) indices[i] = nearestIndex<4>(block[i], palette);
+
+    // The anchor (texel 0) index is stored with its top bit implied zero.
+    if (indices[0] & 8U) {
+        std::swap(e0, e1);
+        for (auto& index : indices) index = static_cast<uint8_t>(15U - index);
+    }
+
+    Bits128 bits;
+    bits.write(1U << 6, 7);
+    for (int c = 0; c < 4; ++c) {
+        bits.write(e0.rgba7[c], 7);
+        bits.write(e1.rgba7[c], 7);
+    }
+    bits.write(e0.pbit, 1);
+    bits.write(e1.pbit, 1);
+    bits.write(indices[0], 3);
+    for (int i = 1; i < 16; ++i) bits.write(indices[i], 4);
+    std::memcpy(out, bits.bytes(), 16);
+}
+
+void decodeBc7Block(const uint8_t* in, Block& block)
+{
+    if ((in[0] & 0x7FU) != 0x40U) {
+        for (auto& texel : block) {
+            texel[0] = 255U;
+            texel[1] = 0U;
+            texel[2] = 255U;
+            texel[3] = 255U;
+        }
+        return;
+    }
+
+    Bits128 bits;
+    std::memcpy(bits.bytes(), in, 16);
+    (void)bits.read(7);
+    Bc7Endpoint e0{};
+    Bc7Endpoint e1{};
+    for (int c = 0; c < 4; ++c) {
+        e0.rgba7[c] = static_cast<uint8_t>(bits.read(7));
+        e1.rgba7[c] = static_cast<uint8_t>(bits.read(7));
+    }
+    e0.pbit = static_cast<uint8_t>(bits.read(1));
+    e1.pbit = static_cast<uint8_t>(bits.read(1));
+
+    uint8_t palette[16][4];
+    bc7Palette(e0, e1, palette);
+    for (int i = 0; i < 16; ++i) {
+        const uint32_t index = bits.read(i == 0 ? 3 : 4);
+        std::memcpy(block[i], palette[index], 4);
+    }
+}
+
+template<class EncodeBlock>
+void encodeBlocks(const uint8_t* rgba, uint32_t width, uint32_t height, uint8_t* dst, size_t blockBytes, EncodeBlock encodeBlock)
+{
+    if (width == 0 || height == 0) return;
+    const uint32_t blocksX = (width + 3U) / 4U;
+    const uint32_t blocksY = (height + 3U) / 4U;
+    core::parallelForBands(blocksY, kMinBlockRowsPerBand, [&](size_t begin, size_t end) {
+        Block block;
+        for (size_t by = begin; by < end; ++by) {
+            for (uint32_t bx = 0; bx < blocksX; ++bx) {
+                loadBlock(rgba, width, height, bx, static_cast<uint32_t>(by), block);
+                encodeBlock(block, dst + (by * blocksX + bx) * blockBytes);
+            }
+        }
+    });
+}
+
+template<class DecodeBlock>
+void decodeBlocks(const uint8_t* src, uint32_t width, uint32_t height, uint8_t* dstRgba, size_t blockBytes, DecodeBlock decodeBlock)
+{
+    if (width == 0 || height == 0) return;
+    const uint32_t blocksX = (width + 3U) / 4U;
+    const uint32_t blocksY = (height + 3U) / 4U;
+    core::parallelForBands(blocksY, kMinBlockRowsPerBand, [&](size_t begin, size_t end) {
+        Block block;
+        for (size_t by = begin; by < end; ++by) {
+            for (uint32_t bx = 0; bx < blocksX; ++bx) {
+                decodeBlock(src + (by * blocksX + bx) * blockBytes, block);
+                storeBlock(block, width, height, bx, static_cast<uint32_t>(by), dstRgba);
+            }
+        }
+    });
+}
+
+} // namespace
+
+void encodeBc1(const uint8_t* rgba, uint32_t width, uint32_t height, uint8_t* dst)
+{
+    encodeBlocks(rgba, width, height, dst, 8U, encodeBc1Block);
+}
+
+void encodeBc7(const uint8_t* rgba, uint32_t width, uint32_t height, uint8_t* dst)
+{
+    encodeBlocks(rgba, width, height, dst, 16U, encodeBc7Block);
+}
+
+void decodeBc1(const uint8_t* src, uint32_t width, uint32_t height, uint8_t* dstRgba)
+{
+    decodeBlocks(src, width, height, dstRgba, 8U, decodeBc1Block);
+}
+
+void decodeBc7(const uint8_t* src, uint32_t width, uint32_t height, uint8_t* dstRgba)
+{
+    decodeBlocks(src, width, height, dstRgba, 16U, decodeBc7Block);
+}
+
+} // namespace core::image
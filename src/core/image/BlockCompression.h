@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace core::image {
+
+// Bytes of a BCn-compressed level: 4x4 blocks, partial edge blocks padded by clamping.
+inline size_t bcBlockCount(uint32_t width, uint32_t height)
+{
+    return static_cast<size_t>((width + 3U) / 4U) * ((height + 3U) / 4U);
+}
+inline size_t bc1LevelSize(uint32_t width, uint32_t height) { return bcBlockCount(width, height) * 8U; }
+inline size_t bc7LevelSize(uint32_t width, uint32_t height) { return bcBlockCount(width, height) * 16U; }
+
+// BC1 (opaque, 4-colour mode): principal-axis endpoints, nearest-palette indices. Alpha is
+// ignored. dst receives bc1LevelSize(width, height) bytes. Block rows encode in parallel.
+void encodeBc1(const uint8_t* rgba, uint32_t width, uint32_t height, uint8_t* dst);
+
+// BC7 mode 6 only (one RGBA subset, 7.7.7.7+p endpoints, 4-bit indices): simple and fast, good
+// for photographic earth imagery. dst receives bc7LevelSize(width, height) bytes.
+void encodeBc7(const uint8_t* rgba, uint32_t width, uint32_t height, uint8_t* dst);
+
+// CPU decoders used when the device lacks textureCompressionBC. decodeBc7 understands the
+// mode 6 blocks written by encodeBc7; blocks in other modes decode to opaque magenta.
+void decodeBc1(const uint8_t* src, uint32_t width, uint32_t height, uint8_t* dstRgba);
+void decodeBc7(const uint8_t* src, uint32_t width, uint32_t height, uint8_t* dstRgba);
+
+} // namespace core::image
@@ -0,0 +1,315 @@
+#include "core/image/ImageFile.h"
+
+#include "core/ParallelFor.h"
+
+#if __has_include(<stb_image.h>)
+#define VKRAW_HAS_STB_IMAGE 1
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#else
+#define VKRAW_HAS_STB_IMAGE 0
+#endif
+
+#if defined(VKRAW_ENABLE_IMAGE_FILE_IO)
+#include <tiffio.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <utility>
+
+namespace core::image {
+
+namespace {
+
+enum class ImageFileKind {
+    Unknown,
+    Stb,
+    Tiff,
+};
+
+ImageFileKind classifyImageFile(const std::string& path)
+{
+    if (path.empty()) return ImageFileKind::Unknown;
+    std::string ext = std::filesystem::path(path).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (ext == ".jpg" || ext == ".jpeg" || ext == ".png") return ImageFileKind::Stb;
+#if defined(VKRAW_ENABLE_IMAGE_FILE_IO)
+    if (ext == ".tif" || ext == ".tiff") return ImageFileKind::Tiff;
+#endif
+    return ImageFileKind::Unknown;
+}
+
+bool readStbImageSize(const std::string& path, uint32_t& width, uint32_t& height)
+{
+#if !VKRAW_HAS_STB_IMAGE
+    (void)path;
+    (void)width;
+    (void)height;
+    return false;
+#else
+    int w = 0;
+    int h = 0;
+    int channels = 0;
+    if (stbi_info(path.c_str(), &w, &h, &channels) != 1 || w <= 0 || h <= 0) return false;
+    width = static_cast<uint32_t>(w);
+    height = static_cast<uint32_t>(h);
+    return true;
+#endif
+}
+
+bool decodeStbImageInto(const std::string& path, uint32_t width, uint32_t height, std::span<uint8_t> dst)
+{
+#if !VKRAW_HAS_STB_IMAGE
+    (void)path;
+    (void)width;
+    (void)height;
+    (void)dst;
+    return false;
+#else
+    int w = 0;
+    int h = 0;
+    int channels = 0;
+    stbi_uc* pixels = stbi_load(path.c_str(), &w, &h, &channels, STBI_rgb_alpha);
+    if (!pixels) return false;
+    const bool ok = static_cast<uint32_t>(w) == width && static_cast<uint32_t>(h) == height;
+    if (ok) std::memcpy(dst.data(), pixels, dst.size());
+    stbi_image_free(pixels);
+    return ok;
+#endif
+}
+
+#if defined(VKRAW_ENABLE_IMAGE_FILE_IO)
+// How a TIFF is chunked. Direct layouts (8-bit, contiguous, RGB(A)/gray(A), top-left) are read
+// with TIFFReadEncoded* and expanded to RGBA; everything else goes through libtiff's RGBA
+// strip/tile conversion, which handles palettes, YCbCr, other bit depths and so on.
+struct TiffLayout {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    bool tiled = false;
+    uint32_t chunkWidth = 0;
+    uint32_t chunkHeight = 0;
+    uint32_t chunksAcross = 0;
+    uint32_t chunkCount = 0;
+    uint16_t samplesPerPixel = 1;
+    bool gray = false;
+    bool direct = false;
+    bool topLeft = true;
+};
+
+bool readTiffLayout(TIFF* tif, TiffLayout& layout)
+{
+    if (TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &layout.width) != 1 || TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &layout.height) != 1 ||
+        layout.width == 0 || layout.height == 0) {
+        return false;
+    }
+
+    uint16_t bitsPerSample = 1;
+    uint16_t planarConfig = PLANARCONFIG_CONTIG;
+    uint16_t orientation = ORIENTATION_TOPLEFT;
+    uint16_t photometric = 0;
+    TIFFGetFieldDefaulted(tif, TIFFTAG_BITSPERSAMPLE, &bitsPerSample);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &layout.samplesPerPixel);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_PLANARCONFIG, &planarConfig);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_ORIENTATION, &orientation);
+    const bool hasPhotometric = TIFFGetField(tif, TIFFTAG_PHOTOMETRIC, &photometric) == 1;
+
+    layout.topLeft = (orientation == ORIENTATION_TOPLEFT);
+    layout.tiled = TIFFIsTiled(tif) != 0;
+    if (layout.tiled) {
+        if (TIFFGetField(tif, TIFFTAG_TILEWIDTH, &layout.chunkWidth) != 1 || TIFFGetField(tif, TIFFTAG_TILELENGTH, &layout.chunkHeight) != 1 ||
+            layout.chunkWidth == 0 || layout.chunkHeight == 0) {
+            return false;
+        }
+    } else {
+        uint32_t rowsPerStrip = layout.height;
+        TIFFGetFieldDefaulted(tif, TIFFTAG_ROWSPERSTRIP, &rowsPerStrip);
+        layout.chunkWidth = layout.width;
+        layout.chunkHeight = std::clamp(rowsPerStrip, 1U, layout.height);
+    }
+    layout.chunksAcross = (layout.width + layout.chunkWidth - 1U) / layout.chunkWidth;
+    layout.chunkCount = layout.chunksAcross * ((layout.height + layout.chunkHeight - 1U) / layout.chunkHeight);
+
+    const uint16_t spp = layout.samplesPerPixel;
+    const bool rgb = hasPhotometric && photometric == PHOTOMETRIC_RGB && (spp == 3 || spp == 4);
+    layout.gray = hasPhotometric && photometric == PHOTOMETRIC_MINISBLACK && (spp == 1 || spp == 2);
+    layout.direct = bitsPerSample == 8 && planarConfig == PLANARCONFIG_CONTIG && layout.topLeft && (rgb || layout.gray);
+    return true;
+}
+
+void expandToRgba(const uint8_t* src, uint32_t count, const TiffLayout& layout, uint8_t* dst)
+{
+    const uint16_t spp = layout.samplesPerPixel;
+    for (uint32_t i = 0; i < count; ++i, src += spp, dst += 4) {
+        if (layout.gray) {
+            dst[0] = dst[1] = dst[2] = src[0];
+            dst[3] = (spp == 2) ? src[1] : 255U;
+        } else {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            dst[3] = (spp == 4) ? src[3] : 255U;
+        }
+    }
+}
+
+void unpackAbgr(const uint32_t* src, uint32_t count, uint8_t* dst)
+{
+    for (uint32_t i = 0; i < count; ++i, dst += 4) {
+        dst[0] = static_cast<uint8_t>(TIFFGetR(src[i]));
+        dst[1] = static_cast<uint8_t>(TIFFGetG(src[i]));
+        dst[2] = static_cast<uint8_t>(TIFFGetB(src[i]));
+        dst[3] = static_cast<uint8_t>(TIFFGetA(src[i]));
+    }
+}
+
+// Decodes chunks [begin, end) through its own handle; libtiff handles are not thread-safe, but
+// independent handles on one file are.
+bool decodeTiffChunks(const std::string& path, const TiffLayout& layout, size_t begin, size_t end, uint8_t* dst)
+{
+    TIFF* tif = TIFFOpen(path.c_str(), "r");
+    if (!tif) return false;
+
+    const size_t rowBytes = static_cast<size_t>(layout.width) * 4U;
+    const size_t chunkPixels = static_cast<size_t>(layout.chunkWidth) * layout.chunkHeight;
+    std::vector<uint8_t> encoded;
+    std::vector<uint32_t> raster;
+    if (layout.direct) {
+        encoded.resize(static_cast<size_t>(layout.tiled ? TIFFTileSize(tif) : TIFFStripSize(tif)));
+    } else {
+        raster.resize(chunkPixels);
+    }
+
+    bool ok = true;
+    for (size_t chunk = begin; chunk < end && ok; ++chunk) {
+        const uint32_t x0 = static_cast<uint32_t>(chunk % layout.chunksAcross) * layout.chunkWidth;
+        const uint32_t y0 = static_cast<uint32_t>(chunk / layout.chunksAcross) * layout.chunkHeight;
+        const uint32_t columns = std::min(layout.chunkWidth, layout.width - x0);
+        const uint32_t rows = std::min(layout.chunkHeight, layout.height - y0);
+
+        if (layout.direct) {
+            const auto index = static_cast<uint32_t>(chunk);
+            const tmsize_t read = layout.tiled ? TIFFReadEncodedTile(tif, index, encoded.data(), static_cast<tmsize_t>(encoded.size()))
+                                               : TIFFReadEncodedStrip(tif, index, encoded.data(), static_cast<tmsize_t>(encoded.size()));
+            const size_t chunkRowBytes = static_cast<size_t>(layout.chunkWidth) * layout.samplesPerPixel;
+            if (read < 0 || static_cast<size_t>(read) < chunkRowBytes * (rows - 1U) + static_cast<size_t>(columns) * layout.samplesPerPixel) {
+                ok = false;
+                break;
+            }
+            for (uint32_t r = 0; r < rows; ++r) {
+                expandToRgba(encoded.data() + r * chunkRowBytes, columns, layout, dst + (y0 + r) * rowBytes + static_cast<size_t>(x0) * 4U);
+            }
+            continue;
+        }
+
+        // The RGBA readers return bottom-up rows; tiles keep their full tile height with the
+        // image rows packed at the top of the raster, strips hold exactly `rows` rows.
+        const int readOk = layout.tiled ? TIFFReadRGBATile(tif, x0, y0, raster.data()) : TIFFReadRGBAStrip(tif, y0, raster.data());
+        if (readOk != 1) {
+            ok = false;
+            break;
+        }
+        const uint32_t rasterRows = layout.tiled ? layout.chunkHeight : rows;
+        for (uint32_t r = 0; r < rows; ++r) {
+            const uint32_t* src = raster.data() + static_cast<size_t>(rasterRows - 1U - r) * layout.chunkWidth;
+            unpackAbgr(src, columns, dst + (y0 + r) * rowBytes + static_cast<size_t>(x0) * 4U);
+        }
+    }
+    TIFFClose(tif);
+    return ok;
+}
+
+bool decodeTiffInto(const std::string& path, uint32_t width, uint32_t height, std::span<uint8_t> dst)
+{
+    TIFF* tif = TIFFOpen(path.c_str(), "r");
+    if (!tif) return false;
+    TiffLayout layout{};
+    if (!readTiffLayout(tif, layout) || layout.width != width || layout.height != height) {
+        TIFFClose(tif);
+        return false;
+    }
+
+    if (!layout.topLeft) {
+        // Chunks of flipped/rotated files do not map to image rows one to one; let libtiff
+        // reorient the whole image in one go.
+        std::vector<uint32_t> rgba(static_cast<size_t>(width) * height);
+        const int ok = TIFFReadRGBAImageOriented(tif, width, height, rgba.data(), ORIENTATION_TOPLEFT, 0);
+        TIFFClose(tif);
+        if (ok != 1) return false;
+        unpackAbgr(rgba.data(), width * height, dst.data());
+        return true;
+    }
+    TIFFClose(tif);
+
+    std::atomic<bool> ok{true};
+    core::parallelForBands(layout.chunkCount, 4, [&](size_t begin, size_t end) {
+        if (!decodeTiffChunks(path, layout, begin, end, dst.data())) ok = false;
+    });
+    return ok;
+}
+
+bool readTiffSize(const std::string& path, uint32_t& width, uint32_t& height)
+{
+    TIFF* tif = TIFFOpen(path.c_str(), "r");
+    if (!tif) return false;
+    const bool ok = TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &width) == 1 && TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &height) == 1 && width > 0 &&
+                    height > 0;
+    TIFFClose(tif);
+    return ok;
+}
+#endif
+
+} // namespace
+
+bool readImageFileSize(const std::string& path, uint32_t& width, uint32_t& height)
+{
+    switch (classifyImageFile(path)) {
+        case ImageFileKind::Stb: return readStbImageSize(path, width, height);
+#if defined(VKRAW_ENABLE_IMAGE_FILE_IO)
+        case ImageFileKind::Tiff: return readTiffSize(path, width, height);
+#endif
+        default: return false;
+    }
+}
+
+bool decodeRgbaImageFileInto(const std::string& path, uint32_t width, uint32_t height, std::span<uint8_t> dst)
+{
+    if (width == 0 || height == 0 || dst.size() != static_cast<size_t>(width) * height * 4U) return false;
+    switch (classifyImageFile(path)) {
+        case ImageFileKind::Stb: return decodeStbImageInto(path, width, height, dst);
+#if defined(VKRAW_ENABLE_IMAGE_FILE_IO)
+        case ImageFileKind::Tiff: return decodeTiffInto(path, width, height, dst);
+#endif
+        default: return false;
+    }
+}
+
+bool loadRgbaImageFile(const std::string& path, RgbaImage& out)
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    if (!readImageFileSize(path, width, height)) return false;
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4U);
+    if (!decodeRgbaImageFileInto(path, width, height, pixels)) return false;
+    out.width = width;
+    out.height = height;
+    out.pixels = std::move(pixels);
+    return true;
+}
+
+std::string supportedImageFileFormats()
+{
+    std::string formats = ".jpg/.jpeg/.png";
+#if defined(VKRAW_ENABLE_IMAGE_FILE_IO)
+    formats += "/.tif/.tiff";
+#endif
+#if !VKRAW_HAS_STB_IMAGE
+    formats += "; stb_image missing in this build";
+#endif
+    return formats;
+}
+
+} // namespace core::image
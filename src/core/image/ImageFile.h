@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace core::image {
+
+// Tightly packed RGBA8 pixels, row 0 at the top.
+struct RgbaImage {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> pixels{};
+};
+
+// Decodes .jpg/.jpeg/.png (stb_image) and, when built with VKRAW_ENABLE_IMAGE_FILE_IO,
+// .tif/.tiff (libtiff) into RGBA8. Returns false for unknown extensions or decode errors.
+bool loadRgbaImageFile(const std::string& path, RgbaImage& out);
+
+// Reads the image size from the file header without decoding pixels.
+bool readImageFileSize(const std::string& path, uint32_t& width, uint32_t& height);
+
+// Decodes into caller-owned memory of exactly width * height * 4 bytes, e.g. a mapped staging
+// buffer; width/height must match readImageFileSize. TIFFs are decoded strip by strip (or tile by
+// tile) on several threads, each with its own libtiff handle, so memory beyond dst is one strip
+// per thread. stb formats still decode into a temporary buffer first.
+bool decodeRgbaImageFileInto(const std::string& path, uint32_t width, uint32_t height, std::span<uint8_t> dst);
+
+// Human-readable list of the formats loadRgbaImageFile supports in this build, for error
+// messages and --help text, e.g. ".jpg/.jpeg/.png/.tif/.tiff".
+std::string supportedImageFileFormats();
+
+} // namespace core::image
@@ -0,0 +1,347 @@
+#include "core/image/ProceduralEarthTexture.h"
+
+#include "core/ParallelFor.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VKRAW_PROCEDURAL_SSE2 1
+#else
+#define VKRAW_PROCEDURAL_SSE2 0
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <system_error>
+
+namespace core::image {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr uint32_t kCacheMagic = 0x45504B56; // "VKPE"
+// Bump whenever the generator output changes so stale cache files are ignored.
+constexpr uint32_t kGeneratorVersion = 1;
+constexpr size_t kMinRowsPerBand = 16;
+
+struct CacheHeader {
+    uint32_t magic = kCacheMagic;
+    uint32_t version = kGeneratorVersion;
+    uint32_t style = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t reserved = 0;
+    uint64_t key = 0;
+};
+static_assert(sizeof(CacheHeader) == ProceduralEarthImage::kHeaderSize, "cache header layout changed");
+
+struct Rgb {
+    float r;
+    float g;
+    float b;
+};
+
+inline void storeRgba(uint8_t* dst, uint8_t r, uint8_t g, uint8_t b)
+{
+    dst[0] = r;
+    dst[1] = g;
+    dst[2] = b;
+    dst[3] = 255U;
+}
+
+inline uint8_t unitToByte(float c)
+{
+    return static_cast<uint8_t>(std::clamp(c, 0.0f, 1.0f) * 255.0f);
+}
+
+float columnLon(uint32_t x, uint32_t width)
+{
+    const double u = static_cast<double>(x) / static_cast<double>(std::max(1U, width - 1U));
+    return static_cast<float>((u * 2.0 - 1.0) * kPi);
+}
+
+double rowLat(uint32_t y, uint32_t height)
+{
+    const double v = static_cast<double>(y) / static_cast<double>(std::max(1U, height - 1U));
+    return (0.5 - v) * kPi;
+}
+
+// Classic: two-octave sine "noise" with sand highlands and polar ice (vkraw/vkScene look).
+// noiseB = sin(8.4 lon - 2.9 lat) is expanded so only per-column and per-row terms remain.
+struct ClassicColumns {
+    std::vector<float> sinA;
+    std::vector<float> sinB;
+    std::vector<float> cosB;
+};
+
+constexpr Rgb kClassicLand{0.23f, 0.50f, 0.20f};
+constexpr Rgb kClassicSea{0.06f, 0.18f, 0.45f};
+constexpr Rgb kClassicSand{0.62f, 0.53f, 0.33f};
+constexpr Rgb kClassicIce{0.92f, 0.95f, 0.98f};
+
+ClassicColumns makeClassicColumns(uint32_t width)
+{
+    ClassicColumns cols;
+    // Padded to a multiple of four so the SIMD loop never reads past the end.
+    const size_t padded = (static_cast<size_t>(width) + 3U) & ~size_t{3};
+    cols.sinA.assign(padded, 0.0f);
+    cols.sinB.assign(padded, 0.0f);
+    cols.cosB.assign(padded, 0.0f);
+    for (uint32_t x = 0; x < width; ++x) {
+        const float lon = columnLon(x, width);
+        cols.sinA[x] = std::sin(lon * 2.7f + 0.4f);
+        cols.sinB[x] = std::sin(lon * 8.4f);
+        cols.cosB[x] = std::cos(lon * 8.4f);
+    }
+    return cols;
+}
+
+void generateClassicRow(const ClassicColumns& cols, uint32_t width, uint32_t y, uint32_t height, uint8_t* dstRow)
+{
+    const float lat = static_cast<float>(rowLat(y, height));
+    const float cosA = std::cos(lat * 3.3f - 0.1f);
+    const float cosB = std::cos(lat * 2.9f);
+    const float sinB = std::sin(lat * 2.9f);
+    const float latBias = 0.25f * std::sin(lat);
+    const float polarMix = (std::abs(lat) > static_cast<float>(70.0 * kPi / 180.0)) ? 0.85f : 0.0f;
+
+    uint32_t x = 0;
+#if VKRAW_PROCEDURAL_SSE2
+    const __m128 vWeightA = _mm_set1_ps(0.62f * cosA);
+    const __m128 vWeightB = _mm_set1_ps(0.38f);
+    const __m128 vCosB = _mm_set1_ps(cosB);
+    const __m128 vSinB = _mm_set1_ps(sinB);
+    const __m128 vLatBias = _mm_set1_ps(latBias);
+    const __m128 vLandThreshold = _mm_set1_ps(0.08f);
+    const __m128 vSandStart = _mm_set1_ps(0.10f);
+    const __m128 vSandScale = _mm_set1_ps(0.9f);
+    const __m128 vZero = _mm_setzero_ps();
+    const __m128 vOne = _mm_set1_ps(1.0f);
+    const __m128 vByte = _mm_set1_ps(255.0f);
+    const __m128 vPolarMix = _mm_set1_ps(polarMix);
+    const __m128i vAlpha = _mm_set1_epi32(static_cast<int>(0xFF000000U));
+
+    auto shade = [&](__m128 landMask, __m128 t, float land, float sea, float sand, float ice) {
+        const __m128 base = _mm_or_ps(_mm_and_ps(landMask, _mm_set1_ps(land)), _mm_andnot_ps(landMask, _mm_set1_ps(sea)));
+        __m128 c = _mm_add_ps(base, _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(sand), base), t));
+        c = _mm_add_ps(c, _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(ice), c), vPolarMix));
+        c = _mm_min_ps(_mm_max_ps(c, vZero), vOne);
+        return _mm_cvttps_epi32(_mm_mul_ps(c, vByte));
+    };
+
+    for (; x + 4 <= width; x += 4) {
+        const __m128 a = _mm_loadu_ps(cols.sinA.data() + x);
+        const __m128 sb = _mm_loadu_ps(cols.sinB.data() + x);
+        const __m128 cb = _mm_loadu_ps(cols.cosB.data() + x);
+        const __m128 noiseB = _mm_sub_ps(_mm_mul_ps(sb, vCosB), _mm_mul_ps(cb, vSinB));
+        const __m128 elevation = _mm_add_ps(_mm_mul_ps(vWeightA, a), _mm_mul_ps(vWeightB, noiseB));
+        const __m128 landMask = _mm_cmpgt_ps(_mm_add_ps(elevation, vLatBias), vLandThreshold);
+        __m128 t = _mm_mul_ps(_mm_sub_ps(elevation, vSandStart), vSandScale);
+        t = _mm_and_ps(_mm_min_ps(_mm_max_ps(t, vZero), vOne), landMask);
+
+        const __m128i r = shade(landMask, t, kClassicLand.r, kClassicSea.r, kClassicSand.r, kClassicIce.r);
+        const __m128i g = shade(landMask, t, kClassicLand.g, kClassicSea.g, kClassicSand.g, kClassicIce.g);
+        const __m128i b = shade(landMask, t, kClassicLand.b, kClassicSea.b, kClassicSand.b, kClassicIce.b);
+        const __m128i rgba = _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, 8)), _mm_or_si128(_mm_slli_epi32(b, 16), vAlpha));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dstRow + static_cast<size_t>(x) * 4U), rgba);
+    }
+#endif
+
+    for (; x < width; ++x) {
+        const float noiseB = cols.sinB[x] * cosB - cols.cosB[x] * sinB;
+        const float elevation = 0.62f * cosA * cols.sinA[x] + 0.38f * noiseB;
+        const bool land = (elevation + latBias) > 0.08f;
+        const float t = land ? std::clamp((elevation - 0.10f) * 0.9f, 0.0f, 1.0f) : 0.0f;
+        const Rgb base = land ? kClassicLand : kClassicSea;
+        Rgb c{base.r + (kClassicSand.r - base.r) * t, base.g + (kClassicSand.g - base.g) * t, base.b + (kClassicSand.b - base.b) * t};
+        c = Rgb{c.r + (kClassicIce.r - c.r) * polarMix, c.g + (kClassicIce.g - c.g) * polarMix, c.b + (kClassicIce.b - c.b) * polarMix};
+        storeRgba(dstRow + static_cast<size_t>(x) * 4U, unitToByte(c.r), unitToByte(c.g), unitToByte(c.b));
+    }
+}
+
+// Continents: banded sine continents with latitude-dependent land threshold (VSG look). Every
+// row only has two colours, so the per-pixel work reduces to one multiply and a compare.
+std::vector<float> makeContinentColumns(uint32_t width)
+{
+    std::vector<float> sin5((static_cast<size_t>(width) + 3U) & ~size_t{3}, 0.0f);
+    for (uint32_t x = 0; x < width; ++x) {
+        const double u = static_cast<double>(x) / static_cast<double>(std::max(1U, width - 1U));
+        const double lon = (u * 2.0 - 1.0) * kPi;
+        sin5[x] = static_cast<float>(std::sin(5.0 * lon));
+    }
+    return sin5;
+}
+
+void generateContinentRow(const std::vector<float>& sin5, uint32_t width, uint32_t y, uint32_t height, uint8_t* dstRow)
+{
+    const double lat = rowLat(y, height);
+    const double polar = std::pow(std::abs(std::sin(lat)), 6.0);
+    uint8_t landRgb[3] = {45, static_cast<uint8_t>(90 + 80 * (1.0 - polar)), 52};
+    uint8_t seaRgb[3] = {20, 65, static_cast<uint8_t>(130 + 70 * (1.0 - polar))};
+    if (polar > 0.82) {
+        const uint8_t ice[3] = {236, 244, 252};
+        std::memcpy(landRgb, ice, sizeof(ice));
+        std::memcpy(seaRgb, ice, sizeof(ice));
+    }
+
+    // continent = 0.5 + 0.5 * sin(5 lon) * cos(3 lat) > threshold  <=>  sin(5 lon) * cos(3 lat) > 2 * threshold - 1
+    const double threshold = (std::abs(lat) > 52.0 * kPi / 180.0) ? 0.48 : 0.62;
+    const float rowScale = static_cast<float>(std::cos(3.0 * lat));
+    const float landLimit = static_cast<float>(2.0 * threshold - 1.0);
+
+    uint32_t x = 0;
+#if VKRAW_PROCEDURAL_SSE2
+    auto packRgba = [](const uint8_t* rgb) {
+        return static_cast<int>(static_cast<uint32_t>(rgb[0]) | (static_cast<uint32_t>(rgb[1]) << 8) | (static_cast<uint32_t>(rgb[2]) << 16) |
+                                0xFF000000U);
+    };
+    const __m128i vLand = _mm_set1_epi32(packRgba(landRgb));
+    const __m128i vSea = _mm_set1_epi32(packRgba(seaRgb));
+    const __m128 vRowScale = _mm_set1_ps(rowScale);
+    const __m128 vLimit = _mm_set1_ps(landLimit);
+    for (; x + 4 <= width; x += 4) {
+        const __m128 continent = _mm_mul_ps(_mm_loadu_ps(sin5.data() + x), vRowScale);
+        const __m128i mask = _mm_castps_si128(_mm_cmpgt_ps(continent, vLimit));
+        const __m128i rgba = _mm_or_si128(_mm_and_si128(mask, vLand), _mm_andnot_si128(mask, vSea));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dstRow + static_cast<size_t>(x) * 4U), rgba);
+    }
+#endif
+
+    for (; x < width; ++x) {
+        const uint8_t* rgb = (sin5[x] * rowScale > landLimit) ? landRgb : seaRgb;
+        storeRgba(dstRow + static_cast<size_t>(x) * 4U, rgb[0], rgb[1], rgb[2]);
+    }
+}
+
+uint64_t cacheKey(const ProceduralEarthParams& params)
+{
+    const uint32_t fields[] = {kGeneratorVersion, static_cast<uint32_t>(params.style), params.width, params.height};
+    uint64_t hash = 1469598103934665603ULL;
+    for (uint32_t field : fields) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            hash ^= static_cast<uint64_t>((field >> shift) & 0xFFU);
+            hash *= 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+const char* styleName(ProceduralEarthStyle style)
+{
+    switch (style) {
+        case ProceduralEarthStyle::Classic: return "classic";
+        case ProceduralEarthStyle::Continents: return "continents";
+    }
+    return "unknown";
+}
+
+std::filesystem::path cacheFilePath(const ProceduralEarthParams& params, const std::filesystem::path& cacheDir, uint64_t key)
+{
+    char keyHex[17] = {};
+    for (int i = 0; i < 16; ++i) {
+        keyHex[i] = "0123456789abcdef"[(key >> (60 - i * 4)) & 0xFU];
+    }
+    return cacheDir / ("earth_" + std::string(styleName(params.style)) + "_" + std::to_string(params.width) + "x" +
+                       std::to_string(params.height) + "_" + keyHex + ".rgba");
+}
+
+bool cacheHeaderMatches(const core::io::MappedFile& file, const CacheHeader& expected, size_t pixelBytes)
+{
+    if (file.size() != sizeof(CacheHeader) + pixelBytes) return false;
+    CacheHeader header{};
+    std::memcpy(&header, file.data(), sizeof(header));
+    return header.magic == expected.magic && header.version == expected.version && header.style == expected.style &&
+           header.width == expected.width && header.height == expected.height && header.key == expected.key;
+}
+
+bool writeCacheFile(const std::filesystem::path& path, const CacheHeader& header, const std::vector<uint8_t>& pixels)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    if (ec) return false;
+
+    // Write beside the final name and rename so a concurrent launch never maps a partial file.
+    std::filesystem::path tmpPath = path;
+    tmpPath += ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(pixels.data()), static_cast<std::streamsize>(pixels.size()));
+        if (!out) {
+            out.close();
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+    }
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+void generateProceduralEarth(const ProceduralEarthParams& params, uint8_t* dstRgba)
+{
+    const uint32_t width = params.width;
+    const uint32_t height = params.height;
+    if (width == 0 || height == 0 || !dstRgba) return;
+    const size_t rowBytes = static_cast<size_t>(width) * 4U;
+
+    if (params.style == ProceduralEarthStyle::Continents) {
+        const std::vector<float> sin5 = makeContinentColumns(width);
+        core::parallelForBands(height, kMinRowsPerBand, [&](size_t begin, size_t end) {
+            for (size_t y = begin; y < end; ++y) {
+                generateContinentRow(sin5, width, static_cast<uint32_t>(y), height, dstRgba + y * rowBytes);
+            }
+        });
+        return;
+    }
+
+    const ClassicColumns cols = makeClassicColumns(width);
+    core::parallelForBands(height, kMinRowsPerBand, [&](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; ++y) {
+            generateClassicRow(cols, width, static_cast<uint32_t>(y), height, dstRgba + y * rowBytes);
+        }
+    });
+}
+
+ProceduralEarthImage loadOrGenerateProceduralEarth(const ProceduralEarthParams& params, const std::filesystem::path& cacheDir)
+{
+    ProceduralEarthImage image;
+    image.width_ = std::max(1U, params.width);
+    image.height_ = std::max(1U, params.height);
+    ProceduralEarthParams effective = params;
+    effective.width = image.width_;
+    effective.height = image.height_;
+
+    CacheHeader header{};
+    header.style = static_cast<uint32_t>(effective.style);
+    header.width = effective.width;
+    header.height = effective.height;
+    header.key = cacheKey(effective);
+
+    std::filesystem::path cachePath;
+    if (!cacheDir.empty()) {
+        cachePath = cacheFilePath(effective, cacheDir, header.key);
+        if (image.mapped_.open(cachePath)) {
+            if (cacheHeaderMatches(image.mapped_, header, image.size())) return image;
+            image.mapped_.close();
+        }
+    }
+
+    image.owned_.resize(image.size());
+    generateProceduralEarth(effective, image.owned_.data());
+    if (!cachePath.empty() && !writeCacheFile(cachePath, header, image.owned_)) {
+        std::cerr << "warning: could not write procedural texture cache '" << cachePath.string() << "'\n";
+    }
+    return image;
+}
+
+} // namespace core::image
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "core/io/MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace core::image {
+
+// Look of the generated fallback earth. Classic is the vkraw/vkScene texture, Continents is the
+// VSG (vkvsg/vkglobe) texture.
+enum class ProceduralEarthStyle : uint32_t {
+    Classic = 1,
+    Continents = 2,
+};
+
+struct ProceduralEarthParams {
+    ProceduralEarthStyle style = ProceduralEarthStyle::Classic;
+    uint32_t width = 1024;
+    uint32_t height = 512;
+};
+
+// RGBA8 pixels of a generated earth, either owned in memory or mapped from the disk cache.
+// Row 0 is the north pole (top-left origin).
+class ProceduralEarthImage {
+public:
+    uint32_t width() const { return width_; }
+    uint32_t height() const { return height_; }
+    bool fromCache() const { return mapped_.isOpen(); }
+    const uint8_t* data() const { return fromCache() ? mapped_.data() + kHeaderSize : owned_.data(); }
+    size_t size() const { return static_cast<size_t>(width_) * height_ * 4U; }
+    std::span<const uint8_t> bytes() const { return {data(), size()}; }
+
+    static constexpr size_t kHeaderSize = 32;
+
+private:
+    friend ProceduralEarthImage loadOrGenerateProceduralEarth(const ProceduralEarthParams& params, const std::filesystem::path& cacheDir);
+
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    std::vector<uint8_t> owned_{};
+    core::io::MappedFile mapped_{};
+};
+
+// Fills dstRgba (width * height * 4 bytes) in parallel row bands. Per-column trig terms are
+// computed once, so the per-pixel work is a handful of SIMD multiplies and selects.
+void generateProceduralEarth(const ProceduralEarthParams& params, uint8_t* dstRgba);
+
+// Cache directory every visualizer passes to loadOrGenerateProceduralEarth(); relative to the
+// working directory, like the OSM tile cache.
+inline constexpr const char* kProceduralCacheDir = "cache/procedural";
+
+// Maps the cached pixels for params from cacheDir when a valid cache file exists; otherwise
+// generates them and writes the cache for the next launch. An empty cacheDir disables caching.
+// Cache write failures are not fatal: the generated pixels are returned from memory.
+ProceduralEarthImage loadOrGenerateProceduralEarth(const ProceduralEarthParams& params, const std::filesystem::path& cacheDir);
+
+} // namespace core::image
@@ -0,0 +1,291 @@
+#include "core/image/Resample.h"
+
+#include "core/ParallelFor.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VKRAW_RESAMPLE_SSE2 1
+#else
+#define VKRAW_RESAMPLE_SSE2 0
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace core::image {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr size_t kSrgbEncodeTableSize = 16384;
+
+double filterSupport(ResampleFilter filter)
+{
+    switch (filter) {
+        case ResampleFilter::Box: return 0.5;
+        case ResampleFilter::Triangle: return 1.0;
+        case ResampleFilter::Lanczos3: return 3.0;
+    }
+    return 0.5;
+}
+
+double filterWeight(ResampleFilter filter, double x)
+{
+    switch (filter) {
+        case ResampleFilter::Box: return (x >= -0.5 && x < 0.5) ? 1.0 : 0.0;
+        case ResampleFilter::Triangle: return std::max(0.0, 1.0 - std::abs(x));
+        case ResampleFilter::Lanczos3: {
+            const double ax = std::abs(x);
+            if (ax < 1e-8) return 1.0;
+            if (ax >= 3.0) return 0.0;
+            const double px = kPi * x;
+            return 3.0 * std::sin(px) * std::sin(px / 3.0) / (px * px);
+        }
+    }
+    return 0.0;
+}
+
+// Every output sample reads exactly `taps` source samples starting at first[i]; weights outside
+// the filter support are zero. The fixed width keeps the inner loops branch-free.
+struct Kernel {
+    uint32_t taps = 0;
+    std::vector<uint32_t> first{};
+    std::vector<float> weights{};
+};
+
+Kernel buildKernel(uint32_t srcSize, uint32_t dstSize, ResampleFilter filter)
+{
+    const double scale = static_cast<double>(srcSize) / dstSize;
+    const double filterScale = std::max(1.0, scale);
+    const double support = filterSupport(filter) * filterScale;
+
+    Kernel kernel{};
+    kernel.taps = std::min(srcSize, static_cast<uint32_t>(std::ceil(2.0 * support)) + 1U);
+    kernel.first.resize(dstSize);
+    kernel.weights.assign(static_cast<size_t>(dstSize) * kernel.taps, 0.0f);
+
+    std::vector<double> weights(kernel.taps);
+    for (uint32_t i = 0; i < dstSize; ++i) {
+        const double center = (i + 0.5) * scale;
+        const auto begin = static_cast<uint32_t>(std::clamp(std::floor(center - support), 0.0, static_cast<double>(srcSize - 1U)));
+        const uint32_t first = std::min(begin, srcSize - kernel.taps);
+        kernel.first[i] = first;
+
+        double sum = 0.0;
+        for (uint32_t k = 0; k < kernel.taps; ++k) {
+            weights[k] = filterWeight(filter, (first + k + 0.5 - center) / filterScale);
+            sum += weights[k];
+        }
+        float* out = &kernel.weights[static_cast<size_t>(i) * kernel.taps];
+        if (sum <= 1e-8) {
+            // Degenerate footprint (tiny box at an edge): fall back to the nearest sample.
+            const auto nearest = static_cast<uint32_t>(std::clamp(center, 0.0, static_cast<double>(srcSize - 1U)));
+            out[std::min(nearest - first, kernel.taps - 1U)] = 1.0f;
+            continue;
+        }
+        for (uint32_t k = 0; k < kernel.taps; ++k) {
+            out[k] = static_cast<float>(weights[k] / sum);
+        }
+    }
+    return kernel;
+}
+
+const std::array<float, 256>& srgbDecodeTable()
+{
+    static const std::array<float, 256> table = [] {
+        std::array<float, 256> values{};
+        for (size_t i = 0; i < values.size(); ++i) {
+            const double c = static_cast<double>(i) / 255.0;
+            values[i] = static_cast<float>(c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4));
+        }
+        return values;
+    }();
+    return table;
+}
+
+const std::array<float, 256>& linearDecodeTable()
+{
+    static const std::array<float, 256> table = [] {
+        std::array<float, 256> values{};
+        for (size_t i = 0; i < values.size(); ++i) values[i] = static_cast<float>(i) / 255.0f;
+        return values;
+    }();
+    return table;
+}
+
+// Indexed by linear value * (size - 1); fine enough that the dark end stays within a fraction of
+// an 8-bit step.
+const std::vector<uint8_t>& srgbEncodeTable()
+{
+    static const std::vector<uint8_t> table = [] {
+        std::vector<uint8_t> values(kSrgbEncodeTableSize);
+        for (size_t i = 0; i < values.size(); ++i) {
+            const double l = static_cast<double>(i) / static_cast<double>(kSrgbEncodeTableSize - 1U);
+            const double c = l <= 0.0031308 ? l * 12.92 : 1.055 * std::pow(l, 1.0 / 2.4) - 0.055;
+            values[i] = static_cast<uint8_t>(std::clamp(c * 255.0 + 0.5, 0.0, 255.0));
+        }
+        return values;
+    }();
+    return table;
+}
+
+uint8_t encodeLinear(float value)
+{
+    return static_cast<uint8_t>(std::clamp(value * 255.0f + 0.5f, 0.0f, 255.0f));
+}
+
+void decodeRow(const uint8_t* src, uint32_t width, const std::array<float, 256>& rgbTable, float* out)
+{
+    const std::array<float, 256>& alphaTable = linearDecodeTable();
+    for (uint32_t x = 0; x < width; ++x) {
+        out[x * 4U + 0U] = rgbTable[src[x * 4U + 0U]];
+        out[x * 4U + 1U] = rgbTable[src[x * 4U + 1U]];
+        out[x * 4U + 2U] = rgbTable[src[x * 4U + 2U]];
+        out[x * 4U + 3U] = alphaTable[src[x * 4U + 3U]];
+    }
+}
+
+void filterRowHorizontal(const float* src, const Kernel& kernel, uint32_t dstWidth, float* out)
+{
+    for (uint32_t x = 0; x < dstWidth; ++x) {
+        const float* weights = &kernel.weights[static_cast<size_t>(x) * kernel.taps];
+        const float* pixel = src + static_cast<size_t>(kernel.first[x]) * 4U;
+#if VKRAW_RESAMPLE_SSE2
+        __m128 acc = _mm_setzero_ps();
+        for (uint32_t k = 0; k < kernel.taps; ++k) {
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(pixel + k * 4U), _mm_set1_ps(weights[k])));
+        }
+        _mm_storeu_ps(out + x * 4U, acc);
+#else
+        float acc[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        for (uint32_t k = 0; k < kernel.taps; ++k) {
+            for (int c = 0; c < 4; ++c) acc[c] += pixel[k * 4U + c] * weights[k];
+        }
+        for (int c = 0; c < 4; ++c) out[x * 4U + c] = acc[c];
+#endif
+    }
+}
+
+void accumulateRow(const float* row, float weight, size_t count, float* acc)
+{
+    size_t i = 0;
+#if VKRAW_RESAMPLE_SSE2
+    const __m128 w = _mm_set1_ps(weight);
+    for (; i + 4U <= count; i += 4U) {
+        _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), _mm_mul_ps(_mm_loadu_ps(row + i), w)));
+    }
+#endif
+    for (; i < count; ++i) acc[i] += row[i] * weight;
+}
+
+} // namespace
+
+const char* resampleFilterName(ResampleFilter filter)
+{
+    switch (filter) {
+        case ResampleFilter::Box: return "box";
+        case ResampleFilter::Triangle: return "triangle";
+        case ResampleFilter::Lanczos3: return "lanczos3";
+    }
+    return "unknown";
+}
+
+RgbaImage downsampleBox2x(const RgbaImage& src)
+{
+    RgbaImage dst{};
+    dst.width = std::max(1U, src.width / 2U);
+    dst.height = std::max(1U, src.height / 2U);
+    dst.pixels.resize(static_cast<size_t>(dst.width) * dst.height * 4U);
+    core::parallelForBands(dst.height, 32, [&](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; ++y) {
+            const size_t y0 = std::min<size_t>(y * 2U, src.height - 1U);
+            const size_t y1 = std::min<size_t>(y * 2U + 1U, src.height - 1U);
+            for (size_t x = 0; x < dst.width; ++x) {
+                const size_t x0 = std::min<size_t>(x * 2U, src.width - 1U);
+                const size_t x1 = std::min<size_t>(x * 2U + 1U, src.width - 1U);
+                const uint8_t* p00 = &src.pixels[(y0 * src.width + x0) * 4U];
+                const uint8_t* p01 = &src.pixels[(y0 * src.width + x1) * 4U];
+                const uint8_t* p10 = &src.pixels[(y1 * src.width + x0) * 4U];
+                const uint8_t* p11 = &src.pixels[(y1 * src.width + x1) * 4U];
+                uint8_t* out = &dst.pixels[(y * dst.width + x) * 4U];
+                for (int c = 0; c < 4; ++c) {
+                    out[c] = static_cast<uint8_t>((p00[c] + p01[c] + p10[c] + p11[c] + 2U) / 4U);
+                }
+            }
+        }
+    });
+    return dst;
+}
+
+RgbaImage resampleRgba(const RgbaImage& src, uint32_t dstWidth, uint32_t dstHeight, ResampleFilter filter, ResampleColorSpace colorSpace)
+{
+    RgbaImage dst{};
+    if (src.width == 0 || src.height == 0) return dst;
+    dst.width = std::max(1U, dstWidth);
+    dst.height = std::max(1U, dstHeight);
+    dst.pixels.resize(static_cast<size_t>(dst.width) * dst.height * 4U);
+
+    const Kernel kx = buildKernel(src.width, dst.width, filter);
+    const Kernel ky = buildKernel(src.height, dst.height, filter);
+    const bool srgb = (colorSpace == ResampleColorSpace::Srgb);
+    const std::array<float, 256>& rgbDecode = srgb ? srgbDecodeTable() : linearDecodeTable();
+    const std::vector<uint8_t>& rgbEncode = srgbEncodeTable();
+    const size_t rowFloats = static_cast<size_t>(dst.width) * 4U;
+    constexpr uint32_t kEmptySlot = 0xFFFFFFFFU;
+
+    core::parallelForBands(dst.height, 8, [&](size_t begin, size_t end) {
+        // Output rows in a band read monotonically advancing source windows of ky.taps rows, so a
+        // ring of that many horizontally filtered rows means each source row is filtered once.
+        std::vector<float> decoded(static_cast<size_t>(src.width) * 4U);
+        std::vector<float> ring(rowFloats * ky.taps);
+        std::vector<uint32_t> ringRow(ky.taps, kEmptySlot);
+        std::vector<float> acc(rowFloats);
+
+        for (size_t y = begin; y < end; ++y) {
+            std::fill(acc.begin(), acc.end(), 0.0f);
+            const float* weights = &ky.weights[y * ky.taps];
+            for (uint32_t k = 0; k < ky.taps; ++k) {
+                const uint32_t srcRow = ky.first[y] + k;
+                const uint32_t slot = srcRow % ky.taps;
+                float* filtered = &ring[slot * rowFloats];
+                if (ringRow[slot] != srcRow) {
+                    decodeRow(&src.pixels[static_cast<size_t>(srcRow) * src.width * 4U], src.width, rgbDecode, decoded.data());
+                    filterRowHorizontal(decoded.data(), kx, dst.width, filtered);
+                    ringRow[slot] = srcRow;
+                }
+                if (weights[k] != 0.0f) accumulateRow(filtered, weights[k], rowFloats, acc.data());
+            }
+
+            uint8_t* out = &dst.pixels[y * rowFloats];
+            for (size_t i = 0; i < rowFloats; i += 4U) {
+                for (size_t c = 0; c < 3U; ++c) {
+                    if (srgb) {
+                        const float l = std::clamp(acc[i + c], 0.0f, 1.0f);
+                        out[i + c] = rgbEncode[static_cast<size_t>(l * static_cast<float>(kSrgbEncodeTableSize - 1U) + 0.5f)];
+                    } else {
+                        out[i + c] = encodeLinear(acc[i + c]);
+                    }
+                }
+                out[i + 3U] = encodeLinear(acc[i + 3U]);
+            }
+        }
+    });
+    return dst;
+}
+
+std::vector<RgbaImage> buildMipChain(const RgbaImage& base, ResampleFilter filter, ResampleColorSpace colorSpace)
+{
+    std::vector<RgbaImage> chain;
+    uint32_t levels = 0;
+    for (uint32_t size = std::max(base.width, base.height); size > 1U; size /= 2U) ++levels;
+    chain.reserve(levels);
+    const RgbaImage* previous = &base;
+    while (previous->width > 1U || previous->height > 1U) {
+        chain.push_back(resampleRgba(*previous, std::max(1U, previous->width / 2U), std::max(1U, previous->height / 2U), filter, colorSpace));
+        previous = &chain.back();
+    }
+    return chain;
+}
+
+} // namespace core::image
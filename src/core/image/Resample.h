@@ -0,0 +1,39 @@
+#pragma once
+
+#include "core/image/ImageFile.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace core::image {
+
+enum class ResampleFilter {
+    Box,      // support 0.5: plain area average
+    Triangle, // support 1: bilinear tent
+    Lanczos3, // support 3: sharpest, may ring slightly on hard edges
+};
+
+// Srgb decodes RGB to linear light before filtering and re-encodes afterwards, so averages keep
+// their perceived brightness. Alpha is always filtered as stored.
+enum class ResampleColorSpace {
+    Linear,
+    Srgb,
+};
+
+const char* resampleFilterName(ResampleFilter filter);
+
+// Halves both dimensions (floor, minimum 1) with a 2x2 box filter, clamping at odd edges.
+// Rows are filtered in parallel. This is the mip reduction used by cooked textures and
+// virtual texture pyramids.
+RgbaImage downsampleBox2x(const RgbaImage& src);
+
+// Separable resample to any size. Kernels widen with the reduction factor, so large reductions
+// average every source texel instead of skipping them. Output rows are processed in parallel
+// bands; each band filters the source rows it needs horizontally once, into a small ring.
+RgbaImage resampleRgba(const RgbaImage& src, uint32_t dstWidth, uint32_t dstHeight, ResampleFilter filter, ResampleColorSpace colorSpace);
+
+// Mip levels 1..N below base down to 1x1, each resampled from the previous one (floor halving,
+// like Vulkan). Used when the device cannot blit-generate mips for a format.
+std::vector<RgbaImage> buildMipChain(const RgbaImage& base, ResampleFilter filter, ResampleColorSpace colorSpace);
+
+} // namespace core::image
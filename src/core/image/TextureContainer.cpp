@@ -0,0 +1,218 @@
+#include "core/image/TextureContainer.h"
+
+#include "core/image/BlockCompression.h"
+#include "core/image/Resample.h"
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+namespace core::image {
+
+namespace {
+
+constexpr uint32_t kContainerMagic = 0x58544B56; // "VKTX"
+constexpr uint32_t kContainerVersion = 1;
+constexpr uint64_t kLevelAlignment = 16;
+constexpr uint32_t kMaxLevels = 32;
+
+struct ContainerHeader {
+    uint32_t magic = kContainerMagic;
+    uint32_t version = kContainerVersion;
+    uint32_t codec = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t levelCount = 0;
+    uint32_t reserved[2] = {};
+};
+static_assert(sizeof(ContainerHeader) == 32, "container header layout changed");
+
+struct LevelRecord {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint64_t offset = 0;
+    uint64_t size = 0;
+};
+static_assert(sizeof(LevelRecord) == 24, "container level record layout changed");
+
+uint64_t alignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1U) & ~(alignment - 1U);
+}
+
+void encodeLevel(TextureCodec codec, const RgbaImage& image, uint8_t* dst)
+{
+    switch (codec) {
+        case TextureCodec::Rgba8: std::memcpy(dst, image.pixels.data(), image.pixels.size()); break;
+        case TextureCodec::Bc1: encodeBc1(image.pixels.data(), image.width, image.height, dst); break;
+        case TextureCodec::Bc7: encodeBc7(image.pixels.data(), image.width, image.height, dst); break;
+    }
+}
+
+} // namespace
+
+const char* textureCodecName(TextureCodec codec)
+{
+    switch (codec) {
+        case TextureCodec::Rgba8: return "rgba8";
+        case TextureCodec::Bc1: return "bc1";
+        case TextureCodec::Bc7: return "bc7";
+    }
+    return "unknown";
+}
+
+bool parseTextureCodec(const std::string& name, TextureCodec& out)
+{
+    for (TextureCodec codec : {TextureCodec::Rgba8, TextureCodec::Bc1, TextureCodec::Bc7}) {
+        if (name == textureCodecName(codec)) {
+            out = codec;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t textureLevelSize(TextureCodec codec, uint32_t width, uint32_t height)
+{
+    switch (codec) {
+        case TextureCodec::Rgba8: return static_cast<size_t>(width) * height * 4U;
+        case TextureCodec::Bc1: return bc1LevelSize(width, height);
+        case TextureCodec::Bc7: return bc7LevelSize(width, height);
+    }
+    return 0;
+}
+
+CookedTexture cookTexture(const RgbaImage& source, TextureCodec codec, bool generateMips)
+{
+    CookedTexture cooked{};
+    cooked.codec = codec;
+    if (source.width == 0 || source.height == 0) return cooked;
+
+    // Plan the layout first so every level encodes straight into its final slot.
+    std::vector<RgbaImage> chain;
+    chain.push_back(source);
+    while (generateMips && (chain.back().width > 1U || chain.back().height > 1U)) {
+        chain.push_back(downsampleBox2x(chain.back()));
+    }
+
+    uint64_t offset = 0;
+    for (const RgbaImage& image : chain) {
+        TextureLevel level{};
+        level.width = image.width;
+        level.height = image.height;
+        level.offset = offset;
+        level.size = textureLevelSize(codec, image.width, image.height);
+        offset = alignUp(offset + level.size, kLevelAlignment);
+        cooked.levels.push_back(level);
+    }
+    cooked.data.resize(static_cast<size_t>(offset));
+    for (size_t i = 0; i < chain.size(); ++i) {
+        encodeLevel(codec, chain[i], cooked.data.data() + cooked.levels[i].offset);
+    }
+    return cooked;
+}
+
+bool writeTextureContainer(const std::filesystem::path& path, const CookedTexture& texture)
+{
+    if (texture.levels.empty() || texture.levels.size() > kMaxLevels) return false;
+
+    ContainerHeader header{};
+    header.codec = static_cast<uint32_t>(texture.codec);
+    header.width = texture.levels.front().width;
+    header.height = texture.levels.front().height;
+    header.levelCount = static_cast<uint32_t>(texture.levels.size());
+
+    const uint64_t dataStart = alignUp(sizeof(ContainerHeader) + sizeof(LevelRecord) * texture.levels.size(), kLevelAlignment);
+    std::vector<LevelRecord> records;
+    records.reserve(texture.levels.size());
+    for (const TextureLevel& level : texture.levels) {
+        records.push_back(LevelRecord{level.width, level.height, dataStart + level.offset, level.size});
+    }
+
+    std::error_code ec;
+    if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path(), ec);
+    std::filesystem::path tmpPath = path;
+    tmpPath += ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(LevelRecord)));
+        const std::vector<char> padding(static_cast<size_t>(dataStart - sizeof(header) - records.size() * sizeof(LevelRecord)), 0);
+        out.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+        out.write(reinterpret_cast<const char*>(texture.data.data()), static_cast<std::streamsize>(texture.data.size()));
+        if (!out) {
+            out.close();
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+    }
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+bool isTextureContainerPath(const std::string& path)
+{
+    std::string ext = std::filesystem::path(path).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext == ".vktx";
+}
+
+bool TextureContainer::open(const std::filesystem::path& path)
+{
+    close();
+    if (!file_.open(path) || file_.size() < sizeof(ContainerHeader)) {
+        close();
+        return false;
+    }
+
+    ContainerHeader header{};
+    std::memcpy(&header, file_.data(), sizeof(header));
+    const bool knownCodec = header.codec <= static_cast<uint32_t>(TextureCodec::Bc7);
+    // Level i must be the base halved i times (rounded down, at least 1), and the chain cannot go
+    // past 1x1: Vulkan takes the records as the image's mip levels as they are.
+    const uint32_t fullChainLevels = static_cast<uint32_t>(std::bit_width(std::max(header.width, header.height)));
+    if (header.magic != kContainerMagic || header.version != kContainerVersion || !knownCodec || header.levelCount == 0 ||
+        header.levelCount > kMaxLevels || header.levelCount > fullChainLevels ||
+        file_.size() < sizeof(header) + sizeof(LevelRecord) * header.levelCount) {
+        close();
+        return false;
+    }
+    codec_ = static_cast<TextureCodec>(header.codec);
+
+    levels_.resize(header.levelCount);
+    for (uint32_t i = 0; i < header.levelCount; ++i) {
+        LevelRecord record{};
+        std::memcpy(&record, file_.data() + sizeof(header) + sizeof(LevelRecord) * i, sizeof(record));
+        const bool inBounds = record.offset <= file_.size() && record.size <= file_.size() - record.offset;
+        const bool chained = record.width == std::max(1U, header.width >> i) && record.height == std::max(1U, header.height >> i);
+        if (!inBounds || !chained || record.size != textureLevelSize(codec_, record.width, record.height)) {
+            close();
+            return false;
+        }
+        levels_[i] = TextureLevel{record.width, record.height, record.offset, record.size};
+    }
+    return true;
+}
+
+void TextureContainer::close()
+{
+    file_.close();
+    levels_.clear();
+    codec_ = TextureCodec::Rgba8;
+}
+
+std::span<const uint8_t> TextureContainer::levelData(uint32_t index) const
+{
+    const TextureLevel& entry = levels_[index];
+    return file_.bytes().subspan(static_cast<size_t>(entry.offset), static_cast<size_t>(entry.size));
+}
+
+} // namespace core::image
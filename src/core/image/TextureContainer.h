@@ -0,0 +1,73 @@
+#pragma once
+
+#include "core/image/ImageFile.h"
+#include "core/io/MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace core::image {
+
+// Pixel encoding of every level in a cooked texture.
+enum class TextureCodec : uint32_t {
+    Rgba8 = 0,
+    Bc1 = 1,
+    Bc7 = 2,
+};
+
+const char* textureCodecName(TextureCodec codec);
+bool parseTextureCodec(const std::string& name, TextureCodec& out);
+size_t textureLevelSize(TextureCodec codec, uint32_t width, uint32_t height);
+
+struct TextureLevel {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint64_t offset = 0; // from the start of the file
+    uint64_t size = 0;
+};
+
+// In-memory result of cooking, ready for writeTextureContainer().
+struct CookedTexture {
+    TextureCodec codec = TextureCodec::Rgba8;
+    std::vector<TextureLevel> levels{}; // offsets relative to the start of data
+    std::vector<uint8_t> data{};
+};
+
+// Builds the mip chain (2x2 box filter down to 1x1) and encodes every level with codec.
+CookedTexture cookTexture(const RgbaImage& source, TextureCodec codec, bool generateMips);
+
+// Writes a .vktx container:
+//   header (32 bytes): "VKTX", version, codec, width, height, levelCount, reserved[2]
+//   level table: levelCount x {width, height, offset u64, size u64}
+//   level payloads, each 16-byte aligned, largest level first.
+bool writeTextureContainer(const std::filesystem::path& path, const CookedTexture& texture);
+
+bool isTextureContainerPath(const std::string& path);
+
+// Read-only view of a mapped .vktx file. Level spans point into the mapping, so they can be
+// copied straight into a staging buffer and stay valid until the container is closed.
+class TextureContainer {
+public:
+    // Maps and validates path; on failure returns false and leaves the container closed.
+    bool open(const std::filesystem::path& path);
+    void close();
+
+    bool isOpen() const { return file_.isOpen(); }
+    TextureCodec codec() const { return codec_; }
+    uint32_t width() const { return levels_.empty() ? 0U : levels_.front().width; }
+    uint32_t height() const { return levels_.empty() ? 0U : levels_.front().height; }
+    uint32_t levelCount() const { return static_cast<uint32_t>(levels_.size()); }
+    const TextureLevel& level(uint32_t index) const { return levels_[index]; }
+    std::span<const uint8_t> levelData(uint32_t index) const;
+
+private:
+    core::io::MappedFile file_{};
+    TextureCodec codec_ = TextureCodec::Rgba8;
+    std::vector<TextureLevel> levels_{};
+};
+
+} // namespace core::image
@@ -0,0 +1,187 @@
+#include "core/image/TilePyramid.h"
+
+#include "core/image/Resample.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+namespace core::image {
+
+namespace {
+
+constexpr uint32_t kPyramidMagic = 0x50544B56; // "VKTP"
+constexpr uint32_t kPyramidVersion = 1;
+// Page data starts on a 4 KiB boundary so each page maps cleanly.
+constexpr uint64_t kDataAlignment = 4096;
+
+struct PyramidHeader {
+    uint32_t magic = kPyramidMagic;
+    uint32_t version = kPyramidVersion;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t tileSize = 0;
+    uint32_t border = 0;
+    uint32_t levelCount = 0;
+    uint32_t pageCount = 0;
+};
+static_assert(sizeof(PyramidHeader) == 32, "pyramid header layout changed");
+static_assert(sizeof(TilePyramidLevel) == 20, "pyramid level record layout changed");
+
+uint64_t dataOffsetFor(uint32_t levelCount)
+{
+    const uint64_t tableEnd = sizeof(PyramidHeader) + sizeof(TilePyramidLevel) * static_cast<uint64_t>(levelCount);
+    return (tableEnd + kDataAlignment - 1U) & ~(kDataAlignment - 1U);
+}
+
+std::vector<TilePyramidLevel> planLevels(uint32_t width, uint32_t height, uint32_t tileSize)
+{
+    std::vector<TilePyramidLevel> levels;
+    uint32_t firstPage = 0;
+    while (true) {
+        TilePyramidLevel level{};
+        level.width = width;
+        level.height = height;
+        level.tilesX = (width + tileSize - 1U) / tileSize;
+        level.tilesY = (height + tileSize - 1U) / tileSize;
+        level.firstPage = firstPage;
+        firstPage += level.tilesX * level.tilesY;
+        levels.push_back(level);
+        if ((level.tilesX == 1U && level.tilesY == 1U) || levels.size() == TilePyramid::kMaxLevels) break;
+        width = std::max(1U, width / 2U);
+        height = std::max(1U, height / 2U);
+    }
+    return levels;
+}
+
+void extractPage(const RgbaImage& image, uint32_t tileX, uint32_t tileY, uint32_t tileSize, uint32_t border, uint8_t* dst)
+{
+    const uint32_t pagePixels = tileSize + 2U * border;
+    const int64_t originX = static_cast<int64_t>(tileX) * tileSize - border;
+    const int64_t originY = static_cast<int64_t>(tileY) * tileSize - border;
+    for (uint32_t y = 0; y < pagePixels; ++y) {
+        const auto sy = static_cast<size_t>(std::clamp<int64_t>(originY + y, 0, image.height - 1));
+        for (uint32_t x = 0; x < pagePixels; ++x) {
+            const auto sx = static_cast<size_t>(std::clamp<int64_t>(originX + x, 0, image.width - 1));
+            std::memcpy(dst + (static_cast<size_t>(y) * pagePixels + x) * 4U, &image.pixels[(sy * image.width + sx) * 4U], 4);
+        }
+    }
+}
+
+} // namespace
+
+bool writeTilePyramid(const std::filesystem::path& path, const RgbaImage& source, uint32_t tileSize, uint32_t border)
+{
+    if (source.width == 0 || source.height == 0 || tileSize == 0) return false;
+
+    const std::vector<TilePyramidLevel> levels = planLevels(source.width, source.height, tileSize);
+    PyramidHeader header{};
+    header.width = source.width;
+    header.height = source.height;
+    header.tileSize = tileSize;
+    header.border = border;
+    header.levelCount = static_cast<uint32_t>(levels.size());
+    header.pageCount = levels.back().firstPage + levels.back().tilesX * levels.back().tilesY;
+
+    std::error_code ec;
+    if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path(), ec);
+    std::filesystem::path tmpPath = path;
+    tmpPath += ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(levels.data()), static_cast<std::streamsize>(levels.size() * sizeof(TilePyramidLevel)));
+        const uint64_t tableEnd = sizeof(header) + levels.size() * sizeof(TilePyramidLevel);
+        const std::vector<char> padding(static_cast<size_t>(dataOffsetFor(header.levelCount) - tableEnd), 0);
+        out.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+
+        // Only the current level is kept in memory; each level is derived from the previous one.
+        const uint32_t pagePixels = tileSize + 2U * border;
+        std::vector<uint8_t> page(static_cast<size_t>(pagePixels) * pagePixels * 4U);
+        RgbaImage current = source;
+        for (size_t levelIndex = 0; levelIndex < levels.size() && out; ++levelIndex) {
+            if (levelIndex > 0) current = downsampleBox2x(current);
+            const TilePyramidLevel& level = levels[levelIndex];
+            for (uint32_t ty = 0; ty < level.tilesY; ++ty) {
+                for (uint32_t tx = 0; tx < level.tilesX; ++tx) {
+                    extractPage(current, tx, ty, tileSize, border, page.data());
+                    out.write(reinterpret_cast<const char*>(page.data()), static_cast<std::streamsize>(page.size()));
+                }
+            }
+        }
+        if (!out) {
+            out.close();
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+    }
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+bool isTilePyramidPath(const std::string& path)
+{
+    std::string ext = std::filesystem::path(path).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext == ".vktp";
+}
+
+bool TilePyramid::open(const std::filesystem::path& path)
+{
+    close();
+    if (!file_.open(path) || file_.size() < sizeof(PyramidHeader)) {
+        close();
+        return false;
+    }
+
+    PyramidHeader header{};
+    std::memcpy(&header, file_.data(), sizeof(header));
+    if (header.magic != kPyramidMagic || header.version != kPyramidVersion || header.tileSize == 0 || header.levelCount == 0 ||
+        header.levelCount > kMaxLevels || file_.size() < dataOffsetFor(header.levelCount)) {
+        close();
+        return false;
+    }
+
+    levels_.resize(header.levelCount);
+    std::memcpy(levels_.data(), file_.data() + sizeof(header), sizeof(TilePyramidLevel) * header.levelCount);
+    const std::vector<TilePyramidLevel> expected = planLevels(header.width, header.height, header.tileSize);
+    bool consistent = expected.size() == levels_.size();
+    for (size_t i = 0; consistent && i < levels_.size(); ++i) {
+        consistent = std::memcmp(&expected[i], &levels_[i], sizeof(TilePyramidLevel)) == 0;
+    }
+
+    tileSize_ = header.tileSize;
+    border_ = header.border;
+    pageCount_ = header.pageCount;
+    dataOffset_ = dataOffsetFor(header.levelCount);
+    const uint64_t expectedPages = static_cast<uint64_t>(levels_.back().firstPage) + levels_.back().tilesX * levels_.back().tilesY;
+    if (!consistent || pageCount_ != expectedPages || file_.size() < dataOffset_ + static_cast<uint64_t>(pageCount_) * pageBytes()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void TilePyramid::close()
+{
+    file_.close();
+    levels_.clear();
+    tileSize_ = 0;
+    border_ = 0;
+    pageCount_ = 0;
+    dataOffset_ = 0;
+}
+
+std::span<const uint8_t> TilePyramid::page(uint32_t pageIndex) const
+{
+    return file_.bytes().subspan(static_cast<size_t>(dataOffset_ + static_cast<uint64_t>(pageIndex) * pageBytes()), pageBytes());
+}
+
+} // namespace core::image
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "core/image/ImageFile.h"
+#include "core/io/MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace core::image {
+
+// One level of a tiled pyramid. Level sizes halve with floor (minimum 1), like Vulkan mips.
+// Pages of every level are numbered globally: firstPage + y * tilesX + x.
+struct TilePyramidLevel {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t tilesX = 0;
+    uint32_t tilesY = 0;
+    uint32_t firstPage = 0;
+};
+
+// Writes a .vktp virtual texture pyramid: every level from source down to the first level that
+// fits in a single tile, cut into tileSize x tileSize RGBA8 pages with a `border` texel apron
+// (clamped at image edges) so bilinear filtering never reads a neighbouring page. Pages are
+// fixed size and stored level by level, so page N lives at dataOffset + N * pageBytes.
+bool writeTilePyramid(const std::filesystem::path& path, const RgbaImage& source, uint32_t tileSize, uint32_t border);
+
+bool isTilePyramidPath(const std::string& path);
+
+// Read-only mapped .vktp. page() returns a span into the mapping; nothing is decoded up front,
+// so opening a gigapixel pyramid costs only the mapping.
+class TilePyramid {
+public:
+    static constexpr uint32_t kMaxLevels = 16;
+
+    bool open(const std::filesystem::path& path);
+    void close();
+
+    bool isOpen() const { return file_.isOpen(); }
+    uint32_t width() const { return levels_.empty() ? 0U : levels_.front().width; }
+    uint32_t height() const { return levels_.empty() ? 0U : levels_.front().height; }
+    uint32_t tileSize() const { return tileSize_; }
+    uint32_t border() const { return border_; }
+    uint32_t pagePixels() const { return tileSize_ + 2U * border_; }
+    size_t pageBytes() const { return static_cast<size_t>(pagePixels()) * pagePixels() * 4U; }
+    uint32_t pageCount() const { return pageCount_; }
+    uint32_t levelCount() const { return static_cast<uint32_t>(levels_.size()); }
+    const TilePyramidLevel& level(uint32_t index) const { return levels_[index]; }
+    std::span<const uint8_t> page(uint32_t pageIndex) const;
+
+private:
+    core::io::MappedFile file_{};
+    std::vector<TilePyramidLevel> levels_{};
+    uint32_t tileSize_ = 0;
+    uint32_t border_ = 0;
+    uint32_t pageCount_ = 0;
+    uint64_t dataOffset_ = 0;
+};
+
+} // namespace core::image
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+namespace core::io {
+
+// XXH64 of bytes. Fast enough (several GB/s) to key caches on the full content of large files;
+// not a cryptographic hash. Chain several inputs by passing the previous result as the seed.
+uint64_t hashContent(std::span<const uint8_t> bytes, uint64_t seed = 0);
+
+} // namespace core::io
@@ -0,0 +1,117 @@
+#include "core/io/FileLock.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+#include <utility>
+
+namespace core::io {
+
+FileLock::~FileLock()
+{
+    unlock();
+}
+
+FileLock::FileLock(FileLock&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+FileLock& FileLock::operator=(FileLock&& other) noexcept
+{
+    if (this == &other) return *this;
+    unlock();
+#if defined(_WIN32)
+    handle_ = std::exchange(other.handle_, nullptr);
+#else
+    fd_ = std::exchange(other.fd_, -1);
+#endif
+    return *this;
+}
+
+#if defined(_WIN32)
+
+bool FileLock::tryLock(const std::filesystem::path& path)
+{
+    unlock();
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                              OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    OVERLAPPED overlapped{};
+    if (!LockFileEx(file, LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY, 0, 1, 0, &overlapped)) {
+        CloseHandle(file);
+        return false;
+    }
+    handle_ = file;
+    return true;
+}
+
+void FileLock::unlock()
+{
+    if (!handle_) return;
+    OVERLAPPED overlapped{};
+    UnlockFileEx(static_cast<HANDLE>(handle_), 0, 1, 0, &overlapped);
+    CloseHandle(static_cast<HANDLE>(handle_));
+    handle_ = nullptr;
+}
+
+bool FileLock::isLocked() const
+{
+    return handle_ != nullptr;
+}
+
+bool syncFile(const std::filesystem::path& path)
+{
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    const bool synced = FlushFileBuffers(file) != 0;
+    CloseHandle(file);
+    return synced;
+}
+
+#else
+
+bool FileLock::tryLock(const std::filesystem::path& path)
+{
+    unlock();
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        ::close(fd);
+        return false;
+    }
+    fd_ = fd;
+    return true;
+}
+
+void FileLock::unlock()
+{
+    if (fd_ < 0) return;
+    flock(fd_, LOCK_UN);
+    ::close(fd_);
+    fd_ = -1;
+}
+
+bool FileLock::isLocked() const
+{
+    return fd_ >= 0;
+}
+
+bool syncFile(const std::filesystem::path& path)
+{
+    const int fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0) return false;
+    const bool synced = fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+}
+
+#endif
+
+} // namespace core::io
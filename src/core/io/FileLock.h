@@ -0,0 +1,39 @@
+#pragma once
+
+#include <filesystem>
+
+namespace core::io {
+
+// Exclusive lock on a lock file, shared between processes: flock() on POSIX, LockFileEx() on
+// Windows. The lock is released on unlock(), destruction, or when the process exits, so a crashed
+// holder never leaves it stuck. Move-only.
+class FileLock {
+public:
+    FileLock() = default;
+    ~FileLock();
+
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+    FileLock(FileLock&& other) noexcept;
+    FileLock& operator=(FileLock&& other) noexcept;
+
+    // Creates path if needed and takes the lock without waiting. Returns false when another
+    // process (or another FileLock in this one) holds it, or the file cannot be created.
+    bool tryLock(const std::filesystem::path& path);
+    void unlock();
+
+    bool isLocked() const;
+
+private:
+#if defined(_WIN32)
+    void* handle_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+// Forces the written contents of the file at path to stable storage (fsync / FlushFileBuffers),
+// including writes made through other handles, such as a std::fstream that was flush()ed.
+bool syncFile(const std::filesystem::path& path);
+
+} // namespace core::io
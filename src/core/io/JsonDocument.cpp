@@ -0,0 +1,328 @@
+#include "core/io/JsonDocument.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace core::io {
+
+namespace {
+
+// Deeper nesting than any glTF needs; bounds the recursion on hostile input.
+constexpr int kMaxDepth = 512;
+
+bool isJsonSpace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Stable, so the first of several duplicate keys is the one get() finds. Objects are nearly always
+// small, and an insertion sort there avoids std::stable_sort's temporary buffer.
+void sortMembers(JsonMember* members, uint32_t count)
+{
+    const auto byKey = [](const JsonMember& a, const JsonMember& b) { return a.key < b.key; };
+    if (count > 32) {
+        std::stable_sort(members, members + count, byKey);
+        return;
+    }
+    for (uint32_t i = 1; i < count; ++i) {
+        const JsonMember member = members[i];
+        uint32_t j = i;
+        for (; j > 0 && byKey(member, members[j - 1]); --j) members[j] = members[j - 1];
+        members[j] = member;
+    }
+}
+
+// Children are collected on shared stacks while their container is open and copied into the arena
+// as one run when it closes, so nested containers never interleave with their parent's children.
+class JsonParser {
+public:
+    JsonParser(std::string_view text, std::pmr::memory_resource& arena)
+        : text_(text), arena_(arena) {}
+
+    JsonValue parse()
+    {
+        skipWs();
+        JsonValue v = parseValue(0);
+        skipWs();
+        if (pos_ != text_.size()) throw std::runtime_error("unexpected trailing json text");
+        return v;
+    }
+
+private:
+    JsonValue parseValue(int depth)
+    {
+        skipWs();
+        if (pos_ >= text_.size()) throw std::runtime_error("unexpected end of json");
+        const char c = text_[pos_];
+        if (c == '{') return parseObject(depth + 1);
+        if (c == '[') return parseArray(depth + 1);
+        if (c == '"') {
+            JsonValue v;
+            v.type = JsonType::String;
+            v.s = parseString();
+            return v;
+        }
+        if (c == 't') return parseLiteral("true", JsonType::Bool, true);
+        if (c == 'f') return parseLiteral("false", JsonType::Bool, false);
+        if (c == 'n') return parseLiteral("null", JsonType::Null, false);
+        if (c == '-' || isDigit(c)) return parseNumber();
+        throw std::runtime_error("invalid json token");
+    }
+
+    JsonValue parseObject(int depth)
+    {
+        if (depth > kMaxDepth) throw std::runtime_error("json nested too deeply");
+        ++pos_; // {
+        const size_t first = members_.size();
+        skipWs();
+        if (peek('}')) {
+            ++pos_;
+        } else {
+            while (true) {
+                skipWs();
+                const std::string_view key = parseString();
+                skipWs();
+                expect(':');
+                JsonValue value = parseValue(depth);
+                members_.push_back(JsonMember{key, value});
+                skipWs();
+                if (peek('}')) {
+                    ++pos_;
+                    break;
+                }
+                expect(',');
+            }
+        }
+
+        JsonValue v;
+        v.type = JsonType::Object;
+        v.count = static_cast<uint32_t>(members_.size() - first);
+        if (v.count > 0) {
+            auto* run = static_cast<JsonMember*>(arena_.allocate(sizeof(JsonMember) * v.count, alignof(JsonMember)));
+            std::uninitialized_copy(members_.begin() + static_cast<std::ptrdiff_t>(first), members_.end(), run);
+            sortMembers(run, v.count);
+            v.members = run;
+        }
+        members_.resize(first);
+        return v;
+    }
+
+    JsonValue parseArray(int depth)
+    {
+        if (depth > kMaxDepth) throw std::runtime_error("json nested too deeply");
+        ++pos_; // [
+        const size_t first = items_.size();
+        skipWs();
+        if (peek(']')) {
+            ++pos_;
+        } else {
+            while (true) {
+                JsonValue item = parseValue(depth);
+                items_.push_back(item);
+                skipWs();
+                if (peek(']')) {
+                    ++pos_;
+                    break;
+                }
+                expect(',');
+            }
+        }
+
+        JsonValue v;
+        v.type = JsonType::Array;
+        v.count = static_cast<uint32_t>(items_.size() - first);
+        if (v.count > 0) {
+            auto* run = static_cast<JsonValue*>(arena_.allocate(sizeof(JsonValue) * v.count, alignof(JsonValue)));
+            std::uninitialized_copy(items_.begin() + static_cast<std::ptrdiff_t>(first), items_.end(), run);
+            v.items = run;
+        }
+        items_.resize(first);
+        return v;
+    }
+
+    // A view into the source when the string has no escapes, else the decoded copy in the arena.
+    std::string_view parseString()
+    {
+        expect('"');
+        const size_t start = pos_;
+        while (pos_ < text_.size()) {
+            const char c = text_[pos_];
+            if (c == '"') return text_.substr(start, pos_++ - start);
+            if (c == '\\') break;
+            if (static_cast<unsigned char>(c) < 0x20) throw std::runtime_error("control character in json string");
+            ++pos_;
+        }
+        if (pos_ >= text_.size()) throw std::runtime_error("unterminated json string");
+
+        scratch_.assign(text_.data() + start, pos_ - start);
+        while (pos_ < text_.size()) {
+            const char c = text_[pos_++];
+            if (c == '"') {
+                char* copy = static_cast<char*>(arena_.allocate(scratch_.size(), 1));
+                std::memcpy(copy, scratch_.data(), scratch_.size());
+                return std::string_view(copy, scratch_.size());
+            }
+            if (c != '\\') {
+                if (static_cast<unsigned char>(c) < 0x20) throw std::runtime_error("control character in json string");
+                scratch_.push_back(c);
+                continue;
+            }
+            if (pos_ >= text_.size()) throw std::runtime_error("bad json escape");
+            const char e = text_[pos_++];
+            switch (e) {
+                case '"': scratch_.push_back('"'); break;
+                case '\\': scratch_.push_back('\\'); break;
+                case '/': scratch_.push_back('/'); break;
+                case 'b': scratch_.push_back('\b'); break;
+                case 'f': scratch_.push_back('\f'); break;
+                case 'n': scratch_.push_back('\n'); break;
+                case 'r': scratch_.push_back('\r'); break;
+                case 't': scratch_.push_back('\t'); break;
+                case 'u': appendUtf8(parseCodePoint()); break;
+                default: throw std::runtime_error("invalid json escape");
+            }
+        }
+        throw std::runtime_error("unterminated json string");
+    }
+
+    uint32_t parseHex4()
+    {
+        if (pos_ + 4 > text_.size()) throw std::runtime_error("bad json unicode escape");
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) {
+            const int digit = hexValue(text_[pos_++]);
+            if (digit < 0) throw std::runtime_error("bad json unicode escape");
+            value = (value << 4) | static_cast<uint32_t>(digit);
+        }
+        return value;
+    }
+
+    // After "\u": one code unit, or a surrogate pair written as two escapes.
+    uint32_t parseCodePoint()
+    {
+        const uint32_t unit = parseHex4();
+        if (unit >= 0xDC00 && unit <= 0xDFFF) throw std::runtime_error("unpaired json surrogate");
+        if (unit < 0xD800 || unit > 0xDBFF) return unit;
+        if (pos_ + 2 > text_.size() || text_[pos_] != '\\' || text_[pos_ + 1] != 'u') throw std::runtime_error("unpaired json surrogate");
+        pos_ += 2;
+        const uint32_t low = parseHex4();
+        if (low < 0xDC00 || low > 0xDFFF) throw std::runtime_error("unpaired json surrogate");
+        return 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+    }
+
+    void appendUtf8(uint32_t cp)
+    {
+        if (cp < 0x80) {
+            scratch_.push_back(static_cast<char>(cp));
+        } else if (cp < 0x800) {
+            scratch_.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            scratch_.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            scratch_.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            scratch_.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            scratch_.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else {
+            scratch_.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+            scratch_.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+            scratch_.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            scratch_.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+    }
+
+    JsonValue parseLiteral(std::string_view literal, JsonType type, bool b)
+    {
+        if (text_.substr(pos_, literal.size()) != literal) throw std::runtime_error("invalid json literal");
+        pos_ += literal.size();
+        JsonValue v;
+        v.type = type;
+        v.b = b;
+        return v;
+    }
+
+    JsonValue parseNumber()
+    {
+        // Validate the JSON grammar (from_chars alone would accept "01" or "1.").
+        const size_t start = pos_;
+        if (peek('-')) ++pos_;
+        if (peek('0')) {
+            ++pos_;
+        } else {
+            if (pos_ >= text_.size() || !isDigit(text_[pos_])) throw std::runtime_error("bad number");
+            while (pos_ < text_.size() && isDigit(text_[pos_])) ++pos_;
+        }
+        if (peek('.')) {
+            ++pos_;
+            if (pos_ >= text_.size() || !isDigit(text_[pos_])) throw std::runtime_error("bad fraction");
+            while (pos_ < text_.size() && isDigit(text_[pos_])) ++pos_;
+        }
+        if (peek('e') || peek('E')) {
+            ++pos_;
+            if (peek('+') || peek('-')) ++pos_;
+            if (pos_ >= text_.size() || !isDigit(text_[pos_])) throw std::runtime_error("bad exponent");
+            while (pos_ < text_.size() && isDigit(text_[pos_])) ++pos_;
+        }
+
+        JsonValue v;
+        v.type = JsonType::Number;
+        // Out of range (1e400, 1e-400) is an error too: from_chars leaves v.n untouched then.
+        const auto [end, ec] = std::from_chars(text_.data() + start, text_.data() + pos_, v.n);
+        if (ec == std::errc::result_out_of_range) throw std::runtime_error("number out of range");
+        if (ec != std::errc{} || end != text_.data() + pos_) throw std::runtime_error("failed number parse");
+        return v;
+    }
+
+    void skipWs()
+    {
+        while (pos_ < text_.size() && isJsonSpace(text_[pos_])) ++pos_;
+    }
+
+    void expect(char c)
+    {
+        if (pos_ >= text_.size() || text_[pos_] != c) throw std::runtime_error("unexpected json character");
+        ++pos_;
+    }
+
+    bool peek(char c) const { return pos_ < text_.size() && text_[pos_] == c; }
+
+    std::string_view text_;
+    std::pmr::memory_resource& arena_;
+    size_t pos_ = 0;
+    std::vector<JsonValue> items_{};
+    std::vector<JsonMember> members_{};
+    std::string scratch_{};
+};
+
+} // namespace
+
+const JsonValue* JsonValue::get(std::string_view key) const
+{
+    if (type != JsonType::Object || count == 0) return nullptr;
+    const JsonMember* end = members + count;
+    const JsonMember* it = std::lower_bound(members, end, key, [](const JsonMember& m, std::string_view k) { return m.key < k; });
+    return (it != end && it->key == key) ? &it->value : nullptr;
+}
+
+// The arena starts at about the size of the text, which covers typical glTF manifests in one block.
+JsonDocument::JsonDocument(std::string_view text)
+    : arena_(std::max<size_t>(4096, text.size()))
+{
+    root_ = JsonParser(text, arena_).parse();
+}
+
+} // namespace core::io
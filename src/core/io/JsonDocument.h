@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <string_view>
+
+namespace core::io {
+
+enum class JsonType : uint8_t {
+    Null,
+    Bool,
+    Number,
+    String,
+    Array,
+    Object,
+};
+
+struct JsonMember;
+
+// One parsed value. Array items and object members are contiguous runs in the document's arena;
+// members are sorted by key (duplicates keep document order), so get() is a binary search.
+struct JsonValue {
+    JsonType type = JsonType::Null;
+    bool b = false;
+    uint32_t count = 0; // array items or object members
+    union {
+        double n = 0.0;
+        const JsonValue* items;
+        const JsonMember* members;
+    };
+    std::string_view s{}; // strings only
+
+    // First member named key, or null when this is not an object or has no such member.
+    const JsonValue* get(std::string_view key) const;
+    const JsonValue* at(size_t i) const { return (type == JsonType::Array && i < count) ? &items[i] : nullptr; }
+    size_t size() const { return (type == JsonType::Array || type == JsonType::Object) ? count : 0; }
+
+    // Null as well when the number does not fit an int64_t, instead of an undefined conversion.
+    std::optional<int64_t> asInt() const
+    {
+        if (type != JsonType::Number || !(n >= -0x1p63 && n < 0x1p63)) return std::nullopt;
+        return static_cast<int64_t>(n);
+    }
+    std::optional<double> asNumber() const
+    {
+        if (type != JsonType::Number) return std::nullopt;
+        return n;
+    }
+    std::optional<std::string_view> asString() const
+    {
+        if (type != JsonType::String) return std::nullopt;
+        return s;
+    }
+};
+
+struct JsonMember {
+    std::string_view key{};
+    JsonValue value{};
+};
+
+// A JSON text parsed into a single arena. Strings without escapes (nearly all of them) are views
+// into the source text, which must outlive the document; escaped strings, \u escapes included,
+// are decoded to UTF-8 in the arena. Every value is released together with the document.
+class JsonDocument {
+public:
+    // Throws std::runtime_error on malformed input.
+    explicit JsonDocument(std::string_view text);
+
+    JsonDocument(const JsonDocument&) = delete;
+    JsonDocument& operator=(const JsonDocument&) = delete;
+
+    const JsonValue& root() const { return root_; }
+    const JsonValue* get(std::string_view key) const { return root_.get(key); }
+
+private:
+    std::pmr::monotonic_buffer_resource arena_;
+    JsonValue root_{};
+};
+
+} // namespace core::io
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace core::io {
+
+// Memory mapping of a whole file, read-only by default. Move-only; the mapping is released on
+// close() or destruction, so any span handed out must not outlive the MappedFile that produced it.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Maps the file at path. Returns false (and leaves the object closed) when the file is
+    // missing, empty, or cannot be mapped.
+    bool open(const std::filesystem::path& path);
+    // Maps the file at path read-write and shared, creating it or resizing it to size bytes first.
+    // Writes through mutableData() reach the file; flush() forces them to disk.
+    bool openWritable(const std::filesystem::path& path, size_t size);
+    bool flush();
+    void close();
+
+    bool isOpen() const { return data_ != nullptr; }
+    const uint8_t* data() const { return data_; }
+    // Null unless the file was opened with openWritable().
+    uint8_t* mutableData() const { return writable_ ? const_cast<uint8_t*>(data_) : nullptr; }
+    size_t size() const { return size_; }
+    std::span<const uint8_t> bytes() const { return {data_, size_}; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool writable_ = false;
+#if defined(_WIN32)
+    void* fileHandle_ = nullptr;
+    void* mappingHandle_ = nullptr;
+#endif
+};
+
+} // namespace core::io
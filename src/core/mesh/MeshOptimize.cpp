@@ -0,0 +1,249 @@
+#include "core/mesh/MeshOptimize.h"
+
+#include "core/io/ContentHash.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace core::mesh {
+
+namespace {
+
+constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+// Forsyth, "Linear-Speed Vertex Cache Optimisation" (2006): the LRU size the scores model and the
+// weights of cache position and remaining valence. The result suits any FIFO of similar size.
+constexpr uint32_t kScoreCacheSize = 32;
+constexpr float kLastTriangleScore = 0.75f;
+constexpr float kCacheDecayPower = 1.5f;
+constexpr float kValenceBoostScale = 2.0f;
+constexpr float kValenceBoostPower = 0.5f;
+constexpr uint32_t kValenceTableSize = 32;
+
+struct ScoreTables {
+    std::array<float, kScoreCacheSize> cache{};
+    std::array<float, kValenceTableSize> valence{};
+
+    ScoreTables()
+    {
+        for (uint32_t i = 0; i < kScoreCacheSize; ++i) {
+            if (i < 3) {
+                cache[i] = kLastTriangleScore;
+            } else {
+                const float scale = 1.0f / static_cast<float>(kScoreCacheSize - 3);
+                cache[i] = std::pow(1.0f - static_cast<float>(i - 3) * scale, kCacheDecayPower);
+            }
+        }
+        for (uint32_t i = 1; i < kValenceTableSize; ++i) valence[i] = kValenceBoostScale * std::pow(static_cast<float>(i), -kValenceBoostPower);
+    }
+
+    float score(uint32_t cachePosition, uint32_t remaining) const
+    {
+        if (remaining == 0) return -1.0f;
+        const float fromCache = cachePosition < kScoreCacheSize ? cache[cachePosition] : 0.0f;
+        const float fromValence = remaining < kValenceTableSize ? valence[remaining]
+                                                                : kValenceBoostScale * std::pow(static_cast<float>(remaining), -kValenceBoostPower);
+        return fromCache + fromValence;
+    }
+};
+
+// Per-vertex scratch shared by every range, so a model of many small meshes does not pay for
+// the whole vertex count once per mesh.
+struct RangeScratch {
+    std::vector<uint32_t> localOf; // global vertex -> local id within the current range, kNone otherwise
+    std::vector<uint32_t> globalOf;
+};
+
+// Reorders the triangles of indices (a whole number of them) in place.
+void optimizeRangeForCache(uint32_t* indices, size_t indexCount, RangeScratch& scratch, const ScoreTables& tables)
+{
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount < 2) return;
+
+    std::vector<uint32_t> local(indexCount);
+    scratch.globalOf.clear();
+    for (size_t i = 0; i < indexCount; ++i) {
+        uint32_t& id = scratch.localOf[indices[i]];
+        if (id == kNone) {
+            id = static_cast<uint32_t>(scratch.globalOf.size());
+            scratch.globalOf.push_back(indices[i]);
+        }
+        local[i] = id;
+    }
+    for (const uint32_t v : scratch.globalOf) scratch.localOf[v] = kNone;
+    const size_t vertexCount = scratch.globalOf.size();
+
+    // Triangles of each vertex; the first remaining[v] entries of its run are the ones not yet emitted.
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (const uint32_t v : local) ++offsets[v + 1];
+    for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] += offsets[v];
+    std::vector<uint32_t> remaining(vertexCount, 0);
+    std::vector<uint32_t> adjacency(indexCount);
+    for (size_t i = 0; i < indexCount; ++i) {
+        const uint32_t v = local[i];
+        adjacency[offsets[v] + remaining[v]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    std::vector<uint32_t> cachePosition(vertexCount, kNone);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) vertexScore[v] = tables.score(kNone, remaining[v]);
+    std::vector<float> triangleScore(triangleCount);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        triangleScore[t] = vertexScore[local[t * 3]] + vertexScore[local[t * 3 + 1]] + vertexScore[local[t * 3 + 2]];
+    }
+    std::vector<bool> emitted(triangleCount, false);
+
+    std::vector<uint32_t> output;
+    output.reserve(indexCount);
+    std::array<uint32_t, kScoreCacheSize + 3> cache{};
+    std::array<uint32_t, kScoreCacheSize + 3> nextCache{};
+    size_t cacheCount = 0;
+    size_t cursor = 0; // every triangle before it is emitted
+
+    uint32_t best = static_cast<uint32_t>(std::max_element(triangleScore.begin(), triangleScore.end()) - triangleScore.begin());
+    while (output.size() < indexCount) {
+        if (best == kNone) {
+            while (emitted[cursor]) ++cursor;
+            best = static_cast<uint32_t>(cursor);
+        }
+        emitted[best] = true;
+        size_t nextCount = 0;
+        for (size_t c = 0; c < 3; ++c) {
+            const uint32_t v = local[best * 3 + c];
+            output.push_back(indices[best * 3 + c]);
+            uint32_t* run = adjacency.data() + offsets[v];
+            std::swap(*std::find(run, run + remaining[v], best), run[remaining[v] - 1]);
+            --remaining[v];
+            if (std::find(nextCache.begin(), nextCache.begin() + static_cast<std::ptrdiff_t>(nextCount), v) == nextCache.begin() + static_cast<std::ptrdiff_t>(nextCount)) {
+                nextCache[nextCount++] = v;
+            }
+        }
+        // Only the triangle's own vertices are compared against: a degenerate one pushes fewer than
+        // three, and the slots past them hold stale entries or old-cache vertices appended below.
+        const auto newEnd = nextCache.begin() + static_cast<std::ptrdiff_t>(nextCount);
+        for (size_t i = 0; i < cacheCount; ++i) {
+            const uint32_t v = cache[i];
+            if (std::find(nextCache.begin(), newEnd, v) == newEnd) nextCache[nextCount++] = v;
+        }
+
+        // Rescore everything that moved in or out of the cache, and find the best triangle among
+        // those still touching it.
+        best = kNone;
+        float bestScore = -std::numeric_limits<float>::max();
+        for (size_t i = 0; i < nextCount; ++i) {
+            const uint32_t v = nextCache[i];
+            cachePosition[v] = i < kScoreCacheSize ? static_cast<uint32_t>(i) : kNone;
+            const float score = tables.score(cachePosition[v], remaining[v]);
+            const float delta = score - vertexScore[v];
+            vertexScore[v] = score;
+            const uint32_t* run = adjacency.data() + offsets[v];
+            for (uint32_t k = 0; k < remaining[v]; ++k) {
+                const uint32_t t = run[k];
+                triangleScore[t] += delta;
+                if (i < kScoreCacheSize && triangleScore[t] > bestScore) {
+                    bestScore = triangleScore[t];
+                    best = t;
+                }
+            }
+        }
+        cacheCount = std::min<size_t>(nextCount, kScoreCacheSize);
+        std::copy(nextCache.begin(), nextCache.begin() + static_cast<std::ptrdiff_t>(cacheCount), cache.begin());
+    }
+    std::copy(output.begin(), output.end(), indices);
+}
+
+// Merges bitwise-identical vertices in place and rewrites indices to match.
+void removeDuplicateVertices(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+    size_t tableSize = 1;
+    while (tableSize < vertices.size() * 2) tableSize <<= 1;
+    std::vector<uint32_t> table(tableSize, kNone);
+    std::vector<uint32_t> remap(vertices.size());
+
+    uint32_t unique = 0;
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const std::span<const uint8_t> bytes(reinterpret_cast<const uint8_t*>(&vertices[i]), sizeof(Vertex));
+        size_t slot = static_cast<size_t>(core::io::hashContent(bytes)) & (tableSize - 1);
+        while (table[slot] != kNone && std::memcmp(&vertices[table[slot]], &vertices[i], sizeof(Vertex)) != 0) slot = (slot + 1) & (tableSize - 1);
+        if (table[slot] == kNone) {
+            table[slot] = unique;
+            vertices[unique++] = vertices[i];
+        }
+        remap[i] = table[slot];
+    }
+    vertices.resize(unique);
+    for (uint32_t& index : indices) index = remap[index];
+}
+
+// Renumbers vertices in the order indices first use them; unreferenced vertices are dropped.
+void reorderVerticesForFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+    std::vector<uint32_t> remap(vertices.size(), kNone);
+    std::vector<Vertex> ordered;
+    ordered.reserve(vertices.size());
+    for (uint32_t& index : indices) {
+        if (remap[index] == kNone) {
+            remap[index] = static_cast<uint32_t>(ordered.size());
+            ordered.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+    vertices = std::move(ordered);
+}
+
+} // namespace
+
+VertexCacheStats analyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize)
+{
+    VertexCacheStats stats{};
+    if (indices.size() < 3 || cacheSize == 0) return stats;
+
+    // A vertex is cached while fewer than cacheSize misses have followed its own; 0 = never seen.
+    std::vector<uint64_t> missedAt(vertexCount, 0);
+    uint64_t misses = cacheSize + 1;
+    size_t transformed = 0;
+    size_t referenced = 0;
+    for (const uint32_t v : indices) {
+        if (v >= vertexCount) continue;
+        if (missedAt[v] == 0) ++referenced;
+        if (misses - missedAt[v] > cacheSize) {
+            missedAt[v] = misses++;
+            ++transformed;
+        }
+    }
+    stats.acmr = static_cast<double>(transformed) / static_cast<double>(indices.size() / 3);
+    stats.atvr = referenced > 0 ? static_cast<double>(transformed) / static_cast<double>(referenced) : 0.0;
+    return stats;
+}
+
+MeshOptimizeStats optimizeMesh(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, std::span<const IndexRange> ranges)
+{
+    MeshOptimizeStats stats{};
+    stats.verticesBefore = vertices.size();
+    stats.verticesAfter = vertices.size();
+    stats.before = analyzeVertexCache(indices, vertices.size());
+    stats.after = stats.before;
+    const bool inRange = std::all_of(indices.begin(), indices.end(), [&](uint32_t index) { return index < vertices.size(); });
+    if (indices.empty() || !inRange) return stats;
+
+    removeDuplicateVertices(vertices, indices);
+
+    const ScoreTables tables;
+    RangeScratch scratch;
+    scratch.localOf.assign(vertices.size(), kNone);
+    for (const IndexRange& range : ranges) {
+        const bool whole = range.indexCount % 3 == 0 && range.firstIndex <= indices.size() && range.indexCount <= indices.size() - range.firstIndex;
+        if (whole) optimizeRangeForCache(indices.data() + range.firstIndex, range.indexCount, scratch, tables);
+    }
+
+    reorderVerticesForFetch(vertices, indices);
+
+    stats.verticesAfter = vertices.size();
+    stats.after = analyzeVertexCache(indices, vertices.size());
+    return stats;
+}
+
+} // namespace core::mesh
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "core/RenderTypes.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace core::mesh {
+
+// A run of a triangle index buffer drawn on its own, e.g. one mesh of an instanced model.
+struct IndexRange {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+};
+
+// Post-transform vertex cache behaviour of a triangle list, simulated as a FIFO cache.
+struct VertexCacheStats {
+    double acmr = 0.0; // vertex shader invocations per triangle: 3 worst, ~0.5 for a large regular grid
+    double atvr = 0.0; // vertex shader invocations per referenced vertex: 1 is ideal
+};
+
+// The FIFO size the analysis assumes; in the range current GPUs behave like.
+constexpr uint32_t kVertexCacheSize = 16;
+
+VertexCacheStats analyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize = kVertexCacheSize);
+
+struct MeshOptimizeStats {
+    size_t verticesBefore = 0;
+    size_t verticesAfter = 0;
+    VertexCacheStats before{};
+    VertexCacheStats after{};
+};
+
+// Rewrites a triangle list for GPU vertex throughput, in the order meshoptimizer applies the same
+// steps: merges bitwise-identical vertices, reorders the triangles of each range for the
+// post-transform cache (Forsyth's scoring), then renumbers vertices in first-use order and drops
+// unreferenced ones for fetch locality. Triangles never leave their range, so every range stays
+// drawable at the same firstIndex/indexCount; ranges must not overlap and must hold whole
+// triangles, and indices outside every range keep their order. Indices must be < vertices.size().
+MeshOptimizeStats optimizeMesh(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, std::span<const IndexRange> ranges);
+
+} // namespace core::mesh
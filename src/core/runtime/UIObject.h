@@ -1,5 +1,7 @@
 #pragma once
 
+#include "core/runtime/VirtualTextureCache.h"
+
 #include <imgui.h>
 
 namespace core::runtime {
@@ -47,6 +49,18 @@ public:
         ImGui::ShowDemoWindow(&showDemoWindow);
         return false;
     }
+
+    void drawVirtualTexturePanel(const VirtualTextureStats& stats)
+    {
+        ImGui::Begin("Virtual Texture");
+        ImGui::Text("Resident pages %u / %u", stats.residentPages, stats.capacityPages);
+        ImGui::Text("Requested pages %u", stats.requestedPages);
+        ImGui::Text("Pending pages %u", stats.pendingPages);
+        ImGui::Text("Uploads last frame %u", stats.uploadsLastFrame);
+        ImGui::Text("Uploads total %llu", static_cast<unsigned long long>(stats.uploadsTotal));
+        ImGui::Text("Evictions total %llu", static_cast<unsigned long long>(stats.evictionsTotal));
+        ImGui::End();
+    }
 };
 
 } // namespace core::runtime
@@ -0,0 +1,143 @@
+#include "core/runtime/VirtualTextureCache.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace core::runtime {
+
+void VirtualTextureCache::reset(const core::image::TilePyramid& pyramid, uint32_t pagesPerSide)
+{
+    levels_.clear();
+    for (uint32_t i = 0; i < pyramid.levelCount(); ++i) {
+        levels_.push_back(pyramid.level(i));
+    }
+    pagesPerSide_ = std::clamp(pagesPerSide, 1U, 256U);
+    pinnedPage_ = levels_.empty() ? kNone : levels_.back().firstPage;
+    pageSlot_.assign(pyramid.pageCount(), kNone);
+    slots_.assign(static_cast<size_t>(pagesPerSide_) * pagesPerSide_, Slot{});
+    pageTable_.assign(pyramid.pageCount(), 0U);
+    requestedThisFrame_.assign(pyramid.pageCount(), 0U);
+    frame_ = 0;
+    stats_ = VirtualTextureStats{};
+    stats_.capacityPages = static_cast<uint32_t>(slots_.size());
+}
+
+uint32_t VirtualTextureCache::levelOfPage(uint32_t page) const
+{
+    uint32_t level = 0;
+    while (level + 1U < levels_.size() && page >= levels_[level + 1U].firstPage) ++level;
+    return level;
+}
+
+uint32_t VirtualTextureCache::parentPage(uint32_t page) const
+{
+    const uint32_t level = levelOfPage(page);
+    if (level + 1U >= levels_.size()) return kNone;
+    const core::image::TilePyramidLevel& current = levels_[level];
+    const core::image::TilePyramidLevel& parent = levels_[level + 1U];
+    const uint32_t local = page - current.firstPage;
+    const uint32_t px = std::min((local % current.tilesX) / 2U, parent.tilesX - 1U);
+    const uint32_t py = std::min((local / current.tilesX) / 2U, parent.tilesY - 1U);
+    return parent.firstPage + py * parent.tilesX + px;
+}
+
+uint32_t VirtualTextureCache::acquireSlot()
+{
+    uint32_t victim = kNone;
+    for (uint32_t i = 0; i < slots_.size(); ++i) {
+        const Slot& slot = slots_[i];
+        if (slot.page == kNone) return i;
+        // Pages used this frame are never evicted, so a too-small cache degrades to ancestors
+        // instead of thrashing.
+        if (slot.page == pinnedPage_ || slot.lastUsedFrame == frame_) continue;
+        if (victim == kNone || slot.lastUsedFrame < slots_[victim].lastUsedFrame) victim = i;
+    }
+    if (victim != kNone) {
+        pageSlot_[slots_[victim].page] = kNone;
+        slots_[victim].page = kNone;
+        ++stats_.evictionsTotal;
+        --stats_.residentPages;
+    }
+    return victim;
+}
+
+std::vector<VirtualTextureCache::PageUpload> VirtualTextureCache::update(std::span<const uint32_t> requestedBits, uint32_t maxUploads)
+{
+    std::vector<PageUpload> uploads;
+    if (levels_.empty()) return uploads;
+    ++frame_;
+
+    std::vector<uint32_t> requested;
+    auto request = [&](uint32_t page) {
+        // Walk up until an ancestor was already marked this frame.
+        while (page != kNone && !requestedThisFrame_[page]) {
+            requestedThisFrame_[page] = 1U;
+            requested.push_back(page);
+            page = parentPage(page);
+        }
+    };
+    request(pinnedPage_);
+    const size_t pageCount = pageSlot_.size();
+    for (size_t word = 0; word < requestedBits.size(); ++word) {
+        uint32_t bits = requestedBits[word];
+        while (bits != 0U) {
+            const uint32_t bit = static_cast<uint32_t>(std::countr_zero(bits));
+            bits &= bits - 1U;
+            const size_t page = word * 32U + bit;
+            if (page < pageCount) request(static_cast<uint32_t>(page));
+        }
+    }
+
+    std::vector<uint32_t> missing;
+    for (uint32_t page : requested) {
+        requestedThisFrame_[page] = 0U;
+        const uint32_t slot = pageSlot_[page];
+        if (slot != kNone) {
+            slots_[slot].lastUsedFrame = frame_;
+        } else {
+            missing.push_back(page);
+        }
+    }
+
+    // Coarse pages first: one coarse page improves every fine page below it.
+    std::sort(missing.begin(), missing.end(), [](uint32_t a, uint32_t b) { return a > b; });
+    for (uint32_t page : missing) {
+        if (uploads.size() >= maxUploads) break;
+        const uint32_t slot = acquireSlot();
+        if (slot == kNone) break;
+        slots_[slot].page = page;
+        slots_[slot].lastUsedFrame = frame_;
+        pageSlot_[page] = slot;
+        ++stats_.residentPages;
+        uploads.push_back(PageUpload{page, slot % pagesPerSide_, slot / pagesPerSide_});
+    }
+
+    stats_.requestedPages = static_cast<uint32_t>(requested.size());
+    stats_.pendingPages = static_cast<uint32_t>(missing.size() - uploads.size());
+    stats_.uploadsLastFrame = static_cast<uint32_t>(uploads.size());
+    stats_.uploadsTotal += uploads.size();
+    if (!uploads.empty()) rebuildPageTable();
+    return uploads;
+}
+
+void VirtualTextureCache::rebuildPageTable()
+{
+    // Coarsest level first so every parent entry is final before its children read it.
+    for (size_t levelIndex = levels_.size(); levelIndex-- > 0;) {
+        const core::image::TilePyramidLevel& level = levels_[levelIndex];
+        for (uint32_t ty = 0; ty < level.tilesY; ++ty) {
+            for (uint32_t tx = 0; tx < level.tilesX; ++tx) {
+                const uint32_t page = level.firstPage + ty * level.tilesX + tx;
+                const uint32_t slot = pageSlot_[page];
+                if (slot != kNone) {
+                    pageTable_[page] = (slot % pagesPerSide_) | ((slot / pagesPerSide_) << 8) | (static_cast<uint32_t>(levelIndex) << 16);
+                } else {
+                    const uint32_t parent = parentPage(page);
+                    pageTable_[page] = (parent != kNone) ? pageTable_[parent] : 0U;
+                }
+            }
+        }
+    }
+}
+
+} // namespace core::runtime
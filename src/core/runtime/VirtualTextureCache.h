@@ -0,0 +1,70 @@
+#pragma once
+
+#include "core/image/TilePyramid.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace core::runtime {
+
+struct VirtualTextureStats {
+    uint32_t capacityPages = 0;
+    uint32_t residentPages = 0;
+    uint32_t requestedPages = 0;
+    uint32_t pendingPages = 0;
+    uint32_t uploadsLastFrame = 0;
+    uint64_t uploadsTotal = 0;
+    uint64_t evictionsTotal = 0;
+};
+
+// CPU side of the virtual texture: which pyramid pages sit in which physical cache slot, and the
+// page table the shader reads. Each page table entry names the finest resident page covering
+// that virtual page (itself or an ancestor), so every lookup resolves to something drawable:
+//   bits 0-7 slot x, bits 8-15 slot y, bits 16-23 level of the resident page.
+// The coarsest level is a single page, loaded first and never evicted.
+class VirtualTextureCache {
+public:
+    struct PageUpload {
+        uint32_t page = 0;
+        uint32_t slotX = 0;
+        uint32_t slotY = 0;
+    };
+
+    void reset(const core::image::TilePyramid& pyramid, uint32_t pagesPerSide);
+
+    // requestedBits is the feedback bitset (bit N set = global page N was sampled). Requested
+    // pages and their ancestors are marked used; missing ones are assigned slots, coarse levels
+    // first, evicting least recently used pages. At most maxUploads pages are returned for
+    // upload this frame; the rest stay pending and are requested again by later feedback.
+    std::vector<PageUpload> update(std::span<const uint32_t> requestedBits, uint32_t maxUploads);
+
+    uint32_t pagesPerSide() const { return pagesPerSide_; }
+    const std::vector<uint32_t>& pageTable() const { return pageTable_; }
+    const VirtualTextureStats& stats() const { return stats_; }
+
+private:
+    static constexpr uint32_t kNone = 0xFFFFFFFFU;
+
+    struct Slot {
+        uint32_t page = kNone;
+        uint64_t lastUsedFrame = 0;
+    };
+
+    uint32_t levelOfPage(uint32_t page) const;
+    uint32_t parentPage(uint32_t page) const;
+    uint32_t acquireSlot();
+    void rebuildPageTable();
+
+    std::vector<core::image::TilePyramidLevel> levels_{};
+    uint32_t pagesPerSide_ = 0;
+    uint32_t pinnedPage_ = kNone;
+    std::vector<uint32_t> pageSlot_{};
+    std::vector<Slot> slots_{};
+    std::vector<uint32_t> pageTable_{};
+    std::vector<uint8_t> requestedThisFrame_{};
+    uint64_t frame_ = 0;
+    VirtualTextureStats stats_{};
+};
+
+} // namespace core::runtime
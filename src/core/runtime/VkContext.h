@@ -19,6 +19,28 @@ struct VkContext {
         VkSampler sampler = VK_NULL_HANDLE;
     };
 
+    // Physical page cache plus the host-mapped buffers the virtual texture shader reads and
+    // writes. Always created (1x1 / minimal when no pyramid is loaded) so descriptors stay valid.
+    struct VirtualTextureResources {
+        TextureResource cache{};
+        uint32_t cacheSize = 0;
+        VkBuffer paramsBuffer = VK_NULL_HANDLE;
+        VkDeviceMemory paramsMemory = VK_NULL_HANDLE;
+        void* paramsMapped = nullptr;
+        VkBuffer pageTableBuffer = VK_NULL_HANDLE;
+        VkDeviceMemory pageTableMemory = VK_NULL_HANDLE;
+        VkDeviceSize pageTableSize = 0;
+        void* pageTableMapped = nullptr;
+        VkBuffer feedbackBuffer = VK_NULL_HANDLE;
+        VkDeviceMemory feedbackMemory = VK_NULL_HANDLE;
+        VkDeviceSize feedbackSize = 0;
+        void* feedbackMapped = nullptr;
+        VkBuffer stagingBuffer = VK_NULL_HANDLE;
+        VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
+        void* stagingMapped = nullptr;
+        bool active = false;
+    };
+
     GLFWwindow* window = nullptr;
 
     vkb::Instance instance{};
@@ -47,6 +69,7 @@ struct VkContext {
     VkImageView depthImageView = VK_NULL_HANDLE;
     VkFormat depthFormat = VK_FORMAT_UNDEFINED;
     std::vector<TextureResource> bindlessTextures{};
+    VirtualTextureResources virtualTexture{};
 
     VkBuffer vertexBuffer = VK_NULL_HANDLE;
     VkDeviceMemory vertexBufferMemory = VK_NULL_HANDLE;
@@ -58,6 +81,10 @@ struct VkContext {
     VkDeviceMemory objectUniformBufferMemory = VK_NULL_HANDLE;
     VkDeviceSize objectUniformStride = 0;
     uint32_t objectUniformCapacity = 0;
+    // World transforms of instanced scene draws (binding 7), indexed by gl_InstanceIndex.
+    VkBuffer sceneInstanceBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory sceneInstanceBufferMemory = VK_NULL_HANDLE;
+    uint32_t sceneInstanceCapacity = 0;
 
     VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
     VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
@@ -74,6 +101,8 @@ struct VkContext {
     VkPresentModeKHR selectedPresentMode = VK_PRESENT_MODE_FIFO_KHR;
     VkQueryPool gpuTimestampQueryPool = VK_NULL_HANDLE;
     bool gpuTimestampsSupported = false;
+    bool textureCompressionBC = false;
+    bool fragmentStoresAndAtomics = false;
     double timestampPeriodNs = 0.0;
     std::array<bool, kMaxFramesInFlight> gpuQueryValid{};
 };
@@ -5,8 +5,11 @@
 #include "core/features/globe/GlobeObject.h"
 #include "core/features/globe/GlobeControls.h"
 #include "core/SceneGraph.h"
+#include "core/image/TilePyramid.h"
 #include "core/runtime/UIObject.h"
+#include "core/runtime/VirtualTextureCache.h"
 #include "core/runtime/VkContext.h"
+#include "vkscene/MeshCache.h"
 #include "vkscene/Scene.h"
 #include "vkscene/RenderObject.h"
 
@@ -15,6 +18,7 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -28,6 +32,8 @@ public:
     void setEarthTexturePath(std::string path) { earthTexturePath_ = std::move(path); }
     void setSceneMode(bool enable) { sceneModeEnabled_ = enable; }
     void setSceneModelPath(std::string path) { sceneModelPath_ = std::move(path); }
+    void setSceneModelCache(vkscene::MeshCacheOptions options) { sceneModelCache_ = std::move(options); }
+    void setOptimizeSceneMeshes(bool enable) { optimizeSceneMeshes_ = enable; }
     uint32_t textureSlot(const std::string& name) const;
 
 private:
@@ -35,6 +41,11 @@ private:
     static constexpr uint32_t kWindowHeight = 720;
     static constexpr uint32_t kMaxBindlessTextures = 32;
     static constexpr uint32_t kMaxSceneObjects = 1024;
+    // 4 MiB of instance transforms.
+    static constexpr uint32_t kMaxSceneInstances = 65536;
+    // Physical page cache budget: 16x16 pages of 256+2 texels is ~68 MiB of RGBA8.
+    static constexpr uint32_t kVirtualTexturePagesPerSide = 16;
+    static constexpr uint32_t kVirtualTextureMaxUploadsPerFrame = 16;
 
     VkContext context_{};
 
@@ -52,11 +63,24 @@ private:
     std::string earthTexturePath_{};
     bool textureLoadedFromFile_ = false;
     std::string textureSourceLabel_ = "procedural";
+    core::image::TilePyramid virtualTexturePyramid_{};
+    VirtualTextureCache virtualTextureCache_{};
+    uint32_t virtualTextureFeedbackPhase_ = 0;
     std::vector<Vertex> sceneVertices_{};
     std::vector<uint32_t> sceneIndices_{};
     uint32_t sceneIndexCount_ = 0;
     bool sceneModeEnabled_ = false;
     std::string sceneModelPath_{};
+    vkscene::MeshCacheOptions sceneModelCache_{};
+    bool optimizeSceneMeshes_ = false;
+    // Scene rebuilds happen on every visibility toggle; an object's optimized mesh is reused for as
+    // long as the hash of its buildMesh output is unchanged.
+    struct OptimizedMesh {
+        uint64_t sourceHash = 0;
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+    };
+    std::unordered_map<const vkscene::RenderObject*, OptimizedMesh> optimizedSceneMeshes_{};
     vkscene::Scene scene_{};
     bool requestExit_ = false;
     struct SceneDrawItem {
@@ -65,12 +89,27 @@ private:
         uint32_t indexCount = 0;
         uint32_t objectUniformSlot = 0;
         uint32_t textureSlot = 0;
+        // Instanced items draw sceneInstanceNodes_[firstInstance, firstInstance + instanceCount)
+        // at their world transforms; model stays identity. 0 instances: one draw at model.
+        uint32_t firstInstance = 0;
+        uint32_t instanceCount = 0;
         glm::mat4 model{1.0f};
         vkscene::PrimitiveType primitive = vkscene::PrimitiveType::Triangles;
         std::string vertShader;
         std::string fragShader;
     };
     std::vector<SceneDrawItem> sceneDrawItems_{};
+    std::vector<SceneNodeId> sceneInstanceNodes_{};
+    // One mip level to upload; bytes may point into a mapped file.
+    struct TextureUploadLevel {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::span<const uint8_t> bytes{};
+    };
+    struct TextureFileRequest {
+        std::string name;
+        std::string path;
+    };
     std::unordered_map<std::string, VkPipeline> scenePipelineCache_{};
     std::unordered_map<std::string, uint32_t> bindlessTextureSlots_{};
     static std::string makeScenePipelineKey(vkscene::PrimitiveType primitive, const std::string& vertShader, const std::string& fragShader);
@@ -103,9 +142,21 @@ private:
     void createIndexBuffer();
     void createUniformBuffer();
     void createTextureResources();
-    VkContext::TextureResource createTextureResource(uint32_t width, uint32_t height, const std::vector<uint8_t>& pixels);
-    uint32_t registerBindlessTexture(const std::string& name, uint32_t width, uint32_t height, const std::vector<uint8_t>& pixels);
+    VkContext::TextureResource createTextureResource(uint32_t width, uint32_t height, std::span<const uint8_t> pixels);
+    VkContext::TextureResource createTextureResource(VkFormat format, std::span<const TextureUploadLevel> levels, bool blitMipChain = false);
+    VkContext::TextureResource recordTextureUpload(VkCommandBuffer commandBuffer, VkFormat format, VkBuffer stagingBuffer,
+                                                   std::span<const TextureUploadLevel> levels, std::span<const VkDeviceSize> levelOffsets,
+                                                   bool blitMipChain);
+    bool canBlitMipChain(VkFormat format) const;
+    uint32_t registerBindlessTexture(const std::string& name, uint32_t width, uint32_t height, std::span<const uint8_t> pixels);
+    uint32_t registerBindlessTexture(const std::string& name, VkFormat format, std::span<const TextureUploadLevel> levels, bool blitMipChain = false);
     uint32_t registerBindlessTextureFromFile(const std::string& name, const std::string& path);
+    std::vector<uint32_t> registerBindlessTexturesFromFiles(std::span<const TextureFileRequest> requests);
+    uint32_t registerBindlessTextureFromContainer(const std::string& name, const std::string& path);
+    uint32_t registerBindlessTextureFromPyramid(const std::string& name, const std::string& path);
+    void createVirtualTextureResources();
+    void updateVirtualTexture(VkCommandBuffer commandBuffer);
+    void destroyVirtualTextureResources();
     void createDescriptorPool();
     void createDescriptorSet();
     void createCommandBuffers();
@@ -113,8 +164,8 @@ private:
     void createSyncObjects();
     VkFormat findSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
     VkFormat findDepthFormat();
-    void createImage(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory);
-    VkImageView createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags);
+    void createImage(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory, uint32_t mipLevels = 1, VkImageCreateFlags flags = 0);
+    VkImageView createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t levelCount = 1);
     VkCommandBuffer beginSingleTimeCommands();
     void endSingleTimeCommands(VkCommandBuffer commandBuffer);
     void transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout);
@@ -123,6 +174,7 @@ private:
     void destroyTextureResources();
     void rebuildSceneMesh();
     void rebuildSceneModeMesh();
+    void optimizeSceneObjectMesh(const vkscene::RenderObject& obj, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
     void rebuildGlobeModeMesh();
     void rebuildGpuMeshBuffers();
     void initSceneSystems();
@@ -132,6 +184,7 @@ private:
     void processInput(float deltaSeconds);
     void updateUniformBuffer();
     void updateObjectUniformBuffer(float elapsedSeconds);
+    void updateSceneInstanceBuffer();
     glm::mat4 computeBaseRotation(float elapsedSeconds) const;
     void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex, float elapsedSeconds, size_t frameIndex);
     void recreateSwapchain();
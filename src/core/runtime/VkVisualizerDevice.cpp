@@ -64,6 +64,16 @@ void VkVisualizerApp::pickPhysicalDevice() {
     vkGetPhysicalDeviceProperties(context_.physicalDevice.physical_device, &properties);
     context_.gpuTimestampsSupported = properties.limits.timestampComputeAndGraphics == VK_TRUE;
     context_.timestampPeriodNs = static_cast<double>(properties.limits.timestampPeriod);
+
+    // Enabled when present so cooked BC1/BC7 textures upload as stored; otherwise they are
+    // decoded on the CPU at load time.
+    VkPhysicalDeviceFeatures supportedFeatures{};
+    vkGetPhysicalDeviceFeatures(context_.physicalDevice.physical_device, &supportedFeatures);
+    context_.textureCompressionBC = supportedFeatures.textureCompressionBC == VK_TRUE;
+    context_.physicalDevice.features.textureCompressionBC = supportedFeatures.textureCompressionBC;
+    // The virtual texture shader records page requests with atomics from the fragment stage.
+    context_.fragmentStoresAndAtomics = supportedFeatures.fragmentStoresAndAtomics == VK_TRUE;
+    context_.physicalDevice.features.fragmentStoresAndAtomics = supportedFeatures.fragmentStoresAndAtomics;
 }
 
 void VkVisualizerApp::createDevice() {
@@ -7,6 +7,7 @@
 #include <backends/imgui_impl_vulkan.h>
 #include <imgui.h>
 
+#include <algorithm>
 #include <array>
 #include <cstring>
 #include <stdexcept>
@@ -58,6 +59,19 @@ void VkVisualizerApp::updateObjectUniformBuffer(float elapsedSeconds)
     uploadToMemory(context_.objectUniformBufferMemory, packed.data(), packed.size());
 }
 
+void VkVisualizerApp::updateSceneInstanceBuffer()
+{
+    if (sceneInstanceNodes_.empty()) return;
+    const size_t count = std::min<size_t>(sceneInstanceNodes_.size(), context_.sceneInstanceCapacity);
+    std::vector<glm::mat4> transforms(count, glm::mat4(1.0f));
+    for (size_t i = 0; i < count; ++i) {
+        if (const SceneNode* node = sceneGraph_.find(sceneInstanceNodes_[i])) {
+            transforms[i] = node->worldTransform;
+        }
+    }
+    uploadToMemory(context_.sceneInstanceBufferMemory, transforms.data(), sizeof(glm::mat4) * transforms.size());
+}
+
 glm::mat4 VkVisualizerApp::computeBaseRotation(float elapsedSeconds) const {
     if (sceneModeEnabled_) {
         return glm::mat4(1.0f);
@@ -79,6 +93,7 @@ void VkVisualizerApp::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_
         vkCmdResetQueryPool(commandBuffer, context_.gpuTimestampQueryPool, queryStart, 2);
         vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, context_.gpuTimestampQueryPool, queryStart);
     }
+    updateVirtualTexture(commandBuffer);
 
     std::array<VkClearValue, 2> clearValues{};
     clearValues[0].color = {{0.04f, 0.05f, 0.08f, 1.0f}};
@@ -95,7 +110,11 @@ void VkVisualizerApp::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_
 
     vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, context_.pipeline);
+    VkPipeline globePipeline = context_.pipeline;
+    if (!sceneModeEnabled_ && context_.virtualTexture.active) {
+        globePipeline = getOrCreateScenePipeline(vkscene::PrimitiveType::Triangles, "cube.vert.spv", "earth_vt.frag.spv");
+    }
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, globePipeline);
 
     VkBuffer vertexBuffers[] = {context_.vertexBuffer};
     VkDeviceSize offsets[] = {0};
@@ -119,7 +138,7 @@ void VkVisualizerApp::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_
             const uint32_t dynamicOffset = static_cast<uint32_t>(item.objectUniformSlot * context_.objectUniformStride);
             vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, context_.pipelineLayout, 0, 1, &context_.descriptorSet, 1,
                                     &dynamicOffset);
-            vkCmdDrawIndexed(commandBuffer, item.indexCount, 1, item.firstIndex, 0, 0);
+            vkCmdDrawIndexed(commandBuffer, item.indexCount, std::max(item.instanceCount, 1U), item.firstIndex, 0, item.firstInstance);
         }
     }
 
@@ -127,6 +146,16 @@ void VkVisualizerApp::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_
 
     vkCmdEndRenderPass(commandBuffer);
 
+    if (context_.virtualTexture.active) {
+        // Make this frame's page requests visible to the host once the fence signals.
+        VkMemoryBarrier feedbackBarrier{};
+        feedbackBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        feedbackBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        feedbackBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &feedbackBarrier, 0, nullptr, 0,
+                             nullptr);
+    }
+
     if (context_.gpuTimestampQueryPool != VK_NULL_HANDLE) {
         vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, context_.gpuTimestampQueryPool, queryStart + 1);
     }
@@ -179,6 +208,7 @@ void VkVisualizerApp::drawFrame(float deltaSeconds, float elapsedSeconds) {
         sceneGraph_ = scene_.graph();
         ecs_ = scene_.ecs();
         for (auto& item : sceneDrawItems_) {
+            if (item.instanceCount > 0) continue;
             if (const SceneNode* node = sceneGraph_.find(item.nodeId)) {
                 item.model = node->worldTransform;
             }
@@ -202,6 +232,9 @@ void VkVisualizerApp::drawFrame(float deltaSeconds, float elapsedSeconds) {
         geometryChanged) {
         rebuildGpuMeshBuffers();
     }
+    if (context_.virtualTexture.active) {
+        ui_.drawVirtualTexturePanel(virtualTextureCache_.stats());
+    }
     if (requestExit_) {
         glfwSetWindowShouldClose(context_.window, GLFW_TRUE);
     }
@@ -210,6 +243,7 @@ void VkVisualizerApp::drawFrame(float deltaSeconds, float elapsedSeconds) {
 
     updateUniformBuffer();
     updateObjectUniformBuffer(elapsedSeconds);
+    updateSceneInstanceBuffer();
     recordCommandBuffer(context_.commandBuffers[imageIndex], imageIndex, elapsedSeconds, context_.currentFrame);
     context_.gpuQueryValid[context_.currentFrame] = (context_.gpuTimestampQueryPool != VK_NULL_HANDLE);
 
@@ -131,6 +131,7 @@ void VkVisualizerApp::initVulkan() {
     createIndexBuffer();
     createUniformBuffer();
     createTextureResources();
+    createVirtualTextureResources();
     createDescriptorPool();
     createDescriptorSet();
     createCommandBuffers();
@@ -314,7 +315,14 @@ void VkVisualizerApp::cleanup() {
     if (context_.objectUniformBufferMemory != VK_NULL_HANDLE) {
         vkFreeMemory(context_.device.device, context_.objectUniformBufferMemory, nullptr);
     }
+    if (context_.sceneInstanceBuffer != VK_NULL_HANDLE) {
+        vkDestroyBuffer(context_.device.device, context_.sceneInstanceBuffer, nullptr);
+    }
+    if (context_.sceneInstanceBufferMemory != VK_NULL_HANDLE) {
+        vkFreeMemory(context_.device.device, context_.sceneInstanceBufferMemory, nullptr);
+    }
     destroyTextureResources();
+    destroyVirtualTextureResources();
     if (context_.indexBuffer != VK_NULL_HANDLE) {
         vkDestroyBuffer(context_.device.device, context_.indexBuffer, nullptr);
     }
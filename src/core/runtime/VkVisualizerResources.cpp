@@ -1,27 +1,20 @@
 #include "core/runtime/VkVisualizerApp.h"
 
 #include "core/RenderTypes.h"
+#include "core/image/BlockCompression.h"
+#include "core/image/ImageFile.h"
+#include "core/image/ProceduralEarthTexture.h"
+#include "core/image/TextureContainer.h"
+#include "core/io/ContentHash.h"
+#include "core/mesh/MeshOptimize.h"
 #include "vkscene/BasicObjects.h"
 #include "vkscene/GltfModelObject.h"
 
-#if __has_include(<stb_image.h>)
-#define VKRAW_HAS_STB_IMAGE 1
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
-#else
-#define VKRAW_HAS_STB_IMAGE 0
-#endif
-
 #include <glm/glm.hpp>
-#include <glm/gtc/constants.hpp>
-
-#if defined(VKRAW_ENABLE_IMAGE_FILE_IO)
-#include <tiffio.h>
-#endif
 
 #include <algorithm>
 #include <array>
-#include <cctype>
+#include <chrono>
 #include <cmath>
 #include <cstring>
 #include <filesystem>
@@ -34,136 +27,6 @@ namespace core::runtime {
 
 namespace {
 
-struct LoadedImage
-{
-    uint32_t width = 0;
-    uint32_t height = 0;
-    std::vector<uint8_t> pixels{};
-};
-
-LoadedImage resizeRgbaNearest(const LoadedImage& src, uint32_t dstWidth, uint32_t dstHeight)
-{
-    LoadedImage dst{};
-    dst.width = std::max(1U, dstWidth);
-    dst.height = std::max(1U, dstHeight);
-    dst.pixels.resize(static_cast<size_t>(dst.width) * dst.height * 4U);
-    for (uint32_t y = 0; y < dst.height; ++y) {
-        const uint32_t sy = (static_cast<uint64_t>(y) * src.height) / dst.height;
-        for (uint32_t x = 0; x < dst.width; ++x) {
-            const uint32_t sx = (static_cast<uint64_t>(x) * src.width) / dst.width;
-            const size_t srcIndex = (static_cast<size_t>(sy) * src.width + sx) * 4U;
-            const size_t dstIndex = (static_cast<size_t>(y) * dst.width + x) * 4U;
-            dst.pixels[dstIndex + 0] = src.pixels[srcIndex + 0];
-            dst.pixels[dstIndex + 1] = src.pixels[srcIndex + 1];
-            dst.pixels[dstIndex + 2] = src.pixels[srcIndex + 2];
-            dst.pixels[dstIndex + 3] = src.pixels[srcIndex + 3];
-        }
-    }
-    return dst;
-}
-
-bool decodeStbImage(const std::string& path, LoadedImage& out)
-{
-#if !VKRAW_HAS_STB_IMAGE
-    (void)path;
-    (void)out;
-    return false;
-#else
-    int width = 0;
-    int height = 0;
-    int channels = 0;
-    stbi_uc* pixels = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
-    if (!pixels || width <= 0 || height <= 0) return false;
-    out.width = static_cast<uint32_t>(width);
-    out.height = static_cast<uint32_t>(height);
-    out.pixels.assign(pixels, pixels + (static_cast<size_t>(out.width) * out.height * 4U));
-    stbi_image_free(pixels);
-    return true;
-#endif
-}
-
-#if defined(VKRAW_ENABLE_IMAGE_FILE_IO)
-bool decodeTiff(const std::string& path, LoadedImage& out)
-{
-    TIFF* tif = TIFFOpen(path.c_str(), "r");
-    if (!tif) return false;
-
-    uint32_t width = 0;
-    uint32_t height = 0;
-    if (TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &width) != 1 || TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &height) != 1 || width == 0 ||
-        height == 0) {
-        TIFFClose(tif);
-        return false;
-    }
-
-    std::vector<uint32_t> rgba(static_cast<size_t>(width) * height);
-    const int ok = TIFFReadRGBAImageOriented(tif, width, height, rgba.data(), ORIENTATION_TOPLEFT, 0);
-    TIFFClose(tif);
-    if (ok != 1) return false;
-
-    out.width = width;
-    out.height = height;
-    out.pixels.resize(static_cast<size_t>(width) * height * 4U);
-    for (size_t i = 0; i < rgba.size(); ++i) {
-        const uint32_t pixel = rgba[i];
-        out.pixels[i * 4U + 0] = TIFFGetR(pixel);
-        out.pixels[i * 4U + 1] = TIFFGetG(pixel);
-        out.pixels[i * 4U + 2] = TIFFGetB(pixel);
-        out.pixels[i * 4U + 3] = TIFFGetA(pixel);
-    }
-    return true;
-}
-#endif
-
-bool loadTextureFromFile(const std::string& path, LoadedImage& out)
-{
-    if (path.empty()) return false;
-    const std::string ext = std::filesystem::path(path).extension().string();
-    std::string lowerExt = ext;
-    std::transform(lowerExt.begin(), lowerExt.end(), lowerExt.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-
-    if (lowerExt == ".jpg" || lowerExt == ".jpeg" || lowerExt == ".png") return decodeStbImage(path, out);
-#if defined(VKRAW_ENABLE_IMAGE_FILE_IO)
-    if (lowerExt == ".tif" || lowerExt == ".tiff") return decodeTiff(path, out);
-#endif
-    return false;
-}
-
-std::vector<uint8_t> makeProceduralEarthTexture(uint32_t width, uint32_t height)
-{
-    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4U, 255U);
-    for (uint32_t y = 0; y < height; ++y) {
-        const float v = static_cast<float>(y) / static_cast<float>(std::max(1U, height - 1U));
-        const float lat = (0.5f - v) * glm::pi<float>();
-        const float sinLat = std::sin(lat);
-        for (uint32_t x = 0; x < width; ++x) {
-            const float u = static_cast<float>(x) / static_cast<float>(std::max(1U, width - 1U));
-            const float lon = (u * 2.0f - 1.0f) * glm::pi<float>();
-
-            const float noiseA = std::sin(lon * 2.7f + 0.4f) * std::cos(lat * 3.3f - 0.1f);
-            const float noiseB = std::sin(lon * 8.4f - lat * 2.9f);
-            const float elevation = 0.62f * noiseA + 0.38f * noiseB;
-            const bool polar = std::abs(lat) > glm::radians(70.0f);
-            const bool land = (elevation + 0.25f * sinLat) > 0.08f;
-
-            glm::vec3 color = land ? glm::vec3(0.23f, 0.50f, 0.20f) : glm::vec3(0.06f, 0.18f, 0.45f);
-            if (land) {
-                color = glm::mix(color, glm::vec3(0.62f, 0.53f, 0.33f), std::clamp((elevation - 0.10f) * 0.9f, 0.0f, 1.0f));
-            }
-            if (polar) {
-                color = glm::mix(color, glm::vec3(0.92f, 0.95f, 0.98f), 0.85f);
-            }
-
-            const size_t index = (static_cast<size_t>(y) * width + x) * 4U;
-            pixels[index + 0] = static_cast<uint8_t>(std::clamp(color.r, 0.0f, 1.0f) * 255.0f);
-            pixels[index + 1] = static_cast<uint8_t>(std::clamp(color.g, 0.0f, 1.0f) * 255.0f);
-            pixels[index + 2] = static_cast<uint8_t>(std::clamp(color.b, 0.0f, 1.0f) * 255.0f);
-            pixels[index + 3] = 255;
-        }
-    }
-    return pixels;
-}
-
 std::vector<uint8_t> makeCheckerTexture(uint32_t width, uint32_t height)
 {
     std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4U, 255U);
@@ -182,6 +45,21 @@ std::vector<uint8_t> makeCheckerTexture(uint32_t width, uint32_t height)
     return pixels;
 }
 
+// The sRGB twin of an 8-bit UNORM color format. Mip chains are blitted on an image of this format
+// so the hardware linearizes before filtering, like the CPU chain (ResampleColorSpace::Srgb);
+// shaders still sample the bytes through a view of the original format.
+VkFormat srgbBlitFormat(VkFormat format)
+{
+    switch (format) {
+    case VK_FORMAT_R8G8B8A8_UNORM:
+        return VK_FORMAT_R8G8B8A8_SRGB;
+    case VK_FORMAT_B8G8R8A8_UNORM:
+        return VK_FORMAT_B8G8R8A8_SRGB;
+    default:
+        return VK_FORMAT_UNDEFINED;
+    }
+}
+
 } // namespace
 
 uint32_t VkVisualizerApp::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
@@ -267,6 +145,11 @@ void VkVisualizerApp::createUniformBuffer() {
     createBuffer(context_.objectUniformStride * context_.objectUniformCapacity, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, context_.objectUniformBuffer,
                  context_.objectUniformBufferMemory);
+
+    context_.sceneInstanceCapacity = kMaxSceneInstances;
+    createBuffer(sizeof(glm::mat4) * context_.sceneInstanceCapacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, context_.sceneInstanceBuffer,
+                 context_.sceneInstanceBufferMemory);
 }
 
 uint32_t VkVisualizerApp::textureSlot(const std::string& name) const
@@ -276,21 +159,81 @@ uint32_t VkVisualizerApp::textureSlot(const std::string& name) const
     return it->second;
 }
 
-VkContext::TextureResource VkVisualizerApp::createTextureResource(uint32_t width, uint32_t height, const std::vector<uint8_t>& pixels)
+VkContext::TextureResource VkVisualizerApp::createTextureResource(uint32_t width, uint32_t height, std::span<const uint8_t> pixels)
 {
-    VkContext::TextureResource out{};
-    const VkDeviceSize imageSize = static_cast<VkDeviceSize>(pixels.size());
+    const TextureUploadLevel level{width, height, pixels};
+    return createTextureResource(VK_FORMAT_R8G8B8A8_UNORM, std::span<const TextureUploadLevel>(&level, 1));
+}
+
+bool VkVisualizerApp::canBlitMipChain(VkFormat format) const
+{
+    const VkFormat blitFormat = srgbBlitFormat(format);
+    if (blitFormat == VK_FORMAT_UNDEFINED) return false;
+    VkFormatProperties formatProps{};
+    vkGetPhysicalDeviceFormatProperties(context_.physicalDevice.physical_device, blitFormat, &formatProps);
+    const VkFormatFeatureFlags required =
+        VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    return (formatProps.optimalTilingFeatures & required) == required;
+}
+
+VkContext::TextureResource VkVisualizerApp::createTextureResource(VkFormat format, std::span<const TextureUploadLevel> levels, bool blitMipChain)
+{
+    if (levels.empty()) {
+        throw std::runtime_error("failed to create texture: no levels");
+    }
+    // With blitMipChain only levels[0] is uploaded; the rest of the chain is blitted from it.
+    if (blitMipChain) levels = levels.first(1);
+
+    // All levels share one staging buffer; offsets stay 16-byte aligned for BCn block copies.
+    std::vector<VkDeviceSize> levelOffsets(levels.size());
+    VkDeviceSize stagingSize = 0;
+    for (size_t i = 0; i < levels.size(); ++i) {
+        levelOffsets[i] = stagingSize;
+        stagingSize = (stagingSize + static_cast<VkDeviceSize>(levels[i].bytes.size()) + 15U) & ~VkDeviceSize{15U};
+    }
 
     VkBuffer stagingBuffer = VK_NULL_HANDLE;
     VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
-    createBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+    createBuffer(stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
                  stagingBuffer, stagingMemory);
-    uploadToMemory(stagingMemory, pixels.data(), imageSize);
-
-    createImage(width, height, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, out.image, out.memory);
+    void* staging = nullptr;
+    vkMapMemory(context_.device.device, stagingMemory, 0, stagingSize, 0, &staging);
+    for (size_t i = 0; i < levels.size(); ++i) {
+        std::memcpy(static_cast<uint8_t*>(staging) + levelOffsets[i], levels[i].bytes.data(), levels[i].bytes.size());
+    }
+    vkUnmapMemory(context_.device.device, stagingMemory);
 
     VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+    const VkContext::TextureResource out = recordTextureUpload(commandBuffer, format, stagingBuffer, levels, levelOffsets, blitMipChain);
+    endSingleTimeCommands(commandBuffer);
+    vkDestroyBuffer(context_.device.device, stagingBuffer, nullptr);
+    vkFreeMemory(context_.device.device, stagingMemory, nullptr);
+    return out;
+}
+
+// Creates the image, view and sampler and records the copies, blits and layout transitions into
+// commandBuffer. The staging buffer must stay alive until commandBuffer has executed.
+VkContext::TextureResource VkVisualizerApp::recordTextureUpload(VkCommandBuffer commandBuffer, VkFormat format, VkBuffer stagingBuffer,
+                                                                std::span<const TextureUploadLevel> levels, std::span<const VkDeviceSize> levelOffsets,
+                                                                bool blitMipChain)
+{
+    VkContext::TextureResource out{};
+    uint32_t levelCount = static_cast<uint32_t>(levels.size());
+    if (blitMipChain) {
+        for (uint32_t size = std::max(levels[0].width, levels[0].height); size > 1U; size /= 2U) ++levelCount;
+    }
+    const uint32_t uploadedLevels = static_cast<uint32_t>(levels.size());
+
+    VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    VkFormat imageFormat = format;
+    VkImageCreateFlags imageFlags = 0;
+    if (blitMipChain) {
+        usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        imageFormat = srgbBlitFormat(format);
+        imageFlags = VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT;
+    }
+    createImage(levels[0].width, levels[0].height, imageFormat, VK_IMAGE_TILING_OPTIMAL, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, out.image,
+                out.memory, levelCount, imageFlags);
 
     VkImageMemoryBarrier toTransferBarrier{};
     toTransferBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -301,7 +244,7 @@ VkContext::TextureResource VkVisualizerApp::createTextureResource(uint32_t width
     toTransferBarrier.image = out.image;
     toTransferBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     toTransferBarrier.subresourceRange.baseMipLevel = 0;
-    toTransferBarrier.subresourceRange.levelCount = 1;
+    toTransferBarrier.subresourceRange.levelCount = levelCount;
     toTransferBarrier.subresourceRange.baseArrayLayer = 0;
     toTransferBarrier.subresourceRange.layerCount = 1;
     toTransferBarrier.srcAccessMask = 0;
@@ -309,17 +252,63 @@ VkContext::TextureResource VkVisualizerApp::createTextureResource(uint32_t width
     vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1,
                          &toTransferBarrier);
 
-    VkBufferImageCopy region{};
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = 1;
-    region.imageOffset = {0, 0, 0};
-    region.imageExtent = {width, height, 1};
-    vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, out.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+    std::vector<VkBufferImageCopy> regions(levels.size());
+    for (uint32_t level = 0; level < uploadedLevels; ++level) {
+        VkBufferImageCopy& region = regions[level];
+        region.bufferOffset = levelOffsets[level];
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = level;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = {0, 0, 0};
+        region.imageExtent = {levels[level].width, levels[level].height, 1};
+    }
+    vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, out.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, uploadedLevels, regions.data());
+
+    // Each level is blitted from the one above it, which then moves to shader-read; the barrier
+    // below finishes the last level. The image has the sRGB format here, so the blit filters in
+    // linear light.
+    uint32_t pendingLevel = 0;
+    int32_t mipWidth = static_cast<int32_t>(levels[0].width);
+    int32_t mipHeight = static_cast<int32_t>(levels[0].height);
+    for (uint32_t level = 1; blitMipChain && level < levelCount; ++level) {
+        VkImageMemoryBarrier toSourceBarrier{};
+        toSourceBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        toSourceBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        toSourceBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        toSourceBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        toSourceBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        toSourceBarrier.image = out.image;
+        toSourceBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, level - 1U, 1, 0, 1};
+        toSourceBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        toSourceBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1,
+                             &toSourceBarrier);
+
+        const int32_t nextWidth = std::max(1, mipWidth / 2);
+        const int32_t nextHeight = std::max(1, mipHeight / 2);
+        VkImageBlit blit{};
+        blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - 1U, 0, 1};
+        blit.srcOffsets[1] = {mipWidth, mipHeight, 1};
+        blit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1};
+        blit.dstOffsets[1] = {nextWidth, nextHeight, 1};
+        vkCmdBlitImage(commandBuffer, out.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, out.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit,
+                       VK_FILTER_LINEAR);
+
+        VkImageMemoryBarrier doneBarrier = toSourceBarrier;
+        doneBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        doneBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        doneBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        doneBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1,
+                             &doneBarrier);
+
+        mipWidth = nextWidth;
+        mipHeight = nextHeight;
+        pendingLevel = level;
+    }
 
     VkImageMemoryBarrier toShaderReadBarrier{};
     toShaderReadBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -329,8 +318,8 @@ VkContext::TextureResource VkVisualizerApp::createTextureResource(uint32_t width
     toShaderReadBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     toShaderReadBarrier.image = out.image;
     toShaderReadBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    toShaderReadBarrier.subresourceRange.baseMipLevel = 0;
-    toShaderReadBarrier.subresourceRange.levelCount = 1;
+    toShaderReadBarrier.subresourceRange.baseMipLevel = pendingLevel;
+    toShaderReadBarrier.subresourceRange.levelCount = levelCount - pendingLevel;
     toShaderReadBarrier.subresourceRange.baseArrayLayer = 0;
     toShaderReadBarrier.subresourceRange.layerCount = 1;
     toShaderReadBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
@@ -338,12 +327,7 @@ VkContext::TextureResource VkVisualizerApp::createTextureResource(uint32_t width
     vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1,
                          &toShaderReadBarrier);
 
-    endSingleTimeCommands(commandBuffer);
-
-    vkDestroyBuffer(context_.device.device, stagingBuffer, nullptr);
-    vkFreeMemory(context_.device.device, stagingMemory, nullptr);
-
-    out.view = createImageView(out.image, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_ASPECT_COLOR_BIT);
+    out.view = createImageView(out.image, format, VK_IMAGE_ASPECT_COLOR_BIT, levelCount);
 
     VkSamplerCreateInfo samplerInfo{};
     samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
@@ -359,47 +343,94 @@ VkContext::TextureResource VkVisualizerApp::createTextureResource(uint32_t width
     samplerInfo.compareEnable = VK_FALSE;
     samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
     samplerInfo.minLod = 0.0f;
-    samplerInfo.maxLod = 0.0f;
+    samplerInfo.maxLod = static_cast<float>(levelCount - 1U);
     if (vkCreateSampler(context_.device.device, &samplerInfo, nullptr, &out.sampler) != VK_SUCCESS) {
         throw std::runtime_error("failed to create texture sampler");
     }
     return out;
 }
 
-uint32_t VkVisualizerApp::registerBindlessTexture(const std::string& name, uint32_t width, uint32_t height, const std::vector<uint8_t>& pixels)
+uint32_t VkVisualizerApp::registerBindlessTexture(const std::string& name, uint32_t width, uint32_t height, std::span<const uint8_t> pixels)
+{
+    const TextureUploadLevel level{width, height, pixels};
+    return registerBindlessTexture(name, VK_FORMAT_R8G8B8A8_UNORM, std::span<const TextureUploadLevel>(&level, 1));
+}
+
+uint32_t VkVisualizerApp::registerBindlessTexture(const std::string& name, VkFormat format, std::span<const TextureUploadLevel> levels, bool blitMipChain)
 {
     const auto existing = bindlessTextureSlots_.find(name);
     if (existing != bindlessTextureSlots_.end()) return existing->second;
     if (context_.bindlessTextures.size() >= kMaxBindlessTextures) return kMaxBindlessTextures;
 
     const uint32_t slot = static_cast<uint32_t>(context_.bindlessTextures.size());
-    context_.bindlessTextures.push_back(createTextureResource(width, height, pixels));
+    context_.bindlessTextures.push_back(createTextureResource(format, levels, blitMipChain));
     bindlessTextureSlots_[name] = slot;
     return slot;
 }
 
 uint32_t VkVisualizerApp::registerBindlessTextureFromFile(const std::string& name, const std::string& path)
 {
-    LoadedImage image{};
-    if (!loadTextureFromFile(path, image)) return kMaxBindlessTextures;
+    const TextureFileRequest request{name, path};
+    return registerBindlessTexturesFromFiles(std::span<const TextureFileRequest>(&request, 1)).front();
+}
 
+uint32_t VkVisualizerApp::registerBindlessTextureFromContainer(const std::string& name, const std::string& path)
+{
+    core::image::TextureContainer container;
+    if (!container.open(path)) return kMaxBindlessTextures;
+
+    // Levels larger than the device limit are dropped; the rest of the chain is already cooked.
     VkPhysicalDeviceProperties props{};
     vkGetPhysicalDeviceProperties(context_.physicalDevice.physical_device, &props);
-    if (image.width > props.limits.maxImageDimension2D || image.height > props.limits.maxImageDimension2D) {
-        const float scaleW = static_cast<float>(props.limits.maxImageDimension2D) / static_cast<float>(image.width);
-        const float scaleH = static_cast<float>(props.limits.maxImageDimension2D) / static_cast<float>(image.height);
-        const float scale = std::min(scaleW, scaleH);
-        const uint32_t newWidth = std::max(1U, static_cast<uint32_t>(std::floor(image.width * scale)));
-        const uint32_t newHeight = std::max(1U, static_cast<uint32_t>(std::floor(image.height * scale)));
-        image = resizeRgbaNearest(image, newWidth, newHeight);
+    const uint32_t maxDimension = props.limits.maxImageDimension2D;
+    uint32_t firstLevel = 0;
+    while (firstLevel < container.levelCount() &&
+           (container.level(firstLevel).width > maxDimension || container.level(firstLevel).height > maxDimension)) {
+        ++firstLevel;
+    }
+    if (firstLevel == container.levelCount()) return kMaxBindlessTextures;
+
+    VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
+    if (container.codec() == core::image::TextureCodec::Bc1) format = VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+    if (container.codec() == core::image::TextureCodec::Bc7) format = VK_FORMAT_BC7_UNORM_BLOCK;
+
+    bool uploadAsStored = (container.codec() == core::image::TextureCodec::Rgba8);
+    if (!uploadAsStored && context_.textureCompressionBC) {
+        VkFormatProperties formatProps{};
+        vkGetPhysicalDeviceFormatProperties(context_.physicalDevice.physical_device, format, &formatProps);
+        uploadAsStored = (formatProps.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
+    }
+
+    std::vector<TextureUploadLevel> levels;
+    std::vector<std::vector<uint8_t>> decodedLevels;
+    decodedLevels.reserve(container.levelCount());
+    for (uint32_t i = firstLevel; i < container.levelCount(); ++i) {
+        const core::image::TextureLevel& level = container.level(i);
+        if (uploadAsStored) {
+            levels.push_back(TextureUploadLevel{level.width, level.height, container.levelData(i)});
+            continue;
+        }
+        std::vector<uint8_t>& rgba = decodedLevels.emplace_back(static_cast<size_t>(level.width) * level.height * 4U);
+        if (container.codec() == core::image::TextureCodec::Bc1) {
+            core::image::decodeBc1(container.levelData(i).data(), level.width, level.height, rgba.data());
+        } else {
+            core::image::decodeBc7(container.levelData(i).data(), level.width, level.height, rgba.data());
+        }
+        levels.push_back(TextureUploadLevel{level.width, level.height, rgba});
     }
-    return registerBindlessTexture(name, image.width, image.height, image.pixels);
+    if (!uploadAsStored) {
+        std::cerr << "warning: " << core::image::textureCodecName(container.codec())
+                  << " textures are not supported by this device, decoding '" << path << "' on the CPU\n";
+        format = VK_FORMAT_R8G8B8A8_UNORM;
+    }
+    return registerBindlessTexture(name, format, levels);
 }
 
 void VkVisualizerApp::createTextureResources() {
     context_.bindlessTextures.clear();
     bindlessTextureSlots_.clear();
     textureLoadedFromFile_ = false;
+    virtualTexturePyramid_.close();
 
     textureSourceLabel_ = "procedural";
     uint32_t earthSlot = kMaxBindlessTextures;
@@ -410,19 +441,15 @@ void VkVisualizerApp::createTextureResources() {
     if (earthSlot == kMaxBindlessTextures) {
         if (!earthTexturePath_.empty()) {
             std::cerr << "Failed to load earth texture at '" << earthTexturePath_
-                      << "' (supported formats: .jpg/.jpeg/.png"
-#if defined(VKRAW_ENABLE_IMAGE_FILE_IO)
-                      << "/.tif/.tiff"
-#endif
-#if !VKRAW_HAS_STB_IMAGE
-                      << "; stb_image missing in this build"
-#endif
+                      << "' (supported formats: .vktx/.vktp/" << core::image::supportedImageFileFormats()
                       << "), using procedural fallback texture.\n";
         }
-        constexpr uint32_t kTextureWidth = 1024;
-        constexpr uint32_t kTextureHeight = 512;
-        const std::vector<uint8_t> pixels = makeProceduralEarthTexture(kTextureWidth, kTextureHeight);
-        earthSlot = registerBindlessTexture("earth", kTextureWidth, kTextureHeight, pixels);
+        const core::image::ProceduralEarthParams params{core::image::ProceduralEarthStyle::Classic, 1024, 512};
+        const core::image::ProceduralEarthImage earth = core::image::loadOrGenerateProceduralEarth(params, core::image::kProceduralCacheDir);
+        earthSlot = registerBindlessTexture("earth", earth.width(), earth.height(), earth.bytes());
+        if (earth.fromCache()) textureSourceLabel_ = "procedural:cached";
+    } else if (virtualTexturePyramid_.isOpen()) {
+        textureSourceLabel_ = "virtual:" + earthTexturePath_;
     } else {
         textureSourceLabel_ = "file:" + earthTexturePath_;
     }
@@ -435,13 +462,15 @@ void VkVisualizerApp::createTextureResources() {
 }
 
 void VkVisualizerApp::createDescriptorPool() {
-    std::array<VkDescriptorPoolSize, 3> poolSizes{};
+    std::array<VkDescriptorPoolSize, 4> poolSizes{};
     poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSizes[0].descriptorCount = 1;
+    poolSizes[0].descriptorCount = 2;
     poolSizes[1].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     poolSizes[1].descriptorCount = 1;
     poolSizes[2].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[2].descriptorCount = kMaxBindlessTextures;
+    poolSizes[2].descriptorCount = kMaxBindlessTextures + 1U;
+    poolSizes[3].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[3].descriptorCount = 3;
 
     VkDescriptorPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
@@ -513,7 +542,44 @@ void VkVisualizerApp::createDescriptorSet() {
     textureWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
     textureWrite.pImageInfo = imageInfos.data();
 
-    const std::array<VkWriteDescriptorSet, 3> writes{globalUboWrite, objectUboWrite, textureWrite};
+    const VkContext::VirtualTextureResources& vt = context_.virtualTexture;
+    VkDescriptorBufferInfo virtualParamsInfo{vt.paramsBuffer, 0, sizeof(core::VirtualTextureParams)};
+    VkDescriptorBufferInfo pageTableInfo{vt.pageTableBuffer, 0, vt.pageTableSize};
+    VkDescriptorBufferInfo feedbackInfo{vt.feedbackBuffer, 0, vt.feedbackSize};
+    VkDescriptorImageInfo pageCacheInfo{vt.cache.sampler, vt.cache.view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+
+    VkWriteDescriptorSet virtualParamsWrite{};
+    virtualParamsWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    virtualParamsWrite.dstSet = context_.descriptorSet;
+    virtualParamsWrite.dstBinding = 3;
+    virtualParamsWrite.descriptorCount = 1;
+    virtualParamsWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    virtualParamsWrite.pBufferInfo = &virtualParamsInfo;
+
+    VkWriteDescriptorSet pageTableWrite = virtualParamsWrite;
+    pageTableWrite.dstBinding = 4;
+    pageTableWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    pageTableWrite.pBufferInfo = &pageTableInfo;
+
+    VkWriteDescriptorSet feedbackWrite = pageTableWrite;
+    feedbackWrite.dstBinding = 5;
+    feedbackWrite.pBufferInfo = &feedbackInfo;
+
+    VkWriteDescriptorSet pageCacheWrite{};
+    pageCacheWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    pageCacheWrite.dstSet = context_.descriptorSet;
+    pageCacheWrite.dstBinding = 6;
+    pageCacheWrite.descriptorCount = 1;
+    pageCacheWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    pageCacheWrite.pImageInfo = &pageCacheInfo;
+
+    VkDescriptorBufferInfo sceneInstanceInfo{context_.sceneInstanceBuffer, 0, sizeof(glm::mat4) * context_.sceneInstanceCapacity};
+    VkWriteDescriptorSet sceneInstanceWrite = pageTableWrite;
+    sceneInstanceWrite.dstBinding = 7;
+    sceneInstanceWrite.pBufferInfo = &sceneInstanceInfo;
+
+    const std::array<VkWriteDescriptorSet, 8> writes{globalUboWrite, objectUboWrite, textureWrite,   virtualParamsWrite,
+                                                     pageTableWrite, feedbackWrite,  pageCacheWrite, sceneInstanceWrite};
     vkUpdateDescriptorSets(context_.device.device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
 }
 
@@ -593,14 +659,16 @@ VkFormat VkVisualizerApp::findDepthFormat() {
 }
 
 void VkVisualizerApp::createImage(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage,
-                 VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory) {
+                 VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory, uint32_t mipLevels,
+                 VkImageCreateFlags flags) {
     VkImageCreateInfo imageInfo{};
     imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.flags = flags;
     imageInfo.imageType = VK_IMAGE_TYPE_2D;
     imageInfo.extent.width = width;
     imageInfo.extent.height = height;
     imageInfo.extent.depth = 1;
-    imageInfo.mipLevels = 1;
+    imageInfo.mipLevels = mipLevels;
     imageInfo.arrayLayers = 1;
     imageInfo.format = format;
     imageInfo.tiling = tiling;
@@ -628,7 +696,7 @@ void VkVisualizerApp::createImage(uint32_t width, uint32_t height, VkFormat form
     vkBindImageMemory(context_.device.device, image, imageMemory, 0);
 }
 
-VkImageView VkVisualizerApp::createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags) {
+VkImageView VkVisualizerApp::createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t levelCount) {
     VkImageViewCreateInfo viewInfo{};
     viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
     viewInfo.image = image;
@@ -636,7 +704,7 @@ VkImageView VkVisualizerApp::createImageView(VkImage image, VkFormat format, VkI
     viewInfo.format = format;
     viewInfo.subresourceRange.aspectMask = aspectFlags;
     viewInfo.subresourceRange.baseMipLevel = 0;
-    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.levelCount = levelCount;
     viewInfo.subresourceRange.baseArrayLayer = 0;
     viewInfo.subresourceRange.layerCount = 1;
 
@@ -684,10 +752,19 @@ void VkVisualizerApp::endSingleTimeCommands(VkCommandBuffer commandBuffer) {
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &commandBuffer;
 
-    if (vkQueueSubmit(context_.graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+    // Wait on this submission only, not on everything else queued (vkQueueWaitIdle).
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    VkFence fence = VK_NULL_HANDLE;
+    if (vkCreateFence(context_.device.device, &fenceInfo, nullptr, &fence) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create temporary command fence");
+    }
+    if (vkQueueSubmit(context_.graphicsQueue, 1, &submitInfo, fence) != VK_SUCCESS) {
+        vkDestroyFence(context_.device.device, fence, nullptr);
         throw std::runtime_error("failed to submit temporary command buffer");
     }
-    vkQueueWaitIdle(context_.graphicsQueue);
+    vkWaitForFences(context_.device.device, 1, &fence, VK_TRUE, UINT64_MAX);
+    vkDestroyFence(context_.device.device, fence, nullptr);
     vkFreeCommandBuffers(context_.device.device, context_.commandPool, 1, &commandBuffer);
 }
 
@@ -775,7 +852,7 @@ void VkVisualizerApp::initSceneSystems()
             modelPath = "alien.glb";
         }
         if (!modelPath.empty()) {
-            auto model = std::make_shared<vkscene::GltfModelObject>(modelPath, textureSlot("checker"));
+            auto model = std::make_shared<vkscene::GltfModelObject>(modelPath, textureSlot("checker"), sceneModelCache_);
             if (model->loaded()) {
                 scene_.addObject(model, "SceneModel", scene_.rootNode());
             } else {
@@ -808,6 +885,7 @@ void VkVisualizerApp::rebuildSceneMesh() {
     sceneVertices_.clear();
     sceneIndices_.clear();
     sceneDrawItems_.clear();
+    sceneInstanceNodes_.clear();
     if (sceneModeEnabled_) {
         rebuildSceneModeMesh();
     } else {
@@ -830,6 +908,9 @@ void VkVisualizerApp::rebuildSceneModeMesh() {
         std::vector<Vertex> objectVertices;
         std::vector<uint32_t> objectIndices;
         obj->buildMesh(objectVertices, objectIndices);
+        if (optimizeSceneMeshes_ && obj->primitive() == vkscene::PrimitiveType::Triangles) {
+            optimizeSceneObjectMesh(*obj, objectVertices, objectIndices);
+        }
 
         const uint32_t baseVertex = static_cast<uint32_t>(sceneVertices_.size());
         const uint32_t firstIndex = static_cast<uint32_t>(sceneIndices_.size());
@@ -837,6 +918,42 @@ void VkVisualizerApp::rebuildSceneModeMesh() {
         for (uint32_t idx : objectIndices) {
             sceneIndices_.push_back(baseVertex + idx);
         }
+
+        // Objects with a node hierarchy get one instanced draw per mesh, covering every node that
+        // shows it; the meshes themselves are in the buffers once.
+        const std::span<const vkscene::MeshRange> meshRanges = obj->meshRanges();
+        const std::span<const vkscene::MeshInstance> meshInstances = scene_.meshInstances(nodeId);
+        if (!meshRanges.empty() && !meshInstances.empty()) {
+            std::vector<std::vector<SceneNodeId>> nodesByMesh(meshRanges.size());
+            for (const vkscene::MeshInstance& instance : meshInstances) {
+                if (instance.mesh < nodesByMesh.size()) nodesByMesh[instance.mesh].push_back(instance.node);
+            }
+            for (size_t mesh = 0; mesh < meshRanges.size(); ++mesh) {
+                const std::vector<SceneNodeId>& instanceNodes = nodesByMesh[mesh];
+                if (instanceNodes.empty() || meshRanges[mesh].indexCount == 0) continue;
+                if (sceneDrawItems_.size() >= kMaxSceneObjects || sceneInstanceNodes_.size() + instanceNodes.size() > kMaxSceneInstances) {
+                    std::cerr << "warning: scene exceeds " << kMaxSceneObjects << " draws or " << kMaxSceneInstances
+                              << " instances; dropping the rest of '" << node->name << "'\n";
+                    break;
+                }
+                sceneDrawItems_.push_back(SceneDrawItem{
+                    .nodeId = nodeId,
+                    .firstIndex = firstIndex + meshRanges[mesh].firstIndex,
+                    .indexCount = meshRanges[mesh].indexCount,
+                    .objectUniformSlot = static_cast<uint32_t>(sceneDrawItems_.size()),
+                    .textureSlot = obj->material().textureSlot % kMaxBindlessTextures,
+                    .firstInstance = static_cast<uint32_t>(sceneInstanceNodes_.size()),
+                    .instanceCount = static_cast<uint32_t>(instanceNodes.size()),
+                    .model = glm::mat4(1.0f),
+                    .primitive = obj->primitive(),
+                    .vertShader = "scene_instanced.vert.spv",
+                    .fragShader = obj->shaders().fragmentShaderSpv,
+                });
+                sceneInstanceNodes_.insert(sceneInstanceNodes_.end(), instanceNodes.begin(), instanceNodes.end());
+            }
+            continue;
+        }
+
         sceneDrawItems_.push_back(SceneDrawItem{
             .nodeId = nodeId,
             .firstIndex = firstIndex,
@@ -855,6 +972,30 @@ void VkVisualizerApp::rebuildSceneModeMesh() {
     sceneIndexCount_ = static_cast<uint32_t>(sceneIndices_.size());
 }
 
+void VkVisualizerApp::optimizeSceneObjectMesh(const vkscene::RenderObject& obj, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+    if (indices.empty()) return;
+    const std::span<const uint8_t> vertexBytes(reinterpret_cast<const uint8_t*>(vertices.data()), vertices.size() * sizeof(Vertex));
+    const std::span<const uint8_t> indexBytes(reinterpret_cast<const uint8_t*>(indices.data()), indices.size() * sizeof(uint32_t));
+    const uint64_t sourceHash = core::io::hashContent(indexBytes, core::io::hashContent(vertexBytes));
+    OptimizedMesh& optimized = optimizedSceneMeshes_[&obj];
+    if (optimized.sourceHash != sourceHash || optimized.indices.empty()) {
+        // Mesh ranges keep their offsets, so the instanced draws built from them stay valid.
+        std::vector<core::mesh::IndexRange> ranges;
+        for (const vkscene::MeshRange& range : obj.meshRanges()) ranges.push_back({range.firstIndex, range.indexCount});
+        if (ranges.empty()) ranges.push_back({0, static_cast<uint32_t>(indices.size() - indices.size() % 3)});
+
+        const auto start = std::chrono::steady_clock::now();
+        const core::mesh::MeshOptimizeStats stats = core::mesh::optimizeMesh(vertices, indices, ranges);
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "[MESH] optimize object=" << obj.name() << " vertices=" << stats.verticesBefore << "->" << stats.verticesAfter
+                  << " acmr=" << stats.before.acmr << "->" << stats.after.acmr << " atvr=" << stats.before.atvr << "->" << stats.after.atvr
+                  << " ms=" << ms << std::endl;
+        optimized = OptimizedMesh{sourceHash, std::move(vertices), std::move(indices)};
+    }
+    vertices = optimized.vertices;
+    indices = optimized.indices;
+}
+
 void VkVisualizerApp::rebuildGlobeModeMesh() {
     sceneGraph_.updateWorldTransforms();
     const SceneNode* globeNode = sceneGraph_.find(globeSceneNode_);
@@ -0,0 +1,208 @@
+#include "core/runtime/VkVisualizerApp.h"
+
+#include "core/ParallelFor.h"
+#include "core/image/ImageFile.h"
+#include "core/image/Resample.h"
+#include "core/image/TextureContainer.h"
+#include "core/image/TilePyramid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace core::runtime {
+
+namespace {
+
+// Staging memory shared by every texture of a batch. Textures are packed into it in request order;
+// when the next one does not fit, the pending uploads are submitted, their fence is waited on and
+// the buffer is reused from the start. A single texture larger than this gets a buffer of its size.
+constexpr VkDeviceSize kTextureStagingRingBytes = VkDeviceSize{256} * 1024U * 1024U;
+
+constexpr VkDeviceSize alignStaging(VkDeviceSize offset)
+{
+    // 16 bytes keeps every level offset valid for BCn block copies as well.
+    return (offset + 15U) & ~VkDeviceSize{15U};
+}
+
+struct PendingTexture {
+    size_t request = 0;
+    bool decoded = false;
+    // Streamed textures fit the device and get blitted mips; they are only sized up front and
+    // decoded straight into staging memory. The others carry their CPU-built levels.
+    bool streamed = false;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<core::image::RgbaImage> levels{};
+    std::vector<VkDeviceSize> levelOffsets{};
+    VkDeviceSize stagingBytes = 0;
+};
+
+} // namespace
+
+std::vector<uint32_t> VkVisualizerApp::registerBindlessTexturesFromFiles(std::span<const TextureFileRequest> requests)
+{
+    std::vector<uint32_t> slots(requests.size(), kMaxBindlessTextures);
+    std::vector<PendingTexture> pending;
+    std::unordered_set<std::string> queuedNames;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const TextureFileRequest& request = requests[i];
+        const auto existing = bindlessTextureSlots_.find(request.name);
+        if (existing != bindlessTextureSlots_.end()) {
+            slots[i] = existing->second;
+        } else if (core::image::isTextureContainerPath(request.path)) {
+            slots[i] = registerBindlessTextureFromContainer(request.name, request.path);
+        } else if (core::image::isTilePyramidPath(request.path)) {
+            slots[i] = registerBindlessTextureFromPyramid(request.name, request.path);
+        } else if (queuedNames.insert(request.name).second) {
+            pending.push_back(PendingTexture{.request = i});
+        }
+    }
+
+    VkPhysicalDeviceProperties props{};
+    vkGetPhysicalDeviceProperties(context_.physicalDevice.physical_device, &props);
+    const uint32_t maxDimension = props.limits.maxImageDimension2D;
+    const bool blitMipChain = canBlitMipChain(VK_FORMAT_R8G8B8A8_UNORM);
+
+    // Decode every file that cannot be streamed on its own thread, including the resample and the
+    // CPU mip chain; streamed files only have their headers read here.
+    core::parallelForBands(pending.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            PendingTexture& texture = pending[i];
+            const std::string& path = requests[texture.request].path;
+            if (blitMipChain && core::image::readImageFileSize(path, texture.width, texture.height) && texture.width <= maxDimension &&
+                texture.height <= maxDimension) {
+                texture.streamed = true;
+                texture.decoded = true;
+                continue;
+            }
+
+            core::image::RgbaImage image{};
+            if (!core::image::loadRgbaImageFile(path, image)) continue;
+            if (image.width > maxDimension || image.height > maxDimension) {
+                const float scale = std::min(static_cast<float>(maxDimension) / static_cast<float>(image.width),
+                                             static_cast<float>(maxDimension) / static_cast<float>(image.height));
+                const uint32_t newWidth = std::max(1U, static_cast<uint32_t>(std::floor(image.width * scale)));
+                const uint32_t newHeight = std::max(1U, static_cast<uint32_t>(std::floor(image.height * scale)));
+                image = core::image::resampleRgba(image, newWidth, newHeight, core::image::ResampleFilter::Lanczos3,
+                                                  core::image::ResampleColorSpace::Srgb);
+            }
+            texture.width = image.width;
+            texture.height = image.height;
+            std::vector<core::image::RgbaImage> mips;
+            if (!blitMipChain) mips = core::image::buildMipChain(image, core::image::ResampleFilter::Box, core::image::ResampleColorSpace::Srgb);
+            texture.levels.push_back(std::move(image));
+            for (core::image::RgbaImage& mip : mips) texture.levels.push_back(std::move(mip));
+            texture.decoded = true;
+        }
+    });
+
+    std::erase_if(pending, [](const PendingTexture& texture) { return !texture.decoded; });
+    if (pending.empty()) return slots;
+
+    VkDeviceSize largest = 0;
+    VkDeviceSize total = 0;
+    for (PendingTexture& texture : pending) {
+        if (texture.streamed) {
+            texture.levelOffsets.push_back(0);
+            texture.stagingBytes = alignStaging(static_cast<VkDeviceSize>(texture.width) * texture.height * 4U);
+        } else {
+            for (const core::image::RgbaImage& level : texture.levels) {
+                texture.levelOffsets.push_back(texture.stagingBytes);
+                texture.stagingBytes = alignStaging(texture.stagingBytes + static_cast<VkDeviceSize>(level.pixels.size()));
+            }
+        }
+        largest = std::max(largest, texture.stagingBytes);
+        total += texture.stagingBytes;
+    }
+
+    const VkDeviceSize stagingSize = std::min(total, std::max(kTextureStagingRingBytes, largest));
+    VkBuffer stagingBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
+    createBuffer(stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                 stagingBuffer, stagingMemory);
+    void* mapped = nullptr;
+    vkMapMemory(context_.device.device, stagingMemory, 0, stagingSize, 0, &mapped);
+    uint8_t* const staging = static_cast<uint8_t*>(mapped);
+
+    // Fills pending[begin, end) into staging from stagingOffsets in parallel, records all of their
+    // uploads into one command buffer and waits for it once.
+    std::vector<VkDeviceSize> stagingOffsets(pending.size());
+    auto flush = [&](size_t begin, size_t end) {
+        core::parallelForBands(end - begin, 1, [&](size_t bandBegin, size_t bandEnd) {
+            for (size_t i = begin + bandBegin; i < begin + bandEnd; ++i) {
+                PendingTexture& texture = pending[i];
+                uint8_t* const dst = staging + stagingOffsets[i];
+                if (texture.streamed) {
+                    const size_t bytes = static_cast<size_t>(texture.width) * texture.height * 4U;
+                    texture.decoded = core::image::decodeRgbaImageFileInto(requests[texture.request].path, texture.width, texture.height,
+                                                                           std::span<uint8_t>(dst, bytes));
+                    continue;
+                }
+                for (size_t level = 0; level < texture.levels.size(); ++level) {
+                    std::memcpy(dst + texture.levelOffsets[level], texture.levels[level].pixels.data(), texture.levels[level].pixels.size());
+                }
+            }
+        });
+
+        std::vector<std::pair<size_t, VkContext::TextureResource>> uploaded;
+        VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+        for (size_t i = begin; i < end; ++i) {
+            PendingTexture& texture = pending[i];
+            if (!texture.decoded) continue;
+            if (context_.bindlessTextures.size() + uploaded.size() >= kMaxBindlessTextures) break;
+
+            std::vector<TextureUploadLevel> levels;
+            std::vector<VkDeviceSize> offsets;
+            if (texture.streamed) {
+                // Only the extent is read from the level; its pixels are already in staging.
+                levels.push_back(TextureUploadLevel{texture.width, texture.height, {}});
+            } else {
+                for (const core::image::RgbaImage& level : texture.levels) {
+                    levels.push_back(TextureUploadLevel{level.width, level.height, level.pixels});
+                }
+            }
+            for (const VkDeviceSize offset : texture.levelOffsets) offsets.push_back(stagingOffsets[i] + offset);
+            uploaded.emplace_back(texture.request, recordTextureUpload(commandBuffer, VK_FORMAT_R8G8B8A8_UNORM, stagingBuffer, levels, offsets,
+                                                                       texture.streamed));
+        }
+        endSingleTimeCommands(commandBuffer);
+
+        for (auto& [request, resource] : uploaded) {
+            slots[request] = static_cast<uint32_t>(context_.bindlessTextures.size());
+            bindlessTextureSlots_[requests[request].name] = slots[request];
+            context_.bindlessTextures.push_back(resource);
+        }
+        for (size_t i = begin; i < end; ++i) pending[i].levels.clear();
+    };
+
+    size_t batchBegin = 0;
+    VkDeviceSize offset = 0;
+    for (size_t i = 0; i < pending.size(); ++i) {
+        if (offset + pending[i].stagingBytes > stagingSize) {
+            flush(batchBegin, i);
+            batchBegin = i;
+            offset = 0;
+        }
+        stagingOffsets[i] = offset;
+        offset += pending[i].stagingBytes;
+    }
+    flush(batchBegin, pending.size());
+
+    vkUnmapMemory(context_.device.device, stagingMemory);
+    vkDestroyBuffer(context_.device.device, stagingBuffer, nullptr);
+    vkFreeMemory(context_.device.device, stagingMemory, nullptr);
+
+    // Repeated names share the slot of their first occurrence.
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (slots[i] != kMaxBindlessTextures) continue;
+        const auto it = bindlessTextureSlots_.find(requests[i].name);
+        if (it != bindlessTextureSlots_.end()) slots[i] = it->second;
+    }
+    return slots;
+}
+
+} // namespace core::runtime
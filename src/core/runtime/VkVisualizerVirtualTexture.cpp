@@ -0,0 +1,204 @@
+#include "core/runtime/VkVisualizerApp.h"
+
+#include "core/ParallelFor.h"
+#include "core/RenderTypes.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+namespace core::runtime {
+
+uint32_t VkVisualizerApp::registerBindlessTextureFromPyramid(const std::string& name, const std::string& path) {
+    if (!virtualTexturePyramid_.open(path)) return kMaxBindlessTextures;
+
+    // The coarsest level is a single page. Its interior doubles as the ordinary bindless earth
+    // texture, used when the virtual texture path is unavailable.
+    const core::image::TilePyramidLevel& coarsest = virtualTexturePyramid_.level(virtualTexturePyramid_.levelCount() - 1U);
+    const uint32_t pagePixels = virtualTexturePyramid_.pagePixels();
+    const uint32_t border = virtualTexturePyramid_.border();
+    const std::span<const uint8_t> page = virtualTexturePyramid_.page(coarsest.firstPage);
+    std::vector<uint8_t> pixels(static_cast<size_t>(coarsest.width) * coarsest.height * 4U);
+    for (uint32_t y = 0; y < coarsest.height; ++y) {
+        const size_t srcOffset = (static_cast<size_t>(y + border) * pagePixels + border) * 4U;
+        std::memcpy(&pixels[static_cast<size_t>(y) * coarsest.width * 4U], page.data() + srcOffset, static_cast<size_t>(coarsest.width) * 4U);
+    }
+    return registerBindlessTexture(name, coarsest.width, coarsest.height, pixels);
+}
+
+void VkVisualizerApp::createVirtualTextureResources() {
+    VkContext::VirtualTextureResources& vt = context_.virtualTexture;
+    vt = VkContext::VirtualTextureResources{};
+
+    auto createMappedBuffer = [this](VkDeviceSize size, VkBufferUsageFlags usage, VkBuffer& buffer, VkDeviceMemory& memory, void*& mapped) {
+        createBuffer(size, usage, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, buffer, memory);
+        if (vkMapMemory(context_.device.device, memory, 0, size, 0, &mapped) != VK_SUCCESS) {
+            throw std::runtime_error("failed to map virtual texture buffer");
+        }
+        std::memset(mapped, 0, static_cast<size_t>(size));
+    };
+
+    bool active = virtualTexturePyramid_.isOpen();
+    if (active && !context_.fragmentStoresAndAtomics) {
+        std::cerr << "warning: device lacks fragmentStoresAndAtomics, showing only the coarsest level of '" << earthTexturePath_ << "'\n";
+        active = false;
+    }
+    uint32_t pagesPerSide = 0;
+    if (active) {
+        VkPhysicalDeviceProperties props{};
+        vkGetPhysicalDeviceProperties(context_.physicalDevice.physical_device, &props);
+        // Page table entries hold 8-bit slot coordinates.
+        pagesPerSide = std::min({kVirtualTexturePagesPerSide, props.limits.maxImageDimension2D / virtualTexturePyramid_.pagePixels(), 256U});
+        active = pagesPerSide > 0;
+    }
+
+    const uint32_t pageCount = active ? virtualTexturePyramid_.pageCount() : 1U;
+    vt.pageTableSize = sizeof(uint32_t) * static_cast<VkDeviceSize>(pageCount);
+    vt.feedbackSize = sizeof(uint32_t) * static_cast<VkDeviceSize>((pageCount + 31U) / 32U);
+    createMappedBuffer(sizeof(core::VirtualTextureParams), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, vt.paramsBuffer, vt.paramsMemory, vt.paramsMapped);
+    createMappedBuffer(vt.pageTableSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, vt.pageTableBuffer, vt.pageTableMemory, vt.pageTableMapped);
+    createMappedBuffer(vt.feedbackSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, vt.feedbackBuffer, vt.feedbackMemory, vt.feedbackMapped);
+
+    if (!active) {
+        const std::array<uint8_t, 4> black{0, 0, 0, 255};
+        vt.cache = createTextureResource(1, 1, black);
+        vt.cacheSize = 1;
+        return;
+    }
+
+    const VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
+    vt.cacheSize = pagesPerSide * virtualTexturePyramid_.pagePixels();
+    createImage(vt.cacheSize, vt.cacheSize, format, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vt.cache.image, vt.cache.memory);
+    transitionImageLayout(vt.cache.image, format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    transitionImageLayout(vt.cache.image, format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    vt.cache.view = createImageView(vt.cache.image, format, VK_IMAGE_ASPECT_COLOR_BIT);
+
+    // Pages carry their own filtering apron, so the cache is a single level clamped at the edges.
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.maxAnisotropy = 1.0f;
+    samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.maxLod = 0.0f;
+    if (vkCreateSampler(context_.device.device, &samplerInfo, nullptr, &vt.cache.sampler) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create virtual texture sampler");
+    }
+
+    createMappedBuffer(static_cast<VkDeviceSize>(virtualTexturePyramid_.pageBytes()) * kVirtualTextureMaxUploadsPerFrame,
+                       VK_BUFFER_USAGE_TRANSFER_SRC_BIT, vt.stagingBuffer, vt.stagingMemory, vt.stagingMapped);
+
+    virtualTextureCache_.reset(virtualTexturePyramid_, pagesPerSide);
+    virtualTextureFeedbackPhase_ = 0;
+    vt.active = true;
+}
+
+void VkVisualizerApp::updateVirtualTexture(VkCommandBuffer commandBuffer) {
+    VkContext::VirtualTextureResources& vt = context_.virtualTexture;
+    if (!vt.active) return;
+
+    // drawFrame waited on the previous frame's fence, so its feedback writes are complete and the
+    // host-visible buffers are free to rewrite.
+    auto* feedback = static_cast<uint32_t*>(vt.feedbackMapped);
+    const std::span<const uint32_t> requested(feedback, static_cast<size_t>(vt.feedbackSize / sizeof(uint32_t)));
+    const std::vector<VirtualTextureCache::PageUpload> uploads = virtualTextureCache_.update(requested, kVirtualTextureMaxUploadsPerFrame);
+    std::memset(feedback, 0, static_cast<size_t>(vt.feedbackSize));
+
+    if (!uploads.empty()) {
+        const size_t pageBytes = virtualTexturePyramid_.pageBytes();
+        auto* staging = static_cast<uint8_t*>(vt.stagingMapped);
+        // Copying out of the mapping is where page faults hit the disk, so spread it out.
+        core::parallelForBands(uploads.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                std::memcpy(staging + i * pageBytes, virtualTexturePyramid_.page(uploads[i].page).data(), pageBytes);
+            }
+        });
+
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = vt.cache.image;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1,
+                             &barrier);
+
+        const uint32_t pagePixels = virtualTexturePyramid_.pagePixels();
+        std::vector<VkBufferImageCopy> regions(uploads.size());
+        for (size_t i = 0; i < uploads.size(); ++i) {
+            VkBufferImageCopy& region = regions[i];
+            region.bufferOffset = static_cast<VkDeviceSize>(i * pageBytes);
+            region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+            region.imageOffset = {static_cast<int32_t>(uploads[i].slotX * pagePixels), static_cast<int32_t>(uploads[i].slotY * pagePixels), 0};
+            region.imageExtent = {pagePixels, pagePixels, 1};
+        }
+        vkCmdCopyBufferToImage(commandBuffer, vt.stagingBuffer, vt.cache.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               static_cast<uint32_t>(regions.size()), regions.data());
+
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1,
+                             &barrier);
+
+        std::memcpy(vt.pageTableMapped, virtualTextureCache_.pageTable().data(), static_cast<size_t>(vt.pageTableSize));
+    }
+
+    core::VirtualTextureParams params{};
+    params.info = glm::uvec4(virtualTexturePyramid_.levelCount(), virtualTexturePyramid_.tileSize(), virtualTexturePyramid_.border(),
+                             virtualTextureCache_.pagesPerSide());
+    params.extent = glm::uvec4(virtualTexturePyramid_.width(), virtualTexturePyramid_.height(), vt.cacheSize, virtualTextureFeedbackPhase_);
+    for (uint32_t i = 0; i < virtualTexturePyramid_.levelCount() && i < params.levels.size(); ++i) {
+        const core::image::TilePyramidLevel& level = virtualTexturePyramid_.level(i);
+        params.levels[i] = glm::uvec4(level.width, level.height, level.tilesX, level.firstPage);
+    }
+    std::memcpy(vt.paramsMapped, &params, sizeof(params));
+
+    // Each frame one pixel of every 4x4 block reports its page; 16 frames cover the screen.
+    virtualTextureFeedbackPhase_ = (virtualTextureFeedbackPhase_ + 1U) & 15U;
+}
+
+void VkVisualizerApp::destroyVirtualTextureResources() {
+    VkContext::VirtualTextureResources& vt = context_.virtualTexture;
+    VkDevice device = context_.device.device;
+    auto destroyMappedBuffer = [device](VkBuffer& buffer, VkDeviceMemory& memory, void*& mapped) {
+        if (mapped != nullptr) {
+            vkUnmapMemory(device, memory);
+            mapped = nullptr;
+        }
+        if (buffer != VK_NULL_HANDLE) {
+            vkDestroyBuffer(device, buffer, nullptr);
+            buffer = VK_NULL_HANDLE;
+        }
+        if (memory != VK_NULL_HANDLE) {
+            vkFreeMemory(device, memory, nullptr);
+            memory = VK_NULL_HANDLE;
+        }
+    };
+    destroyMappedBuffer(vt.paramsBuffer, vt.paramsMemory, vt.paramsMapped);
+    destroyMappedBuffer(vt.pageTableBuffer, vt.pageTableMemory, vt.pageTableMapped);
+    destroyMappedBuffer(vt.feedbackBuffer, vt.feedbackMemory, vt.feedbackMapped);
+    destroyMappedBuffer(vt.stagingBuffer, vt.stagingMemory, vt.stagingMapped);
+
+    if (vt.cache.sampler != VK_NULL_HANDLE) vkDestroySampler(device, vt.cache.sampler, nullptr);
+    if (vt.cache.view != VK_NULL_HANDLE) vkDestroyImageView(device, vt.cache.view, nullptr);
+    if (vt.cache.image != VK_NULL_HANDLE) vkDestroyImage(device, vt.cache.image, nullptr);
+    if (vt.cache.memory != VK_NULL_HANDLE) vkFreeMemory(device, vt.cache.memory, nullptr);
+    vt = VkContext::VirtualTextureResources{};
+    virtualTexturePyramid_.close();
+}
+
+} // namespace core::runtime
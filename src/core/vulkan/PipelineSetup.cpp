@@ -47,7 +47,39 @@ void createDescriptorSetLayout(core::runtime::VkContext& context)
     textureBinding.descriptorCount = kMaxBindlessTextures;
     textureBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
-    const std::array<VkDescriptorSetLayoutBinding, 3> bindings{globalUboBinding, objectUboBinding, textureBinding};
+    // Virtual texture: parameters, page table, feedback bitset and the physical page cache.
+    VkDescriptorSetLayoutBinding virtualParamsBinding{};
+    virtualParamsBinding.binding = 3;
+    virtualParamsBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    virtualParamsBinding.descriptorCount = 1;
+    virtualParamsBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutBinding pageTableBinding{};
+    pageTableBinding.binding = 4;
+    pageTableBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    pageTableBinding.descriptorCount = 1;
+    pageTableBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutBinding feedbackBinding{};
+    feedbackBinding.binding = 5;
+    feedbackBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    feedbackBinding.descriptorCount = 1;
+    feedbackBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutBinding pageCacheBinding{};
+    pageCacheBinding.binding = 6;
+    pageCacheBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    pageCacheBinding.descriptorCount = 1;
+    pageCacheBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutBinding sceneInstanceBinding{};
+    sceneInstanceBinding.binding = 7;
+    sceneInstanceBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    sceneInstanceBinding.descriptorCount = 1;
+    sceneInstanceBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    const std::array<VkDescriptorSetLayoutBinding, 8> bindings{globalUboBinding, objectUboBinding, textureBinding,   virtualParamsBinding,
+                                                               pageTableBinding, feedbackBinding,  pageCacheBinding, sceneInstanceBinding};
     VkDescriptorSetLayoutCreateInfo layoutInfo{};
     layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
     layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
@@ -0,0 +1,566 @@
+#include "vkglobe/OsmProjection.h"
+#include "vkglobe/OsmTileKey.h"
+#include "vkglobe/OsmTileSource.h"
+#include "vkglobe/OsmTileStore.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+Offline OSM tile seeder: fetches every tile of a lat/lon bounding box, or of a polyline corridor
+with a buffer, over a zoom range into the tile store vkglobe reads (--osm-cache). Tiles already in
+the store are skipped, so an interrupted run (Ctrl-C flushes what was fetched) resumes where it
+stopped. Point --url at a self-hosted or local tile server; the public OpenStreetMap servers do
+not allow bulk downloads and are refused.
+*/
+
+namespace {
+
+// WGS84 mean meridional degree, for turning the corridor buffer into degrees.
+constexpr double kFeetPerDegreeLat = 364566.0;
+// One connection per thread; more than this only gets a tile server to throttle us.
+constexpr int kMaxThreads = 64;
+
+struct LatLon
+{
+    double latDeg = 0.0;
+    double lonDeg = 0.0;
+};
+
+std::atomic<bool> gInterrupted{false};
+
+void onInterrupt(int)
+{
+    gInterrupted = true;
+}
+
+void printHelp(const char* appName)
+{
+    std::cout << "Usage: " << appName << " (--bbox <s,w,n,e> | --corridor <lat,lon;lat,lon;...>) --zoom <min>-<max> [options]\n"
+              << "Options:\n"
+              << "  --help                    Show this help\n"
+              << "  --bbox <s,w,n,e>          Bounding box in degrees; w > e crosses the antimeridian\n"
+              << "  --corridor <points>       Polyline as lat,lon pairs separated by ';'\n"
+              << "  --buffer-ft <ft>          Corridor half-width (default 3000)\n"
+              << "  --zoom <min>-<max>        Zoom range within 0-22, e.g. 10-17 (a single zoom is allowed)\n"
+              << "  --url <template>          Tile URL with {z}/{x}/{y}; file:// or a local server\n"
+              << "  --cache <path>            Tile store directory (default cache/osm)\n"
+              << "  --threads <n>             Concurrent requests, 1-64 (default 4)\n"
+              << "  --rate <tiles/s>          Request rate cap across all threads (default 50, 0 = none)\n"
+              << "  --max-tiles <n>           Refuse to seed more tiles than this (default 10000000, 0 = no limit)\n"
+              << "  --dry-run                 Print the tile count per zoom and exit\n";
+}
+
+// Whole-string numbers only: rejects empty text, trailing garbage and values outside [minValue, maxValue].
+bool parseInt(const std::string& text, int minValue, int maxValue, int& out)
+{
+    char* end = nullptr;
+    errno = 0;
+    const long value = std::strtol(text.c_str(), &end, 10);
+    if (end == text.c_str() || *end != '\0' || errno == ERANGE || value < minValue || value > maxValue) return false;
+    out = static_cast<int>(value);
+    return true;
+}
+
+bool parseDouble(const std::string& text, double minValue, double maxValue, double& out)
+{
+    char* end = nullptr;
+    const double value = std::strtod(text.c_str(), &end);
+    if (end == text.c_str() || *end != '\0' || !std::isfinite(value) || value < minValue || value > maxValue) return false;
+    out = value;
+    return true;
+}
+
+// Zoom range "<min>-<max>" or a single zoom, each within [0, maxZoom].
+bool parseZoomRange(const std::string& text, int maxZoom, int& minOut, int& maxOut)
+{
+    const size_t split = text.find('-');
+    if (split == std::string::npos)
+    {
+        if (!parseInt(text, 0, maxZoom, minOut)) return false;
+        maxOut = minOut;
+        return true;
+    }
+    return parseInt(text.substr(0, split), 0, maxZoom, minOut) && parseInt(text.substr(split + 1), minOut, maxZoom, maxOut);
+}
+
+bool parseDoubles(const std::string& text, char separator, std::vector<double>& out)
+{
+    std::istringstream in(text);
+    std::string field;
+    while (std::getline(in, field, separator))
+    {
+        char* end = nullptr;
+        const double value = std::strtod(field.c_str(), &end);
+        if (end == field.c_str() || *end != '\0') return false;
+        out.push_back(value);
+    }
+    return true;
+}
+
+bool parseCorridor(const std::string& text, std::vector<LatLon>& out)
+{
+    std::istringstream in(text);
+    std::string point;
+    while (std::getline(in, point, ';'))
+    {
+        std::vector<double> values;
+        if (!parseDoubles(point, ',', values) || values.size() != 2) return false;
+        out.push_back(LatLon{values[0], values[1]});
+    }
+    return out.size() >= 2;
+}
+
+// Wraps lonDeg into [-180, 180).
+double wrapLon(double lonDeg)
+{
+    return lonDeg - 360.0 * std::floor((lonDeg + 180.0) / 360.0);
+}
+
+// Inclusive range of tile columns (or rows).
+struct Span
+{
+    int first = 0;
+    int last = 0;
+};
+
+// The tiles of one zoom as column spans per row, so they can be counted and walked without a key
+// per tile. A box has the same spans on every row; a corridor has its own spans per row.
+struct ZoomTiles
+{
+    int zoom = 0;
+    int firstRow = 0;
+    int rowCount = 0;
+    std::vector<Span> boxSpans;
+    std::vector<std::vector<Span>> rowSpans;
+
+    const std::vector<Span>& spans(int row) const { return rowSpans.empty() ? boxSpans : rowSpans[static_cast<size_t>(row - firstRow)]; }
+
+    uint64_t count() const
+    {
+        uint64_t total = 0;
+        for (int row = firstRow; row < firstRow + rowCount; ++row)
+        {
+            for (const Span& span : spans(row)) total += static_cast<uint64_t>(span.last - span.first + 1);
+        }
+        return total;
+    }
+};
+
+// Rows of zoom covering [south, north].
+Span boxRows(int zoom, double southDeg, double northDeg)
+{
+    const int tiles = vkglobe::tileCountForZoom(zoom);
+    return Span{std::clamp(static_cast<int>(std::floor(vkglobe::latToTileY(northDeg, zoom))), 0, tiles - 1),
+                std::clamp(static_cast<int>(std::floor(vkglobe::latToTileY(southDeg, zoom))), 0, tiles - 1)};
+}
+
+// Columns of zoom covering [west, east], in ascending order and split in two where the range
+// crosses the antimeridian. Longitudes may lie outside [-180, 180]; west > east crosses it too.
+std::vector<Span> boxColumns(int zoom, double westDeg, double eastDeg)
+{
+    const int tiles = vkglobe::tileCountForZoom(zoom);
+    const double spanDeg = eastDeg >= westDeg ? eastDeg - westDeg : eastDeg - westDeg + 360.0;
+    const int x0 = std::clamp(static_cast<int>(std::floor(vkglobe::lonToTileX(wrapLon(westDeg), zoom))), 0, tiles - 1);
+    const int x1 = std::clamp(static_cast<int>(std::floor(vkglobe::lonToTileX(wrapLon(eastDeg), zoom))), 0, tiles - 1);
+    const int columns = spanDeg >= 360.0 ? tiles : (x1 - x0 + tiles) % tiles + 1;
+    if (x0 + columns <= tiles) return {Span{x0, x0 + columns - 1}};
+    return {Span{0, x0 + columns - tiles - 1}, Span{x0, tiles - 1}};
+}
+
+// Sorts spans and merges the ones that overlap or touch.
+void mergeSpans(std::vector<Span>& spans)
+{
+    std::sort(spans.begin(), spans.end(), [](const Span& a, const Span& b) { return a.first < b.first; });
+    size_t merged = 0;
+    for (size_t i = 1; i < spans.size(); ++i)
+    {
+        if (spans[i].first <= spans[merged].last + 1)
+            spans[merged].last = std::max(spans[merged].last, spans[i].last);
+        else
+            spans[++merged] = spans[i];
+    }
+    if (!spans.empty()) spans.resize(merged + 1);
+}
+
+ZoomTiles boxTiles(int zoom, double southDeg, double westDeg, double northDeg, double eastDeg)
+{
+    const Span rows = boxRows(zoom, southDeg, northDeg);
+    ZoomTiles tiles;
+    tiles.zoom = zoom;
+    tiles.firstRow = rows.first;
+    tiles.rowCount = rows.last - rows.first + 1;
+    tiles.boxSpans = boxColumns(zoom, westDeg, eastDeg);
+    return tiles;
+}
+
+// Calls visit(rows, columns) for boxes of bufferFt around points spaced at most half a tile (or half
+// the buffer) apart along each segment, interpolated linearly in lat/lon. Segments take the shorter
+// way in longitude, so one whose ends straddle the antimeridian crosses it instead of circling the globe.
+template<typename Visit>
+void forEachCorridorBox(int zoom, const std::vector<LatLon>& points, double bufferFt, Visit&& visit)
+{
+    const double bufferLatDeg = bufferFt / kFeetPerDegreeLat;
+    const double tileDeg = 360.0 / vkglobe::tileCountForZoom(zoom);
+    const double stepDeg = std::max(1.0e-6, 0.5 * std::min(tileDeg, std::max(bufferLatDeg, 1.0e-6)));
+    for (size_t i = 0; i + 1 < points.size(); ++i)
+    {
+        const LatLon& a = points[i];
+        const LatLon& b = points[i + 1];
+        const double deltaLonDeg = wrapLon(b.lonDeg - a.lonDeg);
+        const int steps = std::max(1, static_cast<int>(std::ceil(std::max(std::abs(b.latDeg - a.latDeg), std::abs(deltaLonDeg)) / stepDeg)));
+        for (int s = 0; s <= steps; ++s)
+        {
+            const double t = static_cast<double>(s) / steps;
+            const double latDeg = a.latDeg + (b.latDeg - a.latDeg) * t;
+            const double lonDeg = wrapLon(a.lonDeg + deltaLonDeg * t);
+            const double bufferLonDeg = std::min(180.0, bufferLatDeg / std::max(0.01, std::cos(vkglobe::clampLat(latDeg) * 3.14159265358979323846 / 180.0)));
+            visit(boxRows(zoom, vkglobe::clampLat(latDeg - bufferLatDeg), vkglobe::clampLat(latDeg + bufferLatDeg)),
+                  boxColumns(zoom, lonDeg - bufferLonDeg, lonDeg + bufferLonDeg));
+        }
+    }
+}
+
+ZoomTiles corridorTiles(int zoom, const std::vector<LatLon>& points, double bufferFt)
+{
+    int firstRow = std::numeric_limits<int>::max();
+    int lastRow = std::numeric_limits<int>::min();
+    forEachCorridorBox(zoom, points, bufferFt, [&](const Span& rows, const std::vector<Span>&) {
+        firstRow = std::min(firstRow, rows.first);
+        lastRow = std::max(lastRow, rows.last);
+    });
+
+    ZoomTiles tiles;
+    tiles.zoom = zoom;
+    tiles.firstRow = firstRow;
+    tiles.rowCount = lastRow - firstRow + 1;
+    tiles.rowSpans.resize(static_cast<size_t>(tiles.rowCount));
+    forEachCorridorBox(zoom, points, bufferFt, [&](const Span& rows, const std::vector<Span>& columns) {
+        for (int row = rows.first; row <= rows.last; ++row)
+        {
+            std::vector<Span>& spans = tiles.rowSpans[static_cast<size_t>(row - firstRow)];
+            spans.insert(spans.end(), columns.begin(), columns.end());
+            // Neighbouring boxes mostly repeat the same columns; merging early keeps rows short.
+            if (spans.size() > 16) mergeSpans(spans);
+        }
+    });
+    for (std::vector<Span>& spans : tiles.rowSpans) mergeSpans(spans);
+    return tiles;
+}
+
+// Hands out the tiles of a zoom range to the worker threads, zoom by zoom and row by row, so an
+// interrupted run leaves whole rows behind rather than scattered tiles. Only the spans of the
+// current zoom are held.
+class TileCursor
+{
+public:
+    TileCursor(std::function<ZoomTiles(int)> cover, int minZoom, int maxZoom) :
+        cover_(std::move(cover)), nextZoom_(minZoom), maxZoom_(maxZoom)
+    {
+    }
+
+    bool next(vkglobe::TileKey& key)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (;;)
+        {
+            if (row_ < tiles_.firstRow + tiles_.rowCount)
+            {
+                const std::vector<Span>& spans = tiles_.spans(row_);
+                if (spanIndex_ < spans.size())
+                {
+                    const Span& span = spans[spanIndex_];
+                    if (span.first + column_ <= span.last)
+                    {
+                        key = vkglobe::TileKey{tiles_.zoom, span.first + column_++, row_};
+                        return true;
+                    }
+                    ++spanIndex_;
+                    column_ = 0;
+                    continue;
+                }
+                ++row_;
+                spanIndex_ = 0;
+                continue;
+            }
+            if (nextZoom_ > maxZoom_) return false;
+            tiles_ = cover_(nextZoom_++);
+            row_ = tiles_.firstRow;
+            spanIndex_ = 0;
+            column_ = 0;
+        }
+    }
+
+private:
+    const std::function<ZoomTiles(int)> cover_;
+    int nextZoom_;
+    const int maxZoom_;
+    std::mutex mutex_;
+    ZoomTiles tiles_;
+    int row_ = 0;
+    size_t spanIndex_ = 0;
+    int column_ = 0;
+};
+
+// Spaces requests at least 1/rate apart across all threads.
+class RateLimiter
+{
+public:
+    explicit RateLimiter(double tilesPerSecond) :
+        interval_(tilesPerSecond > 0.0 ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / tilesPerSecond))
+                                       : std::chrono::steady_clock::duration::zero())
+    {
+    }
+
+    void acquire()
+    {
+        if (interval_ == std::chrono::steady_clock::duration::zero()) return;
+        std::chrono::steady_clock::time_point slot;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            next_ = std::max(next_, std::chrono::steady_clock::now());
+            slot = next_;
+            next_ += interval_;
+        }
+        std::this_thread::sleep_until(slot);
+    }
+
+private:
+    const std::chrono::steady_clock::duration interval_;
+    std::mutex mutex_;
+    std::chrono::steady_clock::time_point next_{};
+};
+
+std::string formatDuration(double seconds)
+{
+    const int64_t total = static_cast<int64_t>(std::max(0.0, seconds));
+    std::ostringstream out;
+    if (total >= 3600) out << total / 3600 << "h";
+    if (total >= 60) out << (total / 60) % 60 << "m";
+    out << total % 60 << "s";
+    return out.str();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string bbox;
+    std::string corridor;
+    double bufferFt = 3000.0;
+    int minZoom = -1;
+    int maxZoom = -1;
+    std::string cachePath = "cache/osm";
+    vkglobe::TileSourceConfig sourceConfig{};
+    sourceConfig.urlTemplate.clear();
+    int threads = 4;
+    double rate = 50.0;
+    int maxTiles = 10000000;
+    bool dryRun = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const bool hasValue = (i + 1) < argc;
+        if (arg == "--help")
+        {
+            printHelp(argv[0]);
+            return EXIT_SUCCESS;
+        }
+        if (arg == "--bbox" && hasValue)
+            bbox = argv[++i];
+        else if (arg == "--corridor" && hasValue)
+            corridor = argv[++i];
+        else if (arg == "--buffer-ft" && hasValue)
+        {
+            if (!parseDouble(argv[++i], 0.0, 1.0e7, bufferFt))
+            {
+                std::cerr << "error: --buffer-ft expects a distance in feet, 0 or more\n";
+                return EXIT_FAILURE;
+            }
+        }
+        else if (arg == "--zoom" && hasValue)
+        {
+            if (!parseZoomRange(argv[++i], vkglobe::OsmTileStore::kMaxZoom, minZoom, maxZoom))
+            {
+                std::cerr << "error: --zoom expects <min>-<max> within 0-" << vkglobe::OsmTileStore::kMaxZoom << "\n";
+                return EXIT_FAILURE;
+            }
+        }
+        else if (arg == "--url" && hasValue)
+            sourceConfig.urlTemplate = argv[++i];
+        else if (arg == "--cache" && hasValue)
+            cachePath = argv[++i];
+        else if (arg == "--threads" && hasValue)
+        {
+            if (!parseInt(argv[++i], 1, kMaxThreads, threads))
+            {
+                std::cerr << "error: --threads expects a count within 1-" << kMaxThreads << "\n";
+                return EXIT_FAILURE;
+            }
+        }
+        else if (arg == "--rate" && hasValue)
+        {
+            if (!parseDouble(argv[++i], 0.0, 1.0e6, rate))
+            {
+                std::cerr << "error: --rate expects tiles per second, 0 or more\n";
+                return EXIT_FAILURE;
+            }
+        }
+        else if (arg == "--max-tiles" && hasValue)
+        {
+            if (!parseInt(argv[++i], 0, std::numeric_limits<int>::max(), maxTiles))
+            {
+                std::cerr << "error: --max-tiles expects a tile count, 0 or more\n";
+                return EXIT_FAILURE;
+            }
+        }
+        else if (arg == "--dry-run")
+            dryRun = true;
+        else
+        {
+            std::cerr << "error: unknown or incomplete option '" << arg << "'\n";
+            printHelp(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<double> box;
+    std::vector<LatLon> points;
+    if (bbox.empty() == corridor.empty())
+    {
+        std::cerr << "error: give exactly one of --bbox and --corridor\n";
+        return EXIT_FAILURE;
+    }
+    if (!bbox.empty() && (!parseDoubles(bbox, ',', box) || box.size() != 4 || box[0] > box[2]))
+    {
+        std::cerr << "error: --bbox expects south,west,north,east in degrees\n";
+        return EXIT_FAILURE;
+    }
+    if (!corridor.empty() && !parseCorridor(corridor, points))
+    {
+        std::cerr << "error: --corridor expects at least two lat,lon points separated by ';'\n";
+        return EXIT_FAILURE;
+    }
+    if (minZoom < 0)
+    {
+        std::cerr << "error: --zoom is required\n";
+        return EXIT_FAILURE;
+    }
+
+    const auto coverZoom = [&](int zoom) {
+        return box.empty() ? corridorTiles(zoom, points, bufferFt) : boxTiles(zoom, vkglobe::clampLat(box[0]), box[1], vkglobe::clampLat(box[2]), box[3]);
+    };
+    // Counted from the spans, so even a whole-world box at zoom 22 costs no more than its rows.
+    uint64_t totalTiles = 0;
+    for (int zoom = minZoom; zoom <= maxZoom; ++zoom)
+    {
+        const uint64_t zoomTiles = coverZoom(zoom).count();
+        std::cout << "[OSM] seed zoom=" << zoom << " tiles=" << zoomTiles << "\n";
+        totalTiles += zoomTiles;
+    }
+    std::cout << "[OSM] seed total_tiles=" << totalTiles << std::endl;
+    if (dryRun) return EXIT_SUCCESS;
+
+    if (maxTiles > 0 && totalTiles > static_cast<uint64_t>(maxTiles))
+    {
+        std::cerr << "error: " << totalTiles << " tiles is above --max-tiles " << maxTiles << "; narrow the area or zoom range, or raise the limit\n";
+        return EXIT_FAILURE;
+    }
+
+    if (sourceConfig.urlTemplate.empty())
+    {
+        std::cerr << "error: --url is required (a self-hosted or local tile server, or a file:// directory)\n";
+        return EXIT_FAILURE;
+    }
+    if (sourceConfig.urlTemplate.find("openstreetmap.org") != std::string::npos)
+    {
+        std::cerr << "error: the OpenStreetMap tile usage policy forbids bulk downloading from its servers; "
+                     "seed from a self-hosted or commercial tile server instead\n";
+        return EXIT_FAILURE;
+    }
+
+    vkglobe::OsmTileStore store(cachePath);
+    if (!store.isOpen()) return EXIT_FAILURE;
+    sourceConfig.maxConnectionsPerHost = threads;
+    const std::unique_ptr<vkglobe::TileSource> source = vkglobe::createOsmTileSource(sourceConfig);
+    RateLimiter limiter(rate);
+    std::signal(SIGINT, onInterrupt);
+
+    TileCursor cursor(coverZoom, minZoom, maxZoom);
+    std::atomic<size_t> fetched{0};
+    std::atomic<size_t> skipped{0};
+    std::atomic<size_t> failed{0};
+    std::atomic<uint64_t> bytes{0};
+    std::mutex failureMutex;
+    std::vector<std::string> failures;
+    std::vector<std::thread> workers;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < threads; ++i)
+    {
+        workers.emplace_back([&]() {
+            vkglobe::TileKey key;
+            while (!gInterrupted && cursor.next(key))
+            {
+                if (store.contains(key))
+                {
+                    ++skipped;
+                    continue;
+                }
+                limiter.acquire();
+                vkglobe::TileFetchResult result = source->fetch(key, {});
+                if (result.status != vkglobe::TileFetchResult::Status::Ok)
+                {
+                    ++failed;
+                    std::lock_guard<std::mutex> lock(failureMutex);
+                    std::ostringstream line;
+                    line << "z=" << key.z << " x=" << key.x << " y=" << key.y << ": " << result.error;
+                    failures.push_back(line.str());
+                    continue;
+                }
+                bytes += result.bytes.size();
+                store.put(key, result.bytes, result.validators);
+                ++fetched;
+            }
+        });
+    }
+
+    // Progress on one rewritten line, twice a second.
+    for (;;)
+    {
+        const size_t done = fetched + skipped + failed;
+        const bool finished = done >= totalTiles;
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const double tilesPerSecond = seconds > 0.0 ? static_cast<double>(fetched) / seconds : 0.0;
+        const uint64_t remaining = totalTiles - std::min<uint64_t>(done, totalTiles);
+        std::cout << "\r[OSM] seed " << done << "/" << totalTiles << " (" << (totalTiles == 0 ? 100.0 : 100.0 * static_cast<double>(done) / static_cast<double>(totalTiles))
+                  << "%) fetched=" << fetched << " skipped=" << skipped << " failed=" << failed << " tiles_per_s=" << tilesPerSecond
+                  << " eta=" << (tilesPerSecond > 0.0 ? formatDuration(static_cast<double>(remaining) / tilesPerSecond) : std::string("?")) << "    " << std::flush;
+        if (finished || gInterrupted) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
+    for (auto& worker : workers) worker.join();
+    store.flush();
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "\n[OSM] seed " << (gInterrupted ? "interrupted" : "done") << " store=" << cachePath << " fetched=" << fetched << " skipped=" << skipped
+              << " failed=" << failed << " mib=" << static_cast<double>(bytes) / (1024.0 * 1024.0) << " seconds=" << seconds
+              << " store_tiles=" << store.stats().tiles << std::endl;
+    for (size_t i = 0; i < std::min<size_t>(failures.size(), 20); ++i) std::cerr << "[OSM] failed " << failures[i] << "\n";
+    if (failures.size() > 20) std::cerr << "[OSM] ... and " << failures.size() - 20 << " more; rerun to retry them\n";
+    return failed == 0 && !gInterrupted ? EXIT_SUCCESS : EXIT_FAILURE;
+}
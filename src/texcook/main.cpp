@@ -0,0 +1,197 @@
+#include "core/ParallelFor.h"
+#include "core/image/ImageFile.h"
+#include "core/image/Resample.h"
+#include "core/image/TextureContainer.h"
+#include "core/image/TilePyramid.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+Offline texture cooker: decodes a source image once, builds the mip chain, block-compresses
+every level and writes a .vktx container that vkraw/vkScene map directly at startup
+(--earth-texture earth.vktx). With --pyramid it writes a tiled .vktp virtual texture instead, for
+imagery too large to keep resident.
+*/
+
+namespace {
+
+void printHelp(const char* appName)
+{
+    std::cout << "Usage: " << appName << " <input> [output.vktx|output.vktp] [options]\n"
+              << "Input formats: " << core::image::supportedImageFileFormats() << "\n"
+              << "Options:\n"
+              << "  --help                    Show this help\n"
+              << "  --codec <bc7|bc1|rgba8>   Level encoding (default bc7)\n"
+              << "  --no-mips                 Store level 0 only\n"
+              << "  --pyramid                 Write a tiled virtual texture pyramid (.vktp, RGBA8)\n"
+              << "  --tile-size <n>           Pyramid page size in texels (default 256)\n"
+              << "  --bench-resample          Time every resample filter on a synthetic image (no input needed)\n"
+              << "  --bench-size <w>x<h>      Benchmark image size (default 16384x8192)\n";
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Detailed enough that no filter can skip work: a fine checker over smooth gradients.
+core::image::RgbaImage makeBenchImage(uint32_t width, uint32_t height)
+{
+    core::image::RgbaImage image{};
+    image.width = width;
+    image.height = height;
+    image.pixels.resize(static_cast<size_t>(width) * height * 4U);
+    core::parallelForBands(height, 64, [&](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; ++y) {
+            for (size_t x = 0; x < width; ++x) {
+                uint8_t* p = &image.pixels[(y * width + x) * 4U];
+                p[0] = (((x >> 2) ^ (y >> 2)) & 1U) ? 230U : 20U;
+                p[1] = static_cast<uint8_t>((x * 255U) / width);
+                p[2] = static_cast<uint8_t>((y * 255U) / height);
+                p[3] = 255U;
+            }
+        }
+    });
+    return image;
+}
+
+int runResampleBenchmark(uint32_t width, uint32_t height)
+{
+    const core::image::RgbaImage source = makeBenchImage(width, height);
+    const double sourceMpix = static_cast<double>(width) * height * 1e-6;
+    for (core::image::ResampleFilter filter :
+         {core::image::ResampleFilter::Box, core::image::ResampleFilter::Triangle, core::image::ResampleFilter::Lanczos3}) {
+        for (core::image::ResampleColorSpace space : {core::image::ResampleColorSpace::Linear, core::image::ResampleColorSpace::Srgb}) {
+            const char* spaceName = (space == core::image::ResampleColorSpace::Srgb) ? "srgb" : "linear";
+            const auto halfStart = std::chrono::steady_clock::now();
+            const core::image::RgbaImage half = core::image::resampleRgba(source, width / 2U, height / 2U, filter, space);
+            const double halfSeconds = secondsSince(halfStart);
+
+            const auto chainStart = std::chrono::steady_clock::now();
+            const std::vector<core::image::RgbaImage> chain = core::image::buildMipChain(source, filter, space);
+            const double chainSeconds = secondsSince(chainStart);
+
+            std::cout << "[BENCH] texcook resample filter=" << core::image::resampleFilterName(filter) << " space=" << spaceName
+                      << " src=" << width << "x" << height << " half=" << half.width << "x" << half.height << " half_s=" << halfSeconds
+                      << " half_mpix_s=" << sourceMpix / halfSeconds << " mip_levels=" << chain.size() << " mips_s=" << chainSeconds
+                      << std::endl;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string inputPath;
+    std::string outputPath;
+    core::image::TextureCodec codec = core::image::TextureCodec::Bc7;
+    bool generateMips = true;
+    bool writePyramid = false;
+    uint32_t tileSize = 256;
+    bool benchResample = false;
+    uint32_t benchWidth = 16384;
+    uint32_t benchHeight = 8192;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--help") {
+            printHelp(argv[0]);
+            return EXIT_SUCCESS;
+        }
+        if (arg == "--codec" && (i + 1) < argc) {
+            const std::string name = argv[++i];
+            if (!core::image::parseTextureCodec(name, codec)) {
+                std::cerr << "error: unknown codec '" << name << "'\n";
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--no-mips") {
+            generateMips = false;
+        } else if (arg == "--bench-resample") {
+            benchResample = true;
+        } else if (arg == "--bench-size" && (i + 1) < argc) {
+            const std::string size = argv[++i];
+            const size_t split = size.find('x');
+            benchWidth = static_cast<uint32_t>(std::strtoul(size.c_str(), nullptr, 10));
+            benchHeight = (split == std::string::npos) ? 0U : static_cast<uint32_t>(std::strtoul(size.c_str() + split + 1, nullptr, 10));
+            if (benchWidth < 2U || benchHeight < 2U) {
+                std::cerr << "error: --bench-size expects <width>x<height>\n";
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--pyramid") {
+            writePyramid = true;
+        } else if (arg == "--tile-size" && (i + 1) < argc) {
+            tileSize = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            if (tileSize < 16U || tileSize > 4096U) {
+                std::cerr << "error: --tile-size must be between 16 and 4096\n";
+                return EXIT_FAILURE;
+            }
+        } else if (inputPath.empty()) {
+            inputPath = arg;
+        } else if (outputPath.empty()) {
+            outputPath = arg;
+        }
+    }
+    if (benchResample) {
+        return runResampleBenchmark(benchWidth, benchHeight);
+    }
+    if (inputPath.empty()) {
+        printHelp(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (outputPath.empty()) {
+        outputPath = std::filesystem::path(inputPath).replace_extension(writePyramid ? ".vktp" : ".vktx").string();
+    }
+
+    const auto decodeStart = std::chrono::steady_clock::now();
+    core::image::RgbaImage source{};
+    if (!core::image::loadRgbaImageFile(inputPath, source)) {
+        std::cerr << "error: failed to decode '" << inputPath << "' (supported formats: " << core::image::supportedImageFileFormats() << ")\n";
+        return EXIT_FAILURE;
+    }
+    const double decodeSeconds = secondsSince(decodeStart);
+
+    if (writePyramid) {
+        // One texel of apron per page keeps bilinear filtering inside the page.
+        constexpr uint32_t kPageBorder = 1;
+        const auto cookStart = std::chrono::steady_clock::now();
+        if (!core::image::writeTilePyramid(outputPath, source, tileSize, kPageBorder)) {
+            std::cerr << "error: failed to write '" << outputPath << "'\n";
+            return EXIT_FAILURE;
+        }
+        const double cookSeconds = secondsSince(cookStart);
+        core::image::TilePyramid pyramid;
+        if (!pyramid.open(outputPath)) {
+            std::cerr << "error: failed to reopen '" << outputPath << "'\n";
+            return EXIT_FAILURE;
+        }
+        std::cout << "[EXIT] texcook status=OK input=\"" << inputPath << "\" output=\"" << outputPath << "\" size=" << source.width << "x"
+                  << source.height << " codec=pyramid tile_size=" << tileSize << " levels=" << pyramid.levelCount()
+                  << " pages=" << pyramid.pageCount() << " source_bytes=" << source.pixels.size()
+                  << " cooked_bytes=" << static_cast<uint64_t>(pyramid.pageCount()) * pyramid.pageBytes() << " decode_s=" << decodeSeconds
+                  << " cook_s=" << cookSeconds << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    const auto cookStart = std::chrono::steady_clock::now();
+    const core::image::CookedTexture cooked = core::image::cookTexture(source, codec, generateMips);
+    const double cookSeconds = secondsSince(cookStart);
+
+    if (!core::image::writeTextureContainer(outputPath, cooked)) {
+        std::cerr << "error: failed to write '" << outputPath << "'\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "[EXIT] texcook status=OK input=\"" << inputPath << "\" output=\"" << outputPath << "\" size=" << source.width << "x"
+              << source.height << " codec=" << core::image::textureCodecName(codec) << " levels=" << cooked.levels.size()
+              << " source_bytes=" << source.pixels.size() << " cooked_bytes=" << cooked.data.size() << " decode_s=" << decodeSeconds
+              << " cook_s=" << cookSeconds << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -1,160 +1,130 @@
 #include "vkglobe/GlobeTileLayer.h"
 
+#include "vkglobe/OsmProjection.h"
+
 #include <vsg/all.h>
 
 #include <algorithm>
 #include <cmath>
-#include <set>
 #include <iostream>
+#include <string>
+
+#ifndef VKVSG_SHADER_DIR
+#define VKVSG_SHADER_DIR ""
+#endif
 
 namespace vkglobe {
 
 namespace {
 constexpr double kPi = 3.14159265358979323846;
 
-double tileXToLonDeg(int x, int z)
-{
-    const double n = static_cast<double>(1 << z);
-    return (static_cast<double>(x) / n) * 360.0 - 180.0;
-}
+// Vertices per tile edge.
+constexpr uint32_t kGridSize = 24;
+// The minimum maxImageArrayLayers Vulkan guarantees.
+constexpr uint32_t kTileArrayLayers = 256;
+// The tile cap at the largest tile radius OsmTileManager accepts.
+constexpr uint32_t kMaxTileInstances = (2 * OsmTileManager::kMaxTileRadius + 1) * (2 * OsmTileManager::kMaxTileRadius + 1);
+// Every drawn tile needs its own layer, plus layer 0 for the fallback image.
+static_assert(kMaxTileInstances + 1 <= kTileArrayLayers, "the largest tile window must fit in the tile texture array");
 
-double tileYToLatDeg(int y, int z)
+vsg::ref_ptr<vsg::vec4Array> createInstanceArray()
 {
-    const double n = static_cast<double>(1 << z);
-    const double t = kPi * (1.0 - 2.0 * static_cast<double>(y) / n);
-    return std::atan(std::sinh(t)) * (180.0 / kPi);
+    auto array = vsg::vec4Array::create(kMaxTileInstances);
+    array->properties.dataVariance = vsg::DYNAMIC_DATA;
+    return array;
 }
 
 } // namespace
 
-GlobeTileLayer::GlobeTileLayer(double equatorialRadiusFt, double polarRadiusFt, vsg::ref_ptr<vsg::StateGroup> stateTemplate, vsg::ref_ptr<vsg::Data> fallbackImage) :
+GlobeTileLayer::GlobeTileLayer(double equatorialRadiusFt, double polarRadiusFt, vsg::ref_ptr<vsg::Data> fallbackImage) :
     equatorialRadiusFt_(equatorialRadiusFt),
     polarRadiusFt_(polarRadiusFt),
-    stateTemplate_(std::move(stateTemplate)),
     fallbackImage_(std::move(fallbackImage)),
-    tileSampler_(vsg::Sampler::create()),
-    root_(vsg::Group::create())
+    root_(vsg::StateGroup::create())
 {
-    if (tileSampler_)
+    auto sampler = vsg::Sampler::create();
+    sampler->addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler->addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler->addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler->minFilter = VK_FILTER_LINEAR;
+    sampler->magFilter = VK_FILTER_LINEAR;
+    sampler->mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    textures_ = TileTextureArray::create(kTileArrayLayers, sampler);
+
+    const std::string vertPath = std::string(VKVSG_SHADER_DIR) + "/osm_tiles.vert.spv";
+    const std::string fragPath = std::string(VKVSG_SHADER_DIR) + "/osm_tiles.frag.spv";
+    auto vertexShader = vsg::ShaderStage::read(VK_SHADER_STAGE_VERTEX_BIT, "main", vertPath);
+    auto fragmentShader = vsg::ShaderStage::read(VK_SHADER_STAGE_FRAGMENT_BIT, "main", fragPath);
+    if (!vertexShader || !fragmentShader)
     {
-        tileSampler_->addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-        tileSampler_->addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-        tileSampler_->addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-        tileSampler_->minFilter = VK_FILTER_LINEAR;
-        tileSampler_->magFilter = VK_FILTER_LINEAR;
-        tileSampler_->mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        std::cerr << "[OSM] warning: could not load " << vertPath << " / " << fragPath << "; OSM tiles will not be drawn.\n";
+        return;
     }
-}
+    vertexShader->specializationConstants = vsg::ShaderStage::SpecializationConstants{
+        {0, vsg::floatValue::create(static_cast<float>(equatorialRadiusFt_))},
+        {1, vsg::floatValue::create(static_cast<float>(polarRadiusFt_))}};
 
-bool GlobeTileLayer::syncFromTileWindow(const std::vector<TileSample>& tileWindow)
-{
-    bool changed = false;
-    std::set<std::pair<int, int>> seenOffsets;
-    for (const TileSample& sample : tileWindow)
-    {
-        seenOffsets.insert({sample.ox, sample.oy});
-        auto& slot = slots_[{sample.ox, sample.oy}];
-        const bool keyChanged = !slot.hasKey || slot.key.z != sample.key.z || slot.key.x != sample.key.x || slot.key.y != sample.key.y;
-        const bool loadChanged = (slot.loaded != sample.loaded);
-        if (!keyChanged && !loadChanged) continue;
+    vsg::VertexInputState::Bindings bindings{
+        VkVertexInputBindingDescription{0, sizeof(vsg::vec2), VK_VERTEX_INPUT_RATE_VERTEX},
+        VkVertexInputBindingDescription{1, sizeof(vsg::vec4), VK_VERTEX_INPUT_RATE_INSTANCE},
+        VkVertexInputBindingDescription{2, sizeof(vsg::vec4), VK_VERTEX_INPUT_RATE_INSTANCE},
+        VkVertexInputBindingDescription{3, sizeof(vsg::vec4), VK_VERTEX_INPUT_RATE_INSTANCE}};
 
-        if (slot.node)
-        {
-            auto it = std::find(root_->children.begin(), root_->children.end(), slot.node);
-            if (it != root_->children.end()) root_->children.erase(it);
-        }
+    vsg::VertexInputState::Attributes attributes{
+        VkVertexInputAttributeDescription{0, 0, VK_FORMAT_R32G32_SFLOAT, 0},
+        VkVertexInputAttributeDescription{1, 1, VK_FORMAT_R32G32B32A32_SFLOAT, 0},
+        VkVertexInputAttributeDescription{2, 2, VK_FORMAT_R32G32B32A32_SFLOAT, 0},
+        VkVertexInputAttributeDescription{3, 3, VK_FORMAT_R32G32B32A32_SFLOAT, 0}};
 
-        auto image = (sample.loaded && sample.image) ? sample.image : fallbackImage_;
-        slot.node = buildTileNode(sample.key, image);
-        if (slot.node) root_->addChild(slot.node);
-        slot.key = sample.key;
-        slot.hasKey = true;
-        slot.loaded = sample.loaded;
-        changed = true;
-    }
+    // Default rasterization and depth state, as the globe pipeline the tiles used to inherit.
+    vsg::GraphicsPipelineStates pipelineStates{
+        vsg::VertexInputState::create(bindings, attributes),
+        vsg::InputAssemblyState::create(),
+        vsg::RasterizationState::create(),
+        vsg::MultisampleState::create(),
+        vsg::ColorBlendState::create(),
+        vsg::DepthStencilState::create()};
 
-    for (auto it = slots_.begin(); it != slots_.end(); )
-    {
-        if (seenOffsets.count(it->first) != 0)
-        {
-            ++it;
-            continue;
-        }
+    descriptorSetLayout_ = vsg::DescriptorSetLayout::create(vsg::DescriptorSetLayoutBindings{
+        {0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr}});
 
-        auto& slot = it->second;
-        if (slot.node)
-        {
-            auto childIt = std::find(root_->children.begin(), root_->children.end(), slot.node);
-            if (childIt != root_->children.end()) root_->children.erase(childIt);
-        }
-        it = slots_.erase(it);
-        changed = true;
-    }
-    return changed;
+    vsg::PushConstantRanges pushConstantRanges{
+        {VK_SHADER_STAGE_VERTEX_BIT, 0, 128}};
+
+    pipelineLayout_ = vsg::PipelineLayout::create(vsg::DescriptorSetLayouts{descriptorSetLayout_}, pushConstantRanges);
+    auto graphicsPipeline = vsg::GraphicsPipeline::create(pipelineLayout_, vsg::ShaderStages{vertexShader, fragmentShader}, pipelineStates);
+    root_->add(vsg::BindGraphicsPipeline::create(graphicsPipeline));
 }
 
-vsg::ref_ptr<vsg::Node> GlobeTileLayer::buildTileNode(const TileKey& key, vsg::ref_ptr<vsg::Data> image) const
+bool GlobeTileLayer::createDrawState(const vsg::Data& firstImage)
 {
-    if (!stateTemplate_) return {};
-    if (!image) image = fallbackImage_;
+    if (!textures_->configure(firstImage)) return false;
 
-    constexpr uint32_t cols = 24;
-    constexpr uint32_t rows = 24;
-    const uint32_t numVertices = cols * rows;
-    auto vertices = vsg::vec3Array::create(numVertices);
-    auto normals = vsg::vec3Array::create(numVertices);
-    auto texcoords = vsg::vec2Array::create(numVertices);
+    auto texture = vsg::DescriptorImage::create(textures_->imageInfo(), 0, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+    auto descriptorSet = vsg::DescriptorSet::create(descriptorSetLayout_, vsg::Descriptors{texture});
+    root_->add(vsg::BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout_, 0, descriptorSet));
 
-    const double lonLeft = tileXToLonDeg(key.x, key.z);
-    const double lonRight = tileXToLonDeg(key.x + 1, key.z);
-    const double latTop = tileYToLatDeg(key.y, key.z);
-    const double latBottom = tileYToLatDeg(key.y + 1, key.z);
-    const bool topLeftOrigin = image && image->properties.origin == vsg::TOP_LEFT;
-
-    for (uint32_t r = 0; r < rows; ++r)
+    auto grid = vsg::vec2Array::create(kGridSize * kGridSize);
+    for (uint32_t r = 0; r < kGridSize; ++r)
     {
-        const double v = static_cast<double>(r) / static_cast<double>(rows - 1);
-        const double latDeg = latTop + (latBottom - latTop) * v;
-        const double latRad = latDeg * (kPi / 180.0);
-        const double cosLat = std::cos(latRad);
-        const double sinLat = std::sin(latRad);
-
-        for (uint32_t c = 0; c < cols; ++c)
+        for (uint32_t c = 0; c < kGridSize; ++c)
         {
-            const double u = static_cast<double>(c) / static_cast<double>(cols - 1);
-            const double lonDeg = lonLeft + (lonRight - lonLeft) * u;
-            const double lonRad = lonDeg * (kPi / 180.0);
-            const double sinLon = std::sin(lonRad);
-            const double cosLon = std::cos(lonRad);
-
-            const uint32_t idx = r * cols + c;
-            const double x = sinLon * cosLat * equatorialRadiusFt_;
-            const double y = -cosLon * cosLat * equatorialRadiusFt_;
-            const double z = sinLat * polarRadiusFt_;
-            (*vertices)[idx] = vsg::vec3(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z));
-
-            vsg::dvec3 n(
-                x / (equatorialRadiusFt_ * equatorialRadiusFt_),
-                y / (equatorialRadiusFt_ * equatorialRadiusFt_),
-                z / (polarRadiusFt_ * polarRadiusFt_));
-            n = vsg::normalize(n);
-            (*normals)[idx] = vsg::vec3(static_cast<float>(n.x), static_cast<float>(n.y), static_cast<float>(n.z));
-            (*texcoords)[idx] = vsg::vec2(static_cast<float>(u), static_cast<float>(topLeftOrigin ? v : (1.0 - v)));
+            (*grid)[r * kGridSize + c] = vsg::vec2(static_cast<float>(c) / static_cast<float>(kGridSize - 1),
+                                                   static_cast<float>(r) / static_cast<float>(kGridSize - 1));
         }
     }
 
-    const uint32_t numIndices = (cols - 1) * (rows - 1) * 6;
-    auto indices = vsg::ushortArray::create(numIndices);
+    auto indices = vsg::ushortArray::create((kGridSize - 1) * (kGridSize - 1) * 6);
     uint32_t write = 0;
-    for (uint32_t r = 0; r < rows - 1; ++r)
+    for (uint32_t r = 0; r < kGridSize - 1; ++r)
     {
-        for (uint32_t c = 0; c < cols - 1; ++c)
+        for (uint32_t c = 0; c < kGridSize - 1; ++c)
         {
-            const uint16_t i00 = static_cast<uint16_t>(r * cols + c);
+            const uint16_t i00 = static_cast<uint16_t>(r * kGridSize + c);
             const uint16_t i01 = static_cast<uint16_t>(i00 + 1);
-            const uint16_t i10 = static_cast<uint16_t>(i00 + cols);
+            const uint16_t i10 = static_cast<uint16_t>(i00 + kGridSize);
             const uint16_t i11 = static_cast<uint16_t>(i10 + 1);
-            // Reverse winding to match the inherited globe pipeline cull state.
+            // Reverse winding to match the globe pipeline's cull state.
             (*indices)[write++] = i00;
             (*indices)[write++] = i10;
             (*indices)[write++] = i01;
@@ -164,96 +134,127 @@ vsg::ref_ptr<vsg::Node> GlobeTileLayer::buildTileNode(const TileKey& key, vsg::r
         }
     }
 
-    auto vid = vsg::VertexIndexDraw::create();
-    auto colors = vsg::vec4Array::create(numVertices);
-    for (uint32_t r = 0; r < rows; ++r)
+    instanceLon_ = createInstanceArray();
+    instanceLat_ = createInstanceArray();
+    instanceTexture_ = createInstanceArray();
+    draw_ = vsg::VertexIndexDraw::create();
+    draw_->assignArrays(vsg::DataList{grid, instanceLon_, instanceLat_, instanceTexture_});
+    draw_->assignIndices(indices);
+    draw_->indexCount = static_cast<uint32_t>(indices->size());
+    draw_->instanceCount = 0;
+    root_->addChild(draw_);
+    return true;
+}
+
+bool GlobeTileLayer::syncFromTileWindow(const std::vector<TileSample>& tileWindow)
+{
+    if (!pipelineLayout_) return false;
+    ++syncCount_;
+    textures_->beginSync();
+
+    bool changed = false;
+    if (!draw_)
     {
-        for (uint32_t c = 0; c < cols; ++c)
+        // The texture array takes its layer size and format from the first tile image.
+        auto first = std::find_if(tileWindow.begin(), tileWindow.end(),
+                                  [](const TileSample& sample) { return sample.image && TileTextureArray::isSupported(*sample.image); });
+        if (first == tileWindow.end() || !createDrawState(*first->image)) return false;
+        if (!fallbackImage_ || !textures_->acquire(fallbackImage_, fallbackLayer_))
         {
-            const uint32_t i = r * cols + c;
-            (*colors)[i] = vsg::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+            std::cerr << "[OSM] warning: fallback tile texture is not an 8-bit RGBA image the size of the OSM tiles.\n";
         }
+        drawn_.resize(kMaxTileInstances);
+        changed = true;
     }
-    vid->assignArrays(vsg::DataList{vertices, normals, texcoords, colors});
-    vid->assignIndices(indices);
-    vid->indexCount = static_cast<uint32_t>(indices->size());
-    vid->instanceCount = 1;
-    auto tileState = vsg::clone(stateTemplate_).cast<vsg::StateGroup>();
-    if (!tileState) return {};
-    localizeDescriptorCommands(*tileState);
-    if (!assignTileImage(*tileState, image)) return {};
-    tileState->children.clear();
-    tileState->addChild(vid);
-    return tileState;
-}
 
-void GlobeTileLayer::localizeDescriptorCommands(vsg::StateGroup& stateGroup) const
-{
-    for (auto& sc : stateGroup.stateCommands)
+    const uint32_t count = static_cast<uint32_t>(std::min<size_t>(tileWindow.size(), kMaxTileInstances));
+    bool instancesChanged = count != draw_->instanceCount;
+    auto assign = [&](vsg::vec4Array& array, uint32_t i, const vsg::vec4& value) {
+        if (array[i] == value) return;
+        array[i] = value;
+        instancesChanged = true;
+    };
+    for (uint32_t i = 0; i < count; ++i)
     {
-        if (!(sc.cast<vsg::BindDescriptorSet>() || sc.cast<vsg::BindDescriptorSets>())) continue;
+        const TileSample& sample = tileWindow[i];
+        const TileKey& key = sample.key;
+        uint32_t layer = fallbackLayer_;
+        vsg::vec2 uvOffset = sample.uvOffset;
+        float uvScale = sample.uvScale;
+        const bool placed = sample.image && layerFor(sample.image, layer);
+        const bool kept = !placed && sample.image && !textures_->uploadBudgetLeft() && keepDrawn(i, key);
+        if (!placed && !kept)
+        {
+            layer = fallbackLayer_;
+            uvOffset = vsg::vec2(0.0f, 0.0f);
+            uvScale = 1.0f;
+        }
+        if (!kept) drawn_[i] = DrawnTile{key, placed ? sample.image : vsg::ref_ptr<vsg::Data>{}};
 
-        vsg::CopyOp copyop;
-        copyop.duplicate = vsg::ref_ptr<vsg::Duplicate>(new vsg::Duplicate);
-        auto cloned = sc->clone(copyop).cast<vsg::StateCommand>();
-        if (cloned) sc = cloned;
+        const double lonWest = tileXToLonDeg(key.x, key.z) * (kPi / 180.0);
+        const double lonEast = tileXToLonDeg(key.x + 1, key.z) * (kPi / 180.0);
+        const double latNorth = tileYToLatDeg(key.y, key.z) * (kPi / 180.0);
+        const double latSouth = tileYToLatDeg(key.y + 1, key.z) * (kPi / 180.0);
+        assign(*instanceLon_, i,
+               vsg::vec4(static_cast<float>(std::sin(lonWest)), static_cast<float>(std::cos(lonWest)), static_cast<float>(lonEast - lonWest), 0.0f));
+        assign(*instanceLat_, i,
+               vsg::vec4(static_cast<float>(std::sin(latNorth)), static_cast<float>(std::cos(latNorth)), static_cast<float>(latSouth - latNorth), 0.0f));
+        if (!kept) assign(*instanceTexture_, i, vsg::vec4(uvOffset.x, uvOffset.y, uvScale, static_cast<float>(layer)));
     }
-}
 
-bool GlobeTileLayer::assignTileImage(vsg::StateGroup& stateGroup, vsg::ref_ptr<vsg::Data> image) const
-{
-    if (!image) return false;
-    static bool loggedFailure = false;
-    uint32_t replacedDescriptorImages = 0;
-    auto tryDescriptorSet = [&](vsg::DescriptorSet& descriptorSet) -> bool
+    for (auto it = layers_.begin(); it != layers_.end();)
     {
-        bool updatedAny = false;
-        for (auto& descriptor : descriptorSet.descriptors)
-        {
-            auto di = descriptor.cast<vsg::DescriptorImage>();
-            if (!di || di->descriptorType != VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER) continue;
-            if (di->imageInfoList.empty()) continue;
-
-            vsg::ImageInfoList newInfos;
-            newInfos.reserve(di->imageInfoList.size());
-            for (auto& oldInfo : di->imageInfoList)
-            {
-                auto sampler = tileSampler_ ? tileSampler_ : (oldInfo ? oldInfo->sampler : vsg::Sampler::create());
-                newInfos.push_back(vsg::ImageInfo::create(sampler, image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL));
-            }
-            di->imageInfoList = std::move(newInfos);
-            updatedAny = true;
-            ++replacedDescriptorImages;
-        }
-        if (updatedAny)
+        if (it->second.lastUsedSync == syncCount_)
         {
-            descriptorSet.release();
-            return true;
+            ++it;
+            continue;
         }
-        return false;
-    };
+        textures_->release(it->second.layer);
+        it = layers_.erase(it);
+    }
 
-    for (auto& sc : stateGroup.stateCommands)
+    if (instancesChanged)
     {
-        if (auto bds = sc.cast<vsg::BindDescriptorSet>(); bds && bds->descriptorSet)
-        {
-            (void)tryDescriptorSet(*bds->descriptorSet);
-        }
-        if (auto bdss = sc.cast<vsg::BindDescriptorSets>(); bdss)
+        instanceLon_->dirty();
+        instanceLat_->dirty();
+        instanceTexture_->dirty();
+        draw_->instanceCount = count;
+    }
+    return changed;
+}
+
+bool GlobeTileLayer::layerFor(const vsg::ref_ptr<vsg::Data>& image, uint32_t& layer)
+{
+    auto it = layers_.find(image.get());
+    if (it == layers_.end())
+    {
+        // Out of uploads for this sync; the caller asks again next sync.
+        if (!textures_->uploadBudgetLeft()) return false;
+        if (!textures_->acquire(image, layer))
         {
-            for (auto& ds : bdss->descriptorSets)
+            if (!loggedLayerFailure_)
             {
-                if (ds) (void)tryDescriptorSet(*ds);
+                loggedLayerFailure_ = true;
+                std::cerr << "[OSM] warning: tile image not placed in the texture array (not a tile-sized 8-bit RGBA image, or all " << kTileArrayLayers
+                          << " layers in use); drawing the fallback texture.\n";
             }
+            return false;
         }
+        it = layers_.emplace(image.get(), ImageLayer{image, layer, 0}).first;
     }
-    if (replacedDescriptorImages > 0) return true;
-    if (!loggedFailure)
-    {
-        loggedFailure = true;
-        std::cerr << "[OSM] warning: no DescriptorImage found in tile state template; using inherited globe texture.\n";
-    }
-    return false;
+    it->second.lastUsedSync = syncCount_;
+    layer = it->second.layer;
+    return true;
+}
+
+bool GlobeTileLayer::keepDrawn(uint32_t i, const TileKey& key)
+{
+    const DrawnTile& drawn = drawn_[i];
+    if (!drawn.image || drawn.key != key) return false;
+    auto it = layers_.find(drawn.image.get());
+    if (it == layers_.end()) return false;
+    it->second.lastUsedSync = syncCount_;
+    return true;
 }
 
 } // namespace vkglobe
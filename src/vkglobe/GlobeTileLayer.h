@@ -1,54 +1,84 @@
 #pragma once
 
 #include "vkglobe/OsmTileManager.h"
+#include "vkglobe/TileTextureArray.h"
 
+#include <vsg/commands/Command.h>
+#include <vsg/commands/VertexIndexDraw.h>
+#include <vsg/core/Array.h>
 #include <vsg/core/Inherit.h>
 #include <vsg/core/Data.h>
 #include <vsg/core/Object.h>
-#include <vsg/nodes/Group.h>
 #include <vsg/nodes/StateGroup.h>
-#include <vsg/state/Sampler.h>
+#include <vsg/state/DescriptorSetLayout.h>
+#include <vsg/state/PipelineLayout.h>
 
-#include <map>
-#include <utility>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
 
 namespace vkglobe {
 
+// Draws the OSM tile selection in one instanced draw: every tile is an instance of a shared grid
+// whose positions the vertex shader computes from the tile's bounds, textured from a layer of a
+// TileTextureArray. Images shared by several tiles (an ancestor standing in for its descendants)
+// occupy one layer. A tile change rewrites the instance buffers and, for a new image, uploads that
+// image into a free layer; the scene graph itself only changes when the array is first created.
+// New images past the array's per-sync upload budget wait for a later sync, their tiles meanwhile
+// drawing what they drew before.
 class GlobeTileLayer : public vsg::Inherit<vsg::Object, GlobeTileLayer>
 {
 public:
-    static vsg::ref_ptr<GlobeTileLayer> create(double equatorialRadiusFt, double polarRadiusFt,
-                                               vsg::ref_ptr<vsg::StateGroup> stateTemplate,
-                                               vsg::ref_ptr<vsg::Data> fallbackImage)
+    static vsg::ref_ptr<GlobeTileLayer> create(double equatorialRadiusFt, double polarRadiusFt, vsg::ref_ptr<vsg::Data> fallbackImage)
     {
-        return vsg::ref_ptr<GlobeTileLayer>(new GlobeTileLayer(equatorialRadiusFt, polarRadiusFt, std::move(stateTemplate), std::move(fallbackImage)));
+        return vsg::ref_ptr<GlobeTileLayer>(new GlobeTileLayer(equatorialRadiusFt, polarRadiusFt, std::move(fallbackImage)));
     }
 
-    GlobeTileLayer(double equatorialRadiusFt, double polarRadiusFt, vsg::ref_ptr<vsg::StateGroup> stateTemplate, vsg::ref_ptr<vsg::Data> fallbackImage);
+    GlobeTileLayer(double equatorialRadiusFt, double polarRadiusFt, vsg::ref_ptr<vsg::Data> fallbackImage);
 
-    vsg::ref_ptr<vsg::Group> root() const { return root_; }
+    vsg::ref_ptr<vsg::StateGroup> root() const { return root_; }
+    // Uploads new tile images; must be recorded ahead of the render pass that draws root().
+    vsg::ref_ptr<vsg::Command> uploadCommand() const { return textures_; }
+    // Returns true when root() needs compiling.
     bool syncFromTileWindow(const std::vector<TileSample>& tileWindow);
 
 private:
-    struct Slot
+    struct ImageLayer
+    {
+        vsg::ref_ptr<vsg::Data> image; // keeps the key pointer from being reused
+        uint32_t layer = 0;
+        uint64_t lastUsedSync = 0;
+    };
+
+    struct DrawnTile
     {
         TileKey key;
-        bool hasKey = false;
-        bool loaded = false;
-        vsg::ref_ptr<vsg::Node> node;
+        vsg::ref_ptr<vsg::Data> image; // null when drawing the fallback
     };
 
-    vsg::ref_ptr<vsg::Node> buildTileNode(const TileKey& key, vsg::ref_ptr<vsg::Data> image) const;
-    bool assignTileImage(vsg::StateGroup& stateGroup, vsg::ref_ptr<vsg::Data> image) const;
-    void localizeDescriptorCommands(vsg::StateGroup& stateGroup) const;
+    bool createDrawState(const vsg::Data& firstImage);
+    // The layer holding image, uploading it into a free layer if it has none yet.
+    bool layerFor(const vsg::ref_ptr<vsg::Data>& image, uint32_t& layer);
+    // Keeps instance i as drawn last sync if it drew key's tile from an image that still has a layer.
+    bool keepDrawn(uint32_t i, const TileKey& key);
 
     double equatorialRadiusFt_ = 0.0;
     double polarRadiusFt_ = 0.0;
-    vsg::ref_ptr<vsg::StateGroup> stateTemplate_;
     vsg::ref_ptr<vsg::Data> fallbackImage_;
-    vsg::ref_ptr<vsg::Sampler> tileSampler_;
-    vsg::ref_ptr<vsg::Group> root_;
-    std::map<std::pair<int, int>, Slot> slots_;
+    vsg::ref_ptr<TileTextureArray> textures_;
+    vsg::ref_ptr<vsg::DescriptorSetLayout> descriptorSetLayout_;
+    vsg::ref_ptr<vsg::PipelineLayout> pipelineLayout_;
+    vsg::ref_ptr<vsg::StateGroup> root_;
+    vsg::ref_ptr<vsg::VertexIndexDraw> draw_;
+    vsg::ref_ptr<vsg::vec4Array> instanceLon_;
+    vsg::ref_ptr<vsg::vec4Array> instanceLat_;
+    vsg::ref_ptr<vsg::vec4Array> instanceTexture_;
+
+    std::unordered_map<const vsg::Data*, ImageLayer> layers_;
+    std::vector<DrawnTile> drawn_; // per instance, as of the last sync
+    uint32_t fallbackLayer_ = 0;
+    uint64_t syncCount_ = 0;
+    bool loggedLayerFailure_ = false;
 };
 
 } // namespace vkglobe
@@ -39,5 +39,18 @@ int wrapTileX(int x, int tileCount)
     return wrapped < 0 ? wrapped + tileCount : wrapped;
 }
 
+double tileXToLonDeg(double x, int zoom)
+{
+    const double n = static_cast<double>(tileCountForZoom(zoom));
+    return x / n * 360.0 - 180.0;
+}
+
+double tileYToLatDeg(double y, int zoom)
+{
+    const double n = static_cast<double>(tileCountForZoom(zoom));
+    const double t = kPi * (1.0 - 2.0 * y / n);
+    return std::atan(std::sinh(t)) * (180.0 / kPi);
+}
+
 } // namespace vkglobe
 
@@ -7,6 +7,9 @@ int tileCountForZoom(int zoom);
 double lonToTileX(double lonDeg, int zoom);
 double latToTileY(double latDeg, int zoom);
 int wrapTileX(int x, int tileCount);
+// Inverse of lonToTileX / latToTileY; fractional tile coordinates are allowed.
+double tileXToLonDeg(double x, int zoom);
+double tileYToLatDeg(double y, int zoom);
 
 } // namespace vkglobe
 
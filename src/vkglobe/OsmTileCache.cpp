@@ -0,0 +1,119 @@
+#include "vkglobe/OsmTileCache.h"
+
+#include <utility>
+
+namespace vkglobe {
+
+OsmTileCache::OsmTileCache(size_t budgetBytes) :
+    budgetBytes_(budgetBytes)
+{
+}
+
+void OsmTileCache::setBudget(size_t budgetBytes)
+{
+    budgetBytes_ = budgetBytes;
+    evictToBudget();
+}
+
+const TileEntry* OsmTileCache::find(const TileKey& key) const
+{
+    const auto it = nodes_.find(key);
+    return it == nodes_.end() ? nullptr : &it->second.entry;
+}
+
+TileEntry& OsmTileCache::at(const TileKey& key)
+{
+    return node(key).entry;
+}
+
+bool OsmTileCache::recordLookup(const TileKey& key)
+{
+    const auto it = nodes_.find(key);
+    const bool resident = it != nodes_.end() && it->second.entry.loaded;
+    if (resident)
+        ++hits_;
+    else
+        ++misses_;
+    return resident;
+}
+
+void OsmTileCache::setImage(const TileKey& key, vsg::ref_ptr<vsg::Data> image)
+{
+    Node& n = node(key);
+    bytes_ -= n.bytes;
+    n.bytes = image ? image->dataSize() : 0;
+    bytes_ += n.bytes;
+    n.entry.image = std::move(image);
+    n.entry.loaded = true;
+    evictToBudget();
+}
+
+void OsmTileCache::setPinned(const std::set<TileKey>& keys)
+{
+    for (const TileKey& key : pinned_)
+    {
+        const auto it = nodes_.find(key);
+        if (it != nodes_.end()) it->second.pinned = false;
+    }
+    std::vector<TileKey> unpinned = std::move(pinned_);
+    pinned_.assign(keys.begin(), keys.end());
+    for (const TileKey& key : pinned_) node(key).pinned = true;
+
+    // A tile that left the selection before loading holds no image; a late result recreates it, and
+    // a failed one is retried at once if it comes back into view.
+    for (const TileKey& key : unpinned)
+    {
+        const auto it = nodes_.find(key);
+        if (it == nodes_.end() || it->second.pinned || it->second.entry.loaded) continue;
+        lru_.erase(it->second.lru);
+        nodes_.erase(it);
+    }
+    evictToBudget();
+}
+
+OsmTileCacheStats OsmTileCache::stats() const
+{
+    OsmTileCacheStats out{};
+    out.hits = hits_;
+    out.misses = misses_;
+    out.evictions = evictions_;
+    out.entries = nodes_.size();
+    out.pinned = pinned_.size();
+    out.bytes = bytes_;
+    out.budgetBytes = budgetBytes_;
+    return out;
+}
+
+OsmTileCache::Node& OsmTileCache::node(const TileKey& key)
+{
+    auto [it, inserted] = nodes_.try_emplace(key);
+    Node& n = it->second;
+    if (inserted)
+    {
+        lru_.push_front(key);
+        n.lru = lru_.begin();
+    }
+    else
+    {
+        lru_.splice(lru_.begin(), lru_, n.lru);
+    }
+    return n;
+}
+
+void OsmTileCache::evictToBudget()
+{
+    // Unloaded entries hold no image and may still be in flight, so only loaded ones go.
+    for (auto it = lru_.end(); bytes_ > budgetBytes_ && it != lru_.begin();)
+    {
+        --it;
+        const auto found = nodes_.find(*it);
+        const Node& n = found->second;
+        if (n.pinned || !n.entry.loaded) continue;
+        bytes_ -= n.bytes;
+        nodes_.erase(found);
+        it = lru_.erase(it);
+        ++evictions_;
+    }
+}
+
+} // namespace vkglobe
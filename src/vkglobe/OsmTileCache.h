@@ -0,0 +1,84 @@
+#pragma once
+
+#include "vkglobe/OsmTileKey.h"
+
+#include <vsg/core/Data.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace vkglobe {
+
+struct TileEntry
+{
+    bool fetched = false;
+    bool loaded = false;
+    vsg::ref_ptr<vsg::Data> image;
+    // Consecutive failed fetches or decodes; the tile is not requested again before retryAt.
+    uint32_t failures = 0;
+    std::chrono::steady_clock::time_point retryAt{};
+};
+
+struct OsmTileCacheStats
+{
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t entries = 0;
+    size_t pinned = 0;
+    size_t bytes = 0;
+    size_t budgetBytes = 0;
+};
+
+// Resident OSM tiles, hash-indexed. Once the decoded images exceed the byte budget, loaded tiles
+// are evicted least recently used first. Pinned tiles (the visible window) are never evicted, so
+// a window larger than the budget temporarily overshoots it. Entries that were never loaded (still
+// in flight, or failed) are dropped as soon as they are unpinned.
+class OsmTileCache
+{
+public:
+    explicit OsmTileCache(size_t budgetBytes);
+
+    void setBudget(size_t budgetBytes);
+
+    // Plain lookup: no statistics, no LRU update.
+    const TileEntry* find(const TileKey& key) const;
+    // Returns the entry for key, creating it if needed, and marks it most recently used.
+    TileEntry& at(const TileKey& key);
+    // Counts a hit when key is resident and a miss otherwise. Called once per tile entering the
+    // visible window, so the ratio says how often a newly visible tile was already in memory.
+    bool recordLookup(const TileKey& key);
+    void setImage(const TileKey& key, vsg::ref_ptr<vsg::Data> image);
+    void setPinned(const std::set<TileKey>& keys);
+
+    size_t size() const { return nodes_.size(); }
+    OsmTileCacheStats stats() const;
+
+private:
+    struct Node
+    {
+        TileEntry entry;
+        size_t bytes = 0;
+        bool pinned = false;
+        std::list<TileKey>::iterator lru;
+    };
+
+    Node& node(const TileKey& key);
+    void evictToBudget();
+
+    std::unordered_map<TileKey, Node, TileKeyHash> nodes_;
+    std::list<TileKey> lru_; // front is most recently used
+    std::vector<TileKey> pinned_;
+    size_t budgetBytes_ = 0;
+    size_t bytes_ = 0;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t evictions_ = 0;
+};
+
+} // namespace vkglobe
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace vkglobe {
+
+struct TileKey
+{
+    int z = 0;
+    int x = 0;
+    int y = 0;
+
+    bool operator<(const TileKey& rhs) const;
+    bool operator==(const TileKey& rhs) const = default;
+};
+
+inline TileKey parentTileKey(const TileKey& key)
+{
+    return TileKey{key.z - 1, key.x >> 1, key.y >> 1};
+}
+
+struct TileKeyHash
+{
+    size_t operator()(const TileKey& key) const
+    {
+        // x and y stay below 2^22 up to zoom 22, so the packing is collision free.
+        const uint64_t packed = (static_cast<uint64_t>(key.z) << 48) | (static_cast<uint64_t>(static_cast<uint32_t>(key.x)) << 24) |
+                                static_cast<uint64_t>(static_cast<uint32_t>(key.y));
+        return std::hash<uint64_t>{}(packed);
+    }
+};
+
+} // namespace vkglobe
@@ -1,14 +1,16 @@
 #include "vkglobe/OsmTileManager.h"
 
 #include "vkglobe/OsmProjection.h"
-#include "vkglobe/OsmTileFetcher.h"
 
 #include <vsg/all.h>
-#include <vsg/io/read.h>
 
 #include <algorithm>
+#include <array>
+#include <chrono>
 #include <cmath>
 #include <iostream>
+#include <limits>
+#include <queue>
 
 namespace vkglobe {
 
@@ -47,21 +49,106 @@ bool intersectEllipsoidFromEyeToCenter(const vsg::dvec3& eyeWorld, const vsg::dm
     return true;
 }
 
-vsg::ref_ptr<vsg::Data> createMissingTileDebugImage()
+// Rough on-screen size of key seen from altitudeFt above the normalized Web Mercator point (u, v):
+// the tile's ground area, foreshortened by the view angle and shrunk by the squared range, over the
+// range once more so that in a mixed-zoom selection a near fine tile still outranks a distant coarse
+// one. Only the ordering matters; worldSizeFt is the length of the parallel through the camera.
+double tileScreenImportance(const TileKey& key, double u, double v, double worldSizeFt, double altitudeFt)
 {
-    constexpr uint32_t w = 64;
-    constexpr uint32_t h = 64;
-    auto tex = vsg::ubvec4Array2D::create(w, h, vsg::Data::Properties{VK_FORMAT_R8G8B8A8_UNORM});
-    for (uint32_t y = 0; y < h; ++y)
+    const double tiles = static_cast<double>(tileCountForZoom(key.z));
+    double du = (key.x + 0.5) / tiles - u;
+    du -= std::round(du);
+    const double dv = (key.y + 0.5) / tiles - v;
+    const double groundFt = std::hypot(du, dv) * worldSizeFt;
+    const double sideFt = worldSizeFt / tiles;
+    const double heightFt = std::max(altitudeFt, 1.0);
+    const double rangeFt = std::hypot(heightFt, groundFt);
+    return sideFt * sideFt * heightFt * heightFt / (rangeFt * rangeFt * rangeFt * rangeFt);
+}
+
+// A tile is refined while it spans more than this many pixels, the size it was rendered for.
+constexpr double kTilePixels = 256.0;
+// Tiles coarser than this cover too much of the globe for sampled bounds; they are never culled.
+constexpr int kMinCulledZoom = 2;
+
+vsg::dvec3 ellipsoidPoint(double latDeg, double lonDeg, double equatorialRadius, double polarRadius)
+{
+    const double lat = latDeg * (kPi / 180.0);
+    const double lon = lonDeg * (kPi / 180.0);
+    return vsg::dvec3(std::sin(lon) * std::cos(lat) * equatorialRadius, -std::cos(lon) * std::cos(lat) * equatorialRadius,
+                      std::sin(lat) * polarRadius);
+}
+
+// Globe-frame bounds of a tile: a sphere around a 3x3 grid of its surface points, widened by the
+// bulge of the surface between the points, and the tile's east-west extent.
+struct TileBounds
+{
+    vsg::dvec3 center;
+    double radius = 0.0;
+    double sideFt = 0.0;
+};
+
+TileBounds computeTileBounds(const TileKey& key, double equatorialRadius, double polarRadius)
+{
+    std::array<vsg::dvec3, 9> points;
+    TileBounds bounds;
+    for (int j = 0; j < 3; ++j)
     {
-        for (uint32_t x = 0; x < w; ++x)
+        const double latDeg = tileYToLatDeg(key.y + 0.5 * j, key.z);
+        for (int i = 0; i < 3; ++i)
         {
-            const bool a = ((x / 8) + (y / 8)) % 2 == 0;
-            tex->set(x, y, a ? vsg::ubvec4(255, 0, 255, 255) : vsg::ubvec4(0, 255, 255, 255));
+            const vsg::dvec3 p = ellipsoidPoint(latDeg, tileXToLonDeg(key.x + 0.5 * i, key.z), equatorialRadius, polarRadius);
+            points[j * 3 + i] = p;
+            bounds.center += p;
         }
     }
-    tex->dirty();
-    return tex;
+    bounds.center /= 9.0;
+    for (const vsg::dvec3& p : points) bounds.radius = std::max(bounds.radius, vsg::length(p - bounds.center));
+    const double sagitta = equatorialRadius - std::sqrt(std::max(0.0, equatorialRadius * equatorialRadius - bounds.radius * bounds.radius));
+    bounds.radius += sagitta;
+
+    const double midLat = tileYToLatDeg(key.y + 0.5, key.z) * (kPi / 180.0);
+    bounds.sideFt = 2.0 * kPi * equatorialRadius * std::cos(midLat) / tileCountForZoom(key.z);
+    return bounds;
+}
+
+// Left, right, bottom and top planes of viewProjection (Gribb/Hartmann), normalized so that a
+// point's signed distance is in the units of the positions. Near and far are left out: the
+// ellipsoid perspective moves them every frame and the horizon test does their job.
+std::array<vsg::dvec4, 4> frustumSidePlanes(const vsg::dmat4& viewProjection)
+{
+    auto row = [&](int r) { return vsg::dvec4(viewProjection[0][r], viewProjection[1][r], viewProjection[2][r], viewProjection[3][r]); };
+    const vsg::dvec4 r0 = row(0);
+    const vsg::dvec4 r1 = row(1);
+    const vsg::dvec4 r3 = row(3);
+    std::array<vsg::dvec4, 4> planes{r3 + r0, r3 - r0, r3 + r1, r3 - r1};
+    for (vsg::dvec4& plane : planes)
+    {
+        const double len = vsg::length(vsg::dvec3(plane.x, plane.y, plane.z));
+        if (len > 0.0) plane /= len;
+    }
+    return planes;
+}
+
+bool sphereOutsideFrustum(const std::array<vsg::dvec4, 4>& planes, const vsg::dvec3& center, double radius)
+{
+    for (const vsg::dvec4& plane : planes)
+    {
+        if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius) return true;
+    }
+    return false;
+}
+
+// In the ellipsoid's scaled space (the unit sphere) the surface seen from e ends at the plane
+// dot(p, e) = 1; a tile whose bounding sphere lies wholly beyond that plane is over the horizon.
+// Scaling by the smaller polar radius keeps the sphere conservative.
+bool behindHorizon(const TileBounds& bounds, const vsg::dvec3& eyeScaled, double equatorialRadius, double polarRadius)
+{
+    const double eyeDistance = vsg::length(eyeScaled);
+    if (eyeDistance <= 1.0) return false;
+    const vsg::dvec3 centerScaled(bounds.center.x / equatorialRadius, bounds.center.y / equatorialRadius, bounds.center.z / polarRadius);
+    const double radiusScaled = bounds.radius / polarRadius;
+    return vsg::dot(centerScaled, eyeScaled) / eyeDistance + radiusScaled < 1.0 / eyeDistance;
 }
 
 } // namespace
@@ -75,8 +162,23 @@ bool TileKey::operator<(const TileKey& rhs) const
 
 OsmTileManager::OsmTileManager(vsg::ref_ptr<vsg::Options> options, Config cfg) :
     options_(std::move(options)),
-    cfg_(std::move(cfg))
+    cfg_(std::move(cfg)),
+    tileCache_(cfg_.memoryBudgetBytes)
 {
+    TileSourceConfig sourceConfig{};
+    sourceConfig.urlTemplate = cfg_.urlTemplate;
+    sourceConfig.maxConnectionsPerHost = cfg_.maxConnectionsPerHost;
+    sourceConfig.simulatedLatencyMs = cfg_.simulatedLatencyMs;
+    sourceConfig.simulatedBytesPerSecond = cfg_.simulatedBytesPerSecond;
+    std::unique_ptr<TileSource> source = createOsmTileSource(sourceConfig);
+    tileSourceName_ = source->name();
+
+    OsmTilePipeline::Config pipelineConfig{};
+    pipelineConfig.cacheRoot = cfg_.cacheRoot;
+    pipelineConfig.fetchThreads = cfg_.fetchThreads;
+    pipelineConfig.decodeThreads = cfg_.decodeThreads;
+    pipelineConfig.decodedCacheBytes = cfg_.decodedCacheBytes;
+    pipeline_ = std::make_unique<OsmTilePipeline>(options_, std::move(pipelineConfig), std::move(source));
 }
 
 void OsmTileManager::setEnabled(bool enabled)
@@ -86,6 +188,11 @@ void OsmTileManager::setEnabled(bool enabled)
     {
         active_ = false;
         visibleTiles_.clear();
+        ancestorTiles_.clear();
+        predictedTiles_.clear();
+        motionHistory_.clear();
+        tileCache_.setPinned(visibleTiles_);
+        pipeline_->schedule({});
     }
 }
 
@@ -96,7 +203,7 @@ void OsmTileManager::setMaxZoom(int maxZoom)
 
 void OsmTileManager::setTileRadius(int tileRadius)
 {
-    cfg_.tileRadius = std::clamp(tileRadius, 1, 16);
+    cfg_.tileRadius = std::clamp(tileRadius, 1, kMaxTileRadius);
 }
 
 void OsmTileManager::setActivationAltitudes(double enableAltitudeFt, double disableAltitudeFt)
@@ -105,7 +212,8 @@ void OsmTileManager::setActivationAltitudes(double enableAltitudeFt, double disa
     cfg_.disableAltitudeFt = std::max(cfg_.enableAltitudeFt + 1.0, disableAltitudeFt);
 }
 
-void OsmTileManager::update(const vsg::dvec3& eyeWorld, const vsg::dmat4& globeRotation, double equatorialRadiusFt, double polarRadiusFt)
+void OsmTileManager::update(const vsg::dvec3& eyeWorld, const vsg::dmat4& globeRotation, double equatorialRadiusFt, double polarRadiusFt,
+                            const vsg::dmat4& projection, const vsg::dmat4& view, double viewportHeightPx)
 {
     if (!enabled_) return;
 
@@ -117,6 +225,16 @@ void OsmTileManager::update(const vsg::dvec3& eyeWorld, const vsg::dmat4& globeR
     currentLatDeg_ = latDeg;
     currentLonDeg_ = lonDeg;
     currentAltitudeFt_ = altitudeFt;
+    equatorialRadiusFt_ = equatorialRadiusFt;
+    polarRadiusFt_ = polarRadiusFt;
+
+    // Selection runs in the globe frame, where tile positions do not depend on the globe's spin.
+    const vsg::dvec4 eye4 = vsg::inverse(globeRotation) * vsg::dvec4(eyeWorld.x, eyeWorld.y, eyeWorld.z, 1.0);
+    const vsg::dvec3 eyeLocal(eye4.x, eye4.y, eye4.z);
+    const vsg::dmat4 viewProjectionLocal = projection * view * globeRotation;
+    const double pixelsPerRadian = std::abs(projection[1][1]) * std::max(1.0, viewportHeightPx) * 0.5;
+
+    recordMotion(eyeLocal);
     if (active_)
     {
         if (altitudeFt >= cfg_.disableAltitudeFt) active_ = false;
@@ -130,13 +248,21 @@ void OsmTileManager::update(const vsg::dvec3& eyeWorld, const vsg::dmat4& globeR
     {
         currentZoom_ = 0;
         visibleTiles_.clear();
+        ancestorTiles_.clear();
+        predictedTiles_.clear();
+        tileCache_.setPinned(visibleTiles_);
+        pipeline_->schedule({});
         return;
     }
 
-    const int zoom = chooseZoomForAltitude(altitudeFt);
-    currentZoom_ = zoom;
-    requestVisibleTiles(latDeg, lonDeg, zoom);
-    fetchAndDecodeBudgeted();
+    updateVisibleTiles(eyeLocal, viewProjectionLocal, pixelsPerRadian);
+    predictTiles(globeRotation, viewProjectionLocal, pixelsPerRadian);
+    std::set<TileKey> pinned = ancestorTiles_;
+    pinned.insert(visibleTiles_.begin(), visibleTiles_.end());
+    pinned.insert(predictedTiles_.begin(), predictedTiles_.end());
+    tileCache_.setPinned(pinned);
+    scheduleMissingTiles();
+    drainCompletedTiles();
 }
 
 bool OsmTileManager::computeSubCameraGeo(const vsg::dvec3& eyeWorld, const vsg::dmat4& globeRotation, double equatorialRadiusFt,
@@ -157,72 +283,212 @@ bool OsmTileManager::computeSubCameraGeo(const vsg::dvec3& eyeWorld, const vsg::
     return true;
 }
 
-int OsmTileManager::chooseZoomForAltitude(double altitudeFt) const
+size_t OsmTileManager::maxSelectedTiles() const
 {
-    if (altitudeFt <= 500.0) return std::clamp(cfg_.maxZoom, cfg_.minZoom, cfg_.maxZoom);
-    if (altitudeFt <= 1000.0) return std::clamp(cfg_.maxZoom - 1, cfg_.minZoom, cfg_.maxZoom);
-    if (altitudeFt <= 3000.0) return std::clamp(cfg_.maxZoom - 2, cfg_.minZoom, cfg_.maxZoom);
-    if (altitudeFt <= 12000.0) return std::clamp(cfg_.maxZoom - 4, cfg_.minZoom, cfg_.maxZoom);
-    if (altitudeFt <= 50000.0) return std::clamp(cfg_.maxZoom - 6, cfg_.minZoom, cfg_.maxZoom);
-    return std::clamp(cfg_.maxZoom - 8, cfg_.minZoom, cfg_.maxZoom);
+    const size_t side = static_cast<size_t>(2 * std::max(1, cfg_.tileRadius) + 1);
+    return side * side;
 }
 
-void OsmTileManager::requestVisibleTiles(double latDeg, double lonDeg, int zoom)
+void OsmTileManager::selectTiles(const vsg::dvec3& eyeLocal, const vsg::dmat4& viewProjectionLocal, double pixelsPerRadian,
+                                 std::set<TileKey>& out) const
 {
-    const int tiles = tileCountForZoom(zoom);
-    const double fx = lonToTileX(lonDeg, zoom);
-    const double fy = latToTileY(latDeg, zoom);
-    const int centerX = static_cast<int>(std::floor(fx + 0.5));
-    const int centerY = static_cast<int>(std::floor(fy + 0.5));
-    const int radius = std::max(1, cfg_.tileRadius);
-    currentCenterTileX_ = centerX;
-    currentCenterTileY_ = centerY;
-    currentTileRadius_ = radius;
-    visibleTiles_.clear();
-    for (int oy = -radius; oy <= radius; ++oy)
+    struct Candidate
+    {
+        double pixels = 0.0;
+        TileKey key;
+        bool operator<(const Candidate& rhs) const { return pixels < rhs.pixels; }
+    };
+
+    const double equatorialRadius = equatorialRadiusFt_;
+    const double polarRadius = polarRadiusFt_;
+    const std::array<vsg::dvec4, 4> planes = frustumSidePlanes(viewProjectionLocal);
+    const vsg::dvec3 eyeScaled(eyeLocal.x / equatorialRadius, eyeLocal.y / equatorialRadius, eyeLocal.z / polarRadius);
+
+    // False if key cannot be seen; otherwise sets its projected size from its nearest point.
+    auto evaluate = [&](const TileKey& key, Candidate& candidate) {
+        candidate.key = key;
+        candidate.pixels = std::numeric_limits<double>::infinity();
+        if (key.z < kMinCulledZoom) return true;
+        const TileBounds bounds = computeTileBounds(key, equatorialRadius, polarRadius);
+        if (sphereOutsideFrustum(planes, bounds.center, bounds.radius)) return false;
+        if (behindHorizon(bounds, eyeScaled, equatorialRadius, polarRadius)) return false;
+        const double distance = std::max(1.0, vsg::length(bounds.center - eyeLocal) - bounds.radius);
+        candidate.pixels = bounds.sideFt / distance * pixelsPerRadian;
+        return true;
+    };
+
+    // Refining the largest tile first means that when the cap is reached, the tiles left coarse
+    // are the ones that already look the sharpest.
+    const size_t cap = maxSelectedTiles();
+    const double refinePixels = kTilePixels * std::max(0.01, cfg_.detailScale);
+    std::priority_queue<Candidate> open;
+    Candidate root;
+    evaluate(TileKey{0, 0, 0}, root);
+    open.push(root);
+    while (!open.empty())
     {
-        for (int ox = -radius; ox <= radius; ++ox)
+        const Candidate candidate = open.top();
+        open.pop();
+        const TileKey& key = candidate.key;
+        const bool forced = key.z < cfg_.minZoom;
+        if (!forced && (key.z >= cfg_.maxZoom || candidate.pixels <= refinePixels))
         {
-            const int tx = wrapTileX(centerX + ox, tiles);
-            const int ty = std::clamp(centerY + oy, 0, tiles - 1);
-            visibleTiles_.insert(TileKey{zoom, tx, ty});
+            out.insert(key);
+            continue;
+        }
+
+        std::array<Candidate, 4> children;
+        size_t childCount = 0;
+        for (int cy = 0; cy < 2; ++cy)
+        {
+            for (int cx = 0; cx < 2; ++cx)
+            {
+                if (evaluate(TileKey{key.z + 1, key.x * 2 + cx, key.y * 2 + cy}, children[childCount])) ++childCount;
+            }
         }
+        if (!forced && out.size() + open.size() + childCount > cap)
+        {
+            out.insert(key);
+            continue;
+        }
+        for (size_t i = 0; i < childCount; ++i) open.push(children[i]);
     }
 }
 
-void OsmTileManager::fetchAndDecodeBudgeted()
+void OsmTileManager::updateVisibleTiles(const vsg::dvec3& eyeLocal, const vsg::dmat4& viewProjectionLocal, double pixelsPerRadian)
 {
-    int fetchedThisFrame = 0;
+    std::set<TileKey> selected;
+    selectTiles(eyeLocal, viewProjectionLocal, pixelsPerRadian, selected);
+    currentZoom_ = 0;
+    for (const TileKey& key : selected)
+    {
+        if (!visibleTiles_.contains(key)) tileCache_.recordLookup(key);
+        currentZoom_ = std::max(currentZoom_, key.z);
+    }
+    visibleTiles_ = std::move(selected);
+
+    // Parent chains converge quickly, so the ancestors of the selection are only a handful of
+    // tiles per level; pinning them keeps fallback imagery for zooming in and the target tiles for
+    // zooming out resident.
+    ancestorTiles_.clear();
     for (const TileKey& key : visibleTiles_)
     {
-        auto& entry = tileCache_[key];
-        if (entry.loaded) continue;
-        if (fetchedThisFrame >= cfg_.maxFetchPerFrame) break;
+        const int lowestZoom = std::max(cfg_.minZoom, key.z - std::max(0, cfg_.ancestorLevels));
+        for (TileKey ancestor = key; ancestor.z > lowestZoom;)
+        {
+            ancestor = parentTileKey(ancestor);
+            if (!ancestorTiles_.insert(ancestor).second) break;
+        }
+    }
+}
+
+void OsmTileManager::recordMotion(const vsg::dvec3& eyeLocal)
+{
+    const auto now = std::chrono::steady_clock::now();
+    motionHistory_.push_back(MotionSample{now, eyeLocal});
+    // Keep the newest sample that is at least one velocity window old as the baseline.
+    const auto window = std::chrono::duration<double>(cfg_.velocityWindowSeconds);
+    while (motionHistory_.size() > 2 && now - motionHistory_[1].time >= window) motionHistory_.pop_front();
+}
+
+void OsmTileManager::predictTiles(const vsg::dmat4& globeRotation, const vsg::dmat4& viewProjectionLocal, double pixelsPerRadian)
+{
+    // Extrapolates the eye linearly, keeps the view direction and runs the same selection from
+    // there, so both panning and zooming prefetch the tiles they are about to need.
+    predictedTiles_.clear();
+    if (cfg_.prefetchLookaheadSeconds <= 0.0 || motionHistory_.size() < 2) return;
+    const MotionSample& first = motionHistory_.front();
+    const MotionSample& last = motionHistory_.back();
+    const double dt = std::chrono::duration<double>(last.time - first.time).count();
+    if (dt < 1e-3) return;
+
+    const vsg::dvec3 delta = (last.eyeLocal - first.eyeLocal) * (cfg_.prefetchLookaheadSeconds / dt);
+    vsg::dvec3 eye = last.eyeLocal + delta;
+    // A fast descent must not extrapolate through the ground.
+    const vsg::dvec3 eyeScaled(eye.x / equatorialRadiusFt_, eye.y / equatorialRadiusFt_, eye.z / polarRadiusFt_);
+    const double minScaledLength = 1.0 + 100.0 / polarRadiusFt_;
+    const double scaledLength = vsg::length(eyeScaled);
+    if (scaledLength < minScaledLength) eye *= minScaledLength / scaledLength;
+
+    const vsg::dvec4 eyeWorld4 = globeRotation * vsg::dvec4(eye.x, eye.y, eye.z, 1.0);
+    double latDeg = 0.0;
+    double lonDeg = 0.0;
+    if (!computeSubCameraGeo(vsg::dvec3(eyeWorld4.x, eyeWorld4.y, eyeWorld4.z), globeRotation, equatorialRadiusFt_, polarRadiusFt_, latDeg,
+                             lonDeg, predictedAltitudeFt_))
+        return;
+    predictedU_ = lonToTileX(lonDeg, 0);
+    predictedV_ = latToTileY(latDeg, 0);
+
+    const vsg::dvec3 shift = eye - last.eyeLocal;
+    std::set<TileKey> selected;
+    selectTiles(eye, viewProjectionLocal * vsg::translate(-shift), pixelsPerRadian, selected);
+    for (const TileKey& key : selected)
+    {
+        if (!visibleTiles_.contains(key) && !ancestorTiles_.contains(key)) predictedTiles_.insert(key);
+    }
+}
 
-        const std::filesystem::path cacheFile = cfg_.cacheRoot / std::to_string(key.z) / std::to_string(key.x) / (std::to_string(key.y) + ".png");
-        if (!downloadOsmTileIfNeeded(key.z, key.x, key.y, cacheFile))
+void OsmTileManager::scheduleMissingTiles()
+{
+    // Rebuilt every frame so the tile under the camera goes first and tiles that left the selection
+    // are cancelled before they reach a fetch worker. Missing ancestors go
+    // ahead of the selection: each one gives a whole block of tiles something to draw.
+    // Predicted tiles come last, ranked as seen from the predicted camera.
+    const double worldSizeFt = 2.0 * kPi * equatorialRadiusFt_ * std::cos(clampLat(currentLatDeg_) * (kPi / 180.0));
+    std::vector<TileKey> keys;
+    keys.reserve(ancestorTiles_.size() + visibleTiles_.size() + predictedTiles_.size());
+    const auto now = std::chrono::steady_clock::now();
+    auto appendMissing = [&](const std::set<TileKey>& tiles, double u, double v, double altitudeFt) {
+        std::vector<std::pair<double, TileKey>> missing;
+        missing.reserve(tiles.size());
+        for (const TileKey& key : tiles)
         {
-            entry.image = createMissingTileDebugImage();
-            entry.loaded = true;
-            ++fetchedThisFrame;
-            std::cerr << "[OSM] fetch failed z=" << key.z << " x=" << key.x << " y=" << key.y
-                      << " (using debug tile)\n";
-            continue;
+            const TileEntry* entry = tileCache_.find(key);
+            if (entry && (entry->loaded || now < entry->retryAt)) continue;
+            missing.emplace_back(tileScreenImportance(key, u, v, worldSizeFt, altitudeFt), key);
         }
-        entry.fetched = true;
+        std::sort(missing.begin(), missing.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+        for (const auto& [importance, key] : missing) keys.push_back(key);
+    };
+    const double u = lonToTileX(currentLonDeg_, 0);
+    const double v = latToTileY(currentLatDeg_, 0);
+    appendMissing(ancestorTiles_, u, v, currentAltitudeFt_);
+    appendMissing(visibleTiles_, u, v, currentAltitudeFt_);
+    appendMissing(predictedTiles_, predictedU_, predictedV_, predictedAltitudeFt_);
+    pipeline_->schedule(keys);
+}
 
-        auto data = vsg::read_cast<vsg::Data>(cacheFile.string(), options_);
-        if (!data)
+void OsmTileManager::drainCompletedTiles()
+{
+    // At least one result per call so a slow frame cannot stall the pipeline completely.
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double, std::milli>(cfg_.completionBudgetMs);
+    OsmTilePipeline::Result result;
+    while (pipeline_->popCompleted(result))
+    {
+        // A failed tile stays unloaded, so the window keeps drawing its nearest ancestor, and
+        // scheduleMissingTiles() asks for it again once its backoff has passed. One that has left
+        // the selection is simply forgotten.
+        ++completedTileCount_;
+        if (result.fetched && result.image)
         {
-            entry.image = createMissingTileDebugImage();
-            entry.loaded = true;
-            ++fetchedThisFrame;
-            std::cerr << "[OSM] decode failed for '" << cacheFile.string() << "' (using debug tile)\n";
-            continue;
+            TileEntry& entry = tileCache_.at(result.key);
+            entry.fetched = true;
+            entry.failures = 0;
+            tileCache_.setImage(result.key, result.image);
+        }
+        else if (visibleTiles_.contains(result.key) || ancestorTiles_.contains(result.key) || predictedTiles_.contains(result.key))
+        {
+            TileEntry& entry = tileCache_.at(result.key);
+            entry.fetched = result.fetched;
+            const double backoffSeconds = std::min(cfg_.failureRetrySeconds * std::ldexp(1.0, static_cast<int>(std::min<uint32_t>(entry.failures, 30))),
+                                                   cfg_.failureRetryMaxSeconds);
+            ++entry.failures;
+            entry.retryAt = std::chrono::steady_clock::now() +
+                            std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(backoffSeconds));
+            std::cerr << "[OSM] " << (result.fetched ? "decode" : "fetch") << " failed z=" << result.key.z << " x=" << result.key.x
+                      << " y=" << result.key.y << " (drawing parent tile, retry in " << backoffSeconds << " s)\n";
         }
-        entry.image = data;
-        entry.loaded = true;
-        ++fetchedThisFrame;
+        if (std::chrono::steady_clock::now() >= deadline) break;
     }
 }
 
@@ -232,10 +498,9 @@ std::vector<std::pair<TileKey, vsg::ref_ptr<vsg::Data>>> OsmTileManager::loadedV
     tiles.reserve(visibleTiles_.size());
     for (const TileKey& key : visibleTiles_)
     {
-        auto it = tileCache_.find(key);
-        if (it == tileCache_.end()) continue;
-        if (!it->second.loaded || !it->second.image) continue;
-        tiles.emplace_back(key, it->second.image);
+        const TileEntry* entry = tileCache_.find(key);
+        if (!entry || !entry->loaded || !entry->image) continue;
+        tiles.emplace_back(key, entry->image);
     }
     return tiles;
 }
@@ -243,30 +508,34 @@ std::vector<std::pair<TileKey, vsg::ref_ptr<vsg::Data>>> OsmTileManager::loadedV
 std::vector<TileSample> OsmTileManager::currentTileWindow() const
 {
     std::vector<TileSample> window;
-    if (currentZoom_ <= 0) return window;
-
-    const int tiles = tileCountForZoom(currentZoom_);
-    const int radius = std::max(1, currentTileRadius_);
-    window.reserve(static_cast<size_t>((2 * radius + 1) * (2 * radius + 1)));
-    for (int oy = -radius; oy <= radius; ++oy)
+    window.reserve(visibleTiles_.size());
+    for (const TileKey& key : visibleTiles_)
     {
-        for (int ox = -radius; ox <= radius; ++ox)
+        TileSample sample{};
+        sample.key = key;
+        const TileEntry* entry = tileCache_.find(key);
+        if (entry && entry->loaded && entry->image)
+        {
+            sample.loaded = true;
+            sample.image = entry->image;
+        }
+        else
         {
-            const int tx = wrapTileX(currentCenterTileX_ + ox, tiles);
-            const int ty = std::clamp(currentCenterTileY_ + oy, 0, tiles - 1);
-            const TileKey key{currentZoom_, tx, ty};
-            TileSample sample{};
-            sample.key = key;
-            sample.ox = ox;
-            sample.oy = oy;
-            auto it = tileCache_.find(key);
-            if (it != tileCache_.end() && it->second.loaded && it->second.image)
+            // Any loaded ancestor will do, not just the pinned ones.
+            for (TileKey ancestor = key; ancestor.z > 0;)
             {
-                sample.loaded = true;
-                sample.image = it->second.image;
+                ancestor = parentTileKey(ancestor);
+                const TileEntry* ancestorEntry = tileCache_.find(ancestor);
+                if (!ancestorEntry || !ancestorEntry->image) continue;
+                const int levels = key.z - ancestor.z;
+                sample.image = ancestorEntry->image;
+                sample.uvScale = 1.0f / static_cast<float>(1 << levels);
+                sample.uvOffset = vsg::vec2(static_cast<float>(key.x - (ancestor.x << levels)) * sample.uvScale,
+                                            static_cast<float>(key.y - (ancestor.y << levels)) * sample.uvScale);
+                break;
             }
-            window.push_back(sample);
         }
+        window.push_back(sample);
     }
     return window;
 }
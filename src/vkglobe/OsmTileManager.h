@@ -1,50 +1,77 @@
 #pragma once
 
+#include "vkglobe/OsmTileCache.h"
+#include "vkglobe/OsmTileKey.h"
+#include "vkglobe/OsmTilePipeline.h"
+
 #include <vsg/core/Inherit.h>
 #include <vsg/core/Data.h>
 #include <vsg/core/Object.h>
 #include <vsg/io/Options.h>
+#include <vsg/maths/mat4.h>
+#include <vsg/maths/vec2.h>
+#include <vsg/maths/vec3.h>
 
+#include <chrono>
+#include <deque>
 #include <filesystem>
-#include <map>
+#include <memory>
 #include <set>
+#include <string>
 #include <vector>
 
 namespace vkglobe {
 
-struct TileKey
-{
-    int z = 0;
-    int x = 0;
-    int y = 0;
-
-    bool operator<(const TileKey& rhs) const;
-};
-
-struct TileEntry
-{
-    bool fetched = false;
-    bool loaded = false;
-    vsg::ref_ptr<vsg::Data> image;
-};
-
 struct TileSample
 {
     TileKey key;
-    int ox = 0;
-    int oy = 0;
+    // True once key's own image is available. Until then image is the nearest loaded ancestor
+    // (null if there is none) and uvOffset/uvScale select key's square within it.
     bool loaded = false;
     vsg::ref_ptr<vsg::Data> image;
+    vsg::vec2 uvOffset{0.0f, 0.0f};
+    float uvScale = 1.0f;
 };
 
 class OsmTileManager : public vsg::Inherit<vsg::Object, OsmTileManager>
 {
 public:
+    // Largest accepted tileRadius: its 15x15 window plus the fallback layer has to fit in the
+    // 256-layer tile texture array GlobeTileLayer draws from.
+    static constexpr int kMaxTileRadius = 7;
+
     struct Config
     {
         std::filesystem::path cacheRoot = "cache/osm";
-        int maxFetchPerFrame = 4;
+        std::string urlTemplate = kDefaultOsmTileUrlTemplate;
+        int maxConnectionsPerHost = 2;
+        // Benchmarks only; see TileSourceConfig.
+        int simulatedLatencyMs = 0;
+        uint64_t simulatedBytesPerSecond = 0;
+        int fetchThreads = 4;
+        int decodeThreads = 2;
+        // Frame time spent moving finished tiles from the pipeline into the cache.
+        double completionBudgetMs = 2.0;
+        size_t memoryBudgetBytes = size_t{256} * 1024 * 1024;
+        // Disk budget of the decoded tile cache (see OsmTilePipeline); 0 disables it.
+        uint64_t decodedCacheBytes = OsmTilePipeline::Config{}.decodedCacheBytes;
+        // Caps the selection at the tile count of a (2 * tileRadius + 1)^2 window; clamped to
+        // kMaxTileRadius.
         int tileRadius = 4;
+        // A tile is refined while it covers more than detailScale * 256 pixels on screen, so 2
+        // halves the resolution and 0.5 doubles it.
+        double detailScale = 1.0;
+        // Zoom levels above the selection kept resident (and fetched first) as fallback imagery.
+        int ancestorLevels = 5;
+        // The tiles selected from where the camera is predicted to be this far ahead are prefetched
+        // after the visible ones; 0 disables prediction. Velocity is measured over
+        // velocityWindowSeconds.
+        double prefetchLookaheadSeconds = 1.0;
+        double velocityWindowSeconds = 0.5;
+        // A tile whose fetch or decode failed is requested again after this delay, doubled for
+        // every further consecutive failure up to failureRetryMaxSeconds.
+        double failureRetrySeconds = 1.0;
+        double failureRetryMaxSeconds = 60.0;
         int minZoom = 1;
         int maxZoom = 19;
         double enableAltitudeFt = 10000.0;
@@ -73,32 +100,66 @@ public:
     double currentLonDeg() const { return currentLonDeg_; }
     double currentAltitudeFt() const { return currentAltitudeFt_; }
     size_t cachedTileCount() const { return tileCache_.size(); }
+    OsmTileCacheStats cacheStats() const { return tileCache_.stats(); }
     size_t visibleTileCount() const { return visibleTiles_.size(); }
+    size_t predictedTileCount() const { return predictedTiles_.size(); }
+    size_t pendingTileCount() const { return pipeline_->inFlightCount(); }
+    uint64_t cancelledTileCount() const { return pipeline_->cancelledCount(); }
+    // Tiles taken from the pipeline into the cache, failed ones included.
+    uint64_t completedTileCount() const { return completedTileCount_; }
+    OsmTileStoreStats storeStats() const { return pipeline_->storeStats(); }
+    OsmDecodeStats decodeStats() const { return pipeline_->decodeStats(); }
+    const char* tileSourceName() const { return tileSourceName_; }
     std::vector<std::pair<TileKey, vsg::ref_ptr<vsg::Data>>> loadedVisibleTiles() const;
     std::vector<TileSample> currentTileWindow() const;
 
-    void update(const vsg::dvec3& eyeWorld, const vsg::dmat4& globeRotation, double equatorialRadiusFt, double polarRadiusFt);
+    // Selects the tiles to draw from the camera: projection and view are the camera's matrices and
+    // viewportHeightPx turns their field of view into pixels for the refinement test.
+    void update(const vsg::dvec3& eyeWorld, const vsg::dmat4& globeRotation, double equatorialRadiusFt, double polarRadiusFt,
+                const vsg::dmat4& projection, const vsg::dmat4& view, double viewportHeightPx);
 
 private:
+    struct MotionSample
+    {
+        std::chrono::steady_clock::time_point time;
+        vsg::dvec3 eyeLocal; // globe frame, feet
+    };
+
     bool computeSubCameraGeo(const vsg::dvec3& eyeWorld, const vsg::dmat4& globeRotation, double equatorialRadiusFt, double polarRadiusFt,
                              double& outLatDeg, double& outLonDeg, double& outAltitudeFt) const;
-    int chooseZoomForAltitude(double altitudeFt) const;
-    void requestVisibleTiles(double latDeg, double lonDeg, int zoom);
-    void fetchAndDecodeBudgeted();
+    size_t maxSelectedTiles() const;
+    // Quadtree traversal of the tile pyramid, largest projected tiles first: a tile is refined
+    // while it is too coarse for its screen size and the tile cap allows, and dropped when it is
+    // outside the frustum or behind the horizon. viewProjectionLocal maps globe-frame positions
+    // to clip space.
+    void selectTiles(const vsg::dvec3& eyeLocal, const vsg::dmat4& viewProjectionLocal, double pixelsPerRadian, std::set<TileKey>& out) const;
+    void updateVisibleTiles(const vsg::dvec3& eyeLocal, const vsg::dmat4& viewProjectionLocal, double pixelsPerRadian);
+    void recordMotion(const vsg::dvec3& eyeLocal);
+    void predictTiles(const vsg::dmat4& globeRotation, const vsg::dmat4& viewProjectionLocal, double pixelsPerRadian);
+    void scheduleMissingTiles();
+    void drainCompletedTiles();
 
     vsg::ref_ptr<vsg::Options> options_;
     Config cfg_{};
     bool enabled_ = false;
     bool active_ = false;
     int currentZoom_ = 0;
-    int currentCenterTileX_ = 0;
-    int currentCenterTileY_ = 0;
-    int currentTileRadius_ = 0;
     double currentLatDeg_ = 0.0;
     double currentLonDeg_ = 0.0;
     double currentAltitudeFt_ = 0.0;
+    double equatorialRadiusFt_ = 0.0;
+    double polarRadiusFt_ = 0.0;
     std::set<TileKey> visibleTiles_{};
-    std::map<TileKey, TileEntry> tileCache_{};
+    std::set<TileKey> ancestorTiles_{};
+    std::set<TileKey> predictedTiles_{};
+    std::deque<MotionSample> motionHistory_{};
+    double predictedU_ = 0.0;
+    double predictedV_ = 0.0;
+    double predictedAltitudeFt_ = 0.0;
+    OsmTileCache tileCache_;
+    std::unique_ptr<OsmTilePipeline> pipeline_;
+    uint64_t completedTileCount_ = 0;
+    const char* tileSourceName_ = "";
 };
 
 } // namespace vkglobe
@@ -0,0 +1,415 @@
+#include "vkglobe/OsmTilePipeline.h"
+
+#include <vsg/core/Array2D.h>
+#include <vsg/io/read.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <system_error>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace vkglobe {
+
+namespace {
+
+// The per-file layout the pipeline used before OsmTileStore: cacheRoot/z/x/y.png.
+bool hasPerFileTiles(const std::filesystem::path& cacheRoot)
+{
+    std::error_code ec;
+    for (auto it = std::filesystem::directory_iterator(cacheRoot, ec); !ec && it != std::filesystem::directory_iterator(); it.increment(ec))
+    {
+        const std::string name = it->path().filename().string();
+        if (it->is_directory(ec) && !name.empty() && std::all_of(name.begin(), name.end(), [](char c) { return c >= '0' && c <= '9'; }))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Decoded store payload: this header, then width * height RGBA pixels, rows top to bottom.
+struct DecodedTileHeader
+{
+    uint32_t magic = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t format = 0; // VkFormat of the RGBA pixels
+};
+
+constexpr uint32_t kDecodedTileMagic = 0x54444b56; // "VKDT"
+
+// Identifies the stored PNG record a decoded copy was made from: its record time (a changed tile is
+// written as a new record), size and an FNV-1a hash of its validators. Taken from the record header,
+// so it never needs the PNG itself.
+std::string recordVersion(const OsmTileStore::TileInfo& info)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const std::string* text : {&info.validators.etag, &info.validators.lastModified})
+    {
+        for (const char c : *text)
+        {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 0x100000001b3ull;
+        }
+        hash *= 0x100000001b3ull; // separator, so "ab" + "" differs from "a" + "b"
+    }
+    std::ostringstream out;
+    out << std::chrono::duration_cast<std::chrono::seconds>(info.recordedAt.time_since_epoch()).count() << '-' << info.dataBytes << '-' << std::hex
+        << hash;
+    return out.str();
+}
+
+double threadCpuTimeMs()
+{
+#if defined(_WIN32)
+    FILETIME creation{}, exit{}, kernel{}, user{};
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) return 0.0;
+    const auto ticks = [](const FILETIME& t) { return (static_cast<uint64_t>(t.dwHighDateTime) << 32) | t.dwLowDateTime; };
+    return static_cast<double>(ticks(kernel) + ticks(user)) * 1.0e-4; // 100 ns ticks
+#else
+    timespec now{};
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) != 0) return 0.0;
+    return static_cast<double>(now.tv_sec) * 1.0e3 + static_cast<double>(now.tv_nsec) * 1.0e-6;
+#endif
+}
+
+VkFormat rgbaFormatFor(VkFormat format)
+{
+    switch (format)
+    {
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_R8G8B8_UNORM:
+        return VK_FORMAT_R8G8B8A8_UNORM;
+    case VK_FORMAT_R8G8B8A8_SRGB:
+    case VK_FORMAT_R8G8B8_SRGB:
+        return VK_FORMAT_R8G8B8A8_SRGB;
+    default:
+        return VK_FORMAT_UNDEFINED;
+    }
+}
+
+// image in the layout OsmTilePipeline hands out (see kTilePixels): RGB expanded to RGBA, rows
+// flipped to top to bottom, nearest scaling to the tile size. Null for any other format.
+vsg::ref_ptr<vsg::Data> toTileImage(vsg::ref_ptr<vsg::Data> image)
+{
+    constexpr uint32_t size = OsmTilePipeline::kTilePixels;
+    const VkFormat format = rgbaFormatFor(image->properties.format);
+    const size_t channels = image->valueSize();
+    const uint32_t srcWidth = image->width();
+    const uint32_t srcHeight = image->height();
+    if (format == VK_FORMAT_UNDEFINED || (channels != 3 && channels != 4) || srcWidth == 0 || srcHeight == 0 || image->depth() != 1 ||
+        !image->dataPointer() || image->dataSize() != size_t{srcWidth} * srcHeight * channels)
+    {
+        return {};
+    }
+    if (channels == 4 && srcWidth == size && srcHeight == size && image->properties.origin == vsg::TOP_LEFT) return image;
+
+    auto tile = vsg::ubvec4Array2D::create(size, size, vsg::Data::Properties{format});
+    const auto* src = static_cast<const uint8_t*>(image->dataPointer());
+    const bool flip = image->properties.origin != vsg::TOP_LEFT;
+    auto* out = static_cast<uint8_t*>(tile->dataPointer());
+    for (uint32_t y = 0; y < size; ++y)
+    {
+        uint32_t sy = static_cast<uint32_t>(uint64_t{y} * srcHeight / size);
+        if (flip) sy = srcHeight - 1 - sy;
+        const uint8_t* row = src + size_t{sy} * srcWidth * channels;
+        for (uint32_t x = 0; x < size; ++x, out += 4)
+        {
+            const uint8_t* p = row + static_cast<size_t>(uint64_t{x} * srcWidth / size) * channels;
+            out[0] = p[0];
+            out[1] = p[1];
+            out[2] = p[2];
+            out[3] = channels == 4 ? p[3] : 255;
+        }
+    }
+    return tile;
+}
+
+} // namespace
+
+OsmTilePipeline::OsmTilePipeline(vsg::ref_ptr<vsg::Options> options, Config cfg, std::unique_ptr<TileSource> source) :
+    decodeOptions_(options ? vsg::Options::create(*options) : vsg::Options::create()),
+    cfg_(std::move(cfg)),
+    source_(std::move(source)),
+    store_(cfg_.cacheRoot)
+{
+    // Tiles are decoded from memory, so the reader is picked by extension hint instead of path.
+    decodeOptions_->extensionHint = ".png";
+    if (cfg_.decodedCacheBytes > 0 && store_.isOpen())
+    {
+        // Decoded tiles are ~256 KiB each; batch a few per write.
+        decodedStore_ = std::make_unique<OsmTileStore>(cfg_.cacheRoot / "decoded", size_t{4} << 20);
+        if (!decodedStore_->isOpen()) decodedStore_.reset();
+    }
+    if (store_.stats().tiles == 0 && hasPerFileTiles(cfg_.cacheRoot))
+    {
+        std::cerr << "[OSM] '" << cfg_.cacheRoot.string() << "' holds per-file tiles; pack them with --osm-import-cache "
+                  << cfg_.cacheRoot.string() << "\n";
+    }
+
+    const int fetchThreads = std::max(1, cfg_.fetchThreads);
+    const int decodeThreads = std::max(1, cfg_.decodeThreads);
+    workers_.reserve(static_cast<size_t>(fetchThreads + decodeThreads));
+    for (int i = 0; i < fetchThreads; ++i) workers_.emplace_back([this]() { fetchLoop(); });
+    for (int i = 0; i < decodeThreads; ++i) workers_.emplace_back([this]() { decodeLoop(); });
+}
+
+OsmTilePipeline::~OsmTilePipeline()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    fetchReady_.notify_all();
+    decodeReady_.notify_all();
+    for (auto& worker : workers_) worker.join();
+}
+
+size_t OsmTilePipeline::schedule(std::span<const TileKey> keys)
+{
+    size_t cancelled = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::unordered_set<TileKey, TileKeyHash> wanted(keys.begin(), keys.end());
+        for (const TileKey& key : fetchQueue_)
+        {
+            if (!wanted.contains(key)) ++cancelled;
+        }
+        cancelledCount_ += cancelled;
+
+        fetchQueue_.clear();
+        for (const TileKey& key : keys)
+        {
+            if (!inFlight_.contains(key)) fetchQueue_.push_back(key);
+        }
+        if (fetchQueue_.empty()) return cancelled;
+    }
+    fetchReady_.notify_all();
+    return cancelled;
+}
+
+bool OsmTilePipeline::popCompleted(Result& out)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (completed_.empty()) return false;
+    out = std::move(completed_.front());
+    completed_.pop_front();
+    inFlight_.erase(out.key);
+    return true;
+}
+
+size_t OsmTilePipeline::inFlightCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fetchQueue_.size() + inFlight_.size();
+}
+
+uint64_t OsmTilePipeline::cancelledCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cancelledCount_;
+}
+
+OsmDecodeStats OsmTilePipeline::decodeStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return decodeStats_;
+}
+
+bool OsmTilePipeline::fetchIntoStore(const TileKey& key, DecodeJob& job)
+{
+    OsmTileStore::TileInfo info;
+    const bool cached = store_.readInfo(key, info);
+    if (!cached || std::chrono::system_clock::now() - info.storedAt >= cfg_.revalidateAfter)
+    {
+        TileFetchResult fetched = source_->fetch(key, cached ? info.validators : TileValidators{});
+        switch (fetched.status)
+        {
+        case TileFetchResult::Status::NotModified:
+            (void)store_.touch(key, fetched.validators.empty() ? info.validators : fetched.validators);
+            break;
+        case TileFetchResult::Status::Ok:
+            store_.put(key, fetched.bytes, fetched.validators);
+            job.bytes = std::move(fetched.bytes);
+            break;
+        case TileFetchResult::Status::Failed:
+            std::cerr << "[OSM] " << source_->name() << " fetch z=" << key.z << " x=" << key.x << " y=" << key.y << " failed after "
+                      << fetched.attempts << " attempt(s): " << fetched.error << (cached ? " (using stale cache)" : "") << "\n";
+            if (!cached) return false;
+            break;
+        }
+    }
+
+    if (decodedStore_)
+    {
+        // touch() and put() may have written a new record since the first look.
+        if (store_.readInfo(key, info)) job.version = recordVersion(info);
+        if (!job.version.empty()) return true;
+    }
+    if (job.bytes.empty())
+    {
+        OsmTileStore::Tile stored;
+        if (!store_.read(key, stored)) return false;
+        job.bytes = std::move(stored.bytes);
+    }
+    return true;
+}
+
+void OsmTilePipeline::fetchLoop()
+{
+    for (;;)
+    {
+        TileKey key{};
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            fetchReady_.wait(lock, [this]() { return stopping_ || !fetchQueue_.empty(); });
+            if (stopping_) return;
+            key = fetchQueue_.front();
+            fetchQueue_.pop_front();
+            inFlight_.insert(key);
+        }
+
+        DecodeJob job{key, {}, {}};
+        const bool fetched = fetchIntoStore(key, job);
+        bool idle = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (fetched) decodeQueue_.push_back(std::move(job));
+            idle = fetchQueue_.empty();
+        }
+        // Writes are batched by the store; once the queue runs dry, publish what is pending.
+        if (idle) store_.flush();
+        if (!fetched)
+        {
+            complete(Result{key, false, {}});
+            continue;
+        }
+        decodeReady_.notify_one();
+    }
+}
+
+void OsmTilePipeline::decodeLoop()
+{
+    for (;;)
+    {
+        DecodeJob job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            decodeReady_.wait(lock, [this]() { return stopping_ || !decodeQueue_.empty(); });
+            if (stopping_) return;
+            job = std::move(decodeQueue_.front());
+            decodeQueue_.pop_front();
+        }
+
+        const double startMs = threadCpuTimeMs();
+        vsg::ref_ptr<vsg::Data> image = job.version.empty() ? vsg::ref_ptr<vsg::Data>{} : loadDecoded(job.key, job.version);
+        const bool fromCache = image.valid();
+        if (!fromCache)
+        {
+            OsmTileStore::Tile stored;
+            if (job.bytes.empty() && store_.read(job.key, stored)) job.bytes = std::move(stored.bytes);
+            if (!job.bytes.empty())
+            {
+                std::istringstream stream(std::string(job.bytes.begin(), job.bytes.end()));
+                image = vsg::read_cast<vsg::Data>(stream, decodeOptions_);
+                if (image) image = toTileImage(std::move(image));
+            }
+            if (image && !job.version.empty()) storeDecoded(job.key, *image, job.version);
+        }
+        const double elapsedMs = threadCpuTimeMs() - startMs;
+
+        bool idle = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (fromCache)
+            {
+                ++decodeStats_.cacheLoads;
+                decodeStats_.cacheLoadMs += elapsedMs;
+            }
+            else
+            {
+                ++decodeStats_.pngDecodes;
+                decodeStats_.pngDecodeMs += elapsedMs;
+            }
+            idle = decodeQueue_.empty();
+        }
+        complete(Result{job.key, true, std::move(image)});
+        if (idle && decodedStore_) decodedStore_->flush();
+    }
+}
+
+vsg::ref_ptr<vsg::Data> OsmTilePipeline::loadDecoded(const TileKey& key, const std::string& version) const
+{
+    OsmTileStore::TileInfo info;
+    DecodedTileHeader header{};
+    if (!decodedStore_->readInfo(key, info) || info.validators.etag != version ||
+        !decodedStore_->readData(key, 0, std::span(reinterpret_cast<uint8_t*>(&header), sizeof(header))))
+    {
+        return {};
+    }
+    const size_t pixelBytes = size_t{header.width} * header.height * 4;
+    const auto format = static_cast<VkFormat>(header.format);
+    if (header.magic != kDecodedTileMagic || header.width != kTilePixels || header.height != kTilePixels || rgbaFormatFor(format) != format ||
+        info.dataBytes != sizeof(header) + pixelBytes)
+    {
+        return {};
+    }
+
+    // The pixels go from the store straight into the image: one copy.
+    auto image = vsg::ubvec4Array2D::create(header.width, header.height, vsg::Data::Properties{format});
+    if (!decodedStore_->readData(key, sizeof(header), std::span(static_cast<uint8_t*>(image->dataPointer()), pixelBytes))) return {};
+    return image;
+}
+
+void OsmTilePipeline::storeDecoded(const TileKey& key, const vsg::Data& image, const std::string& version)
+{
+    // image comes from toTileImage(), so its pixels are stored as they are.
+    const size_t pixelBytes = size_t{kTilePixels} * kTilePixels * 4;
+    const size_t payloadBytes = sizeof(DecodedTileHeader) + pixelBytes;
+    if (payloadBytes > cfg_.decodedCacheBytes || decodedFull_) return;
+
+    std::vector<uint8_t> payload(payloadBytes);
+    const DecodedTileHeader header{kDecodedTileMagic, kTilePixels, kTilePixels, static_cast<uint32_t>(image.properties.format)};
+    std::memcpy(payload.data(), &header, sizeof(header));
+    std::memcpy(payload.data() + sizeof(header), image.dataPointer(), pixelBytes);
+    decodedStore_->put(key, payload, TileValidators{version, {}});
+    if (decodedStore_->stats().packBytes > cfg_.decodedCacheBytes) trimDecoded();
+}
+
+void OsmTilePipeline::trimDecoded()
+{
+    std::unique_lock<std::mutex> lock(trimMutex_, std::try_to_lock);
+    if (!lock.owns_lock()) return;
+    const OsmTileStoreStats before = decodedStore_->stats();
+    if (before.packBytes <= cfg_.decodedCacheBytes) return;
+
+    // Down to three quarters, so the next compaction is a quarter of the budget away.
+    if (!decodedStore_->compact(cfg_.decodedCacheBytes / 4 * 3))
+    {
+        std::cerr << "[OSM] warning: failed to compact the decoded tile cache; it will not grow further\n";
+        decodedFull_ = true;
+        return;
+    }
+    const OsmTileStoreStats after = decodedStore_->stats();
+    std::cerr << "[OSM] compacted decoded tile cache tiles=" << before.tiles << "->" << after.tiles << " pack_bytes=" << before.packBytes << "->"
+              << after.packBytes << "\n";
+}
+
+void OsmTilePipeline::complete(Result result)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    completed_.push_back(std::move(result));
+}
+
+} // namespace vkglobe
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "vkglobe/OsmTileKey.h"
+#include "vkglobe/OsmTileSource.h"
+#include "vkglobe/OsmTileStore.h"
+
+#include <vsg/core/Data.h>
+#include <vsg/io/Options.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace vkglobe {
+
+// Thread CPU time the decode workers spent per tile, split by where the pixels came from. PNG
+// decodes include the conversion to the tile layout and writing the decoded copy when the decoded
+// cache is on.
+struct OsmDecodeStats
+{
+    uint64_t pngDecodes = 0;
+    double pngDecodeMs = 0.0;
+    uint64_t cacheLoads = 0;
+    double cacheLoadMs = 0.0;
+};
+
+// Staged background loading of OSM tiles: priority queue -> fetch workers (OsmTileStore, or the
+// TileSource into the store) -> decode workers (PNG bytes -> vsg::Data) -> completion queue. The
+// render thread only calls schedule() and popCompleted(); nothing here blocks on the network, the
+// disk or decoding.
+//
+// Stored tiles older than revalidateAfter are revalidated with their stored ETag/Last-Modified;
+// if the source is unreachable the stale copy is used.
+//
+// Decoded tiles are kept as RGBA pixels in a second store under cacheRoot/decoded, tagged with the
+// record time and size of the stored PNG they came from. A stored tile is PNG-decoded once; later
+// loads check the tag against the PNG's record header and read the pixels straight into the image,
+// without reading the PNG. A decoded copy whose tag no longer matches is decoded again and replaced.
+// When the decoded store outgrows its budget it is compacted, which drops the replaced copies and
+// then the tiles decoded longest ago.
+class OsmTilePipeline
+{
+public:
+    // Every decoded image is kTilePixels square, 8-bit RGBA, rows top to bottom: the layout of a
+    // tile texture array layer, so the render thread uploads it with a plain copy. The decode
+    // workers convert (and, for the odd server sending another size, scale) what the PNG holds.
+    static constexpr uint32_t kTilePixels = 256;
+
+    struct Config
+    {
+        std::filesystem::path cacheRoot = "cache/osm";
+        int fetchThreads = 4;
+        int decodeThreads = 2;
+        std::chrono::hours revalidateAfter{24 * 7};
+        // Disk budget of the decoded store; 0 disables it. Once its pack grows past this, it is
+        // compacted down to three quarters of it.
+        uint64_t decodedCacheBytes = uint64_t{1} << 30;
+    };
+
+    struct Result
+    {
+        TileKey key;
+        bool fetched = false;
+        vsg::ref_ptr<vsg::Data> image; // null when the fetch or the decode failed, or the PNG is not 8-bit RGB(A)
+    };
+
+    OsmTilePipeline(vsg::ref_ptr<vsg::Options> options, Config cfg, std::unique_ptr<TileSource> source);
+    ~OsmTilePipeline();
+
+    OsmTilePipeline(const OsmTilePipeline&) = delete;
+    OsmTilePipeline& operator=(const OsmTilePipeline&) = delete;
+
+    // Replaces the waiting queue with keys, most important first; keys must be unique. Waiting
+    // requests missing from keys are cancelled and counted, tiles already being fetched or decoded
+    // run to completion. Returns the number cancelled by this call.
+    size_t schedule(std::span<const TileKey> keys);
+    bool popCompleted(Result& out);
+    // Waiting plus started tiles.
+    size_t inFlightCount() const;
+    uint64_t cancelledCount() const;
+    OsmTileStoreStats storeStats() const { return store_.stats(); }
+    OsmDecodeStats decodeStats() const;
+
+private:
+    struct DecodeJob
+    {
+        TileKey key;
+        // Left empty for a stored tile while the decoded cache is on; read only on a cache miss.
+        std::vector<uint8_t> bytes;
+        std::string version; // of the stored record, when the decoded cache is on
+    };
+
+    bool fetchIntoStore(const TileKey& key, DecodeJob& job);
+    void fetchLoop();
+    void decodeLoop();
+    vsg::ref_ptr<vsg::Data> loadDecoded(const TileKey& key, const std::string& version) const;
+    void storeDecoded(const TileKey& key, const vsg::Data& image, const std::string& version);
+    void trimDecoded();
+    void complete(Result result);
+
+    vsg::ref_ptr<vsg::Options> decodeOptions_;
+    Config cfg_{};
+    std::unique_ptr<TileSource> source_;
+    OsmTileStore store_;
+    std::unique_ptr<OsmTileStore> decodedStore_; // null when the decoded cache is off
+    // Held by the decode worker compacting decodedStore_; the others skip compaction meanwhile.
+    std::mutex trimMutex_;
+    // Set when a compaction failed (e.g. the disk is full); the decoded store then stops growing.
+    std::atomic<bool> decodedFull_{false};
+
+    mutable std::mutex mutex_;
+    std::condition_variable fetchReady_;
+    std::condition_variable decodeReady_;
+    std::deque<TileKey> fetchQueue_;
+    std::deque<DecodeJob> decodeQueue_;
+    std::deque<Result> completed_;
+    // Taken off fetchQueue_ and not handed back by popCompleted() yet, so schedule() cannot
+    // queue a tile whose result is still waiting to be drained.
+    std::unordered_set<TileKey, TileKeyHash> inFlight_;
+    uint64_t cancelledCount_ = 0;
+    OsmDecodeStats decodeStats_{};
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
+
+} // namespace vkglobe
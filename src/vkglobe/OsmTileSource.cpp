@@ -0,0 +1,437 @@
+#include "vkglobe/OsmTileSource.h"
+
+#if defined(VKGLOBE_HAS_LIBCURL)
+#include <curl/curl.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+namespace vkglobe {
+
+namespace {
+
+std::string hostOf(const std::string& url)
+{
+    const size_t schemeEnd = url.find("://");
+    if (schemeEnd == std::string::npos) return {};
+    const size_t hostBegin = schemeEnd + 3;
+    return url.substr(hostBegin, url.find('/', hostBegin) - hostBegin);
+}
+
+// Caps concurrent requests per host; fetch workers beyond the cap wait here.
+class HostLimiter
+{
+public:
+    explicit HostLimiter(int maxPerHost) : maxPerHost_(std::max(1, maxPerHost)) {}
+
+    void acquire(const std::string& host)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        released_.wait(lock, [&]() { return active_[host] < maxPerHost_; });
+        ++active_[host];
+    }
+
+    void release(const std::string& host)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --active_[host];
+        }
+        released_.notify_all();
+    }
+
+private:
+    const int maxPerHost_;
+    std::mutex mutex_;
+    std::condition_variable released_;
+    std::map<std::string, int> active_;
+};
+
+class HostSlot
+{
+public:
+    HostSlot(HostLimiter& limiter, std::string host) : limiter_(limiter), host_(std::move(host)) { limiter_.acquire(host_); }
+    ~HostSlot() { limiter_.release(host_); }
+
+    HostSlot(const HostSlot&) = delete;
+    HostSlot& operator=(const HostSlot&) = delete;
+
+private:
+    HostLimiter& limiter_;
+    std::string host_;
+};
+
+#if !defined(_WIN32)
+std::string shellQuote(const std::string& value)
+{
+    std::string quoted = "'";
+    for (char ch : value)
+    {
+        if (ch == '\'')
+            quoted += "'\"'\"'";
+        else
+            quoted += ch;
+    }
+    quoted += "'";
+    return quoted;
+}
+#endif
+
+// Fallback without libcurl: one curl process per tile. No connection reuse and no conditional
+// requests; retries are left to curl's own --retry.
+class CurlProcessTileSource final : public TileSource
+{
+public:
+    explicit CurlProcessTileSource(TileSourceConfig cfg) : cfg_(std::move(cfg)), limiter_(cfg_.maxConnectionsPerHost) {}
+
+    TileFetchResult fetch(const TileKey& key, const TileValidators&) override
+    {
+        const std::string url = osmTileUrl(cfg_.urlTemplate, key.z, key.x, key.y);
+        const std::filesystem::path partFile = std::filesystem::temp_directory_path() /
+                                               ("vkglobe-" + std::to_string(key.z) + "-" + std::to_string(key.x) + "-" + std::to_string(key.y) + "-" +
+                                                std::to_string(nextTempId_.fetch_add(1)) + ".part");
+        std::ostringstream command;
+        command << "curl -L --fail --silent --show-error "
+                << "--connect-timeout " << std::max(1, cfg_.connectTimeoutMs / 1000) << " "
+                << "--max-time " << std::max(1, cfg_.requestTimeoutMs / 1000) << " "
+                << "--retry " << std::max(0, cfg_.maxAttempts - 1) << " ";
+#if defined(_WIN32)
+        command << "-A \"" << cfg_.userAgent << "\" "
+                << "-o \"" << partFile.string() << "\" "
+                << "\"" << url << "\"";
+#else
+        command << "-A " << shellQuote(cfg_.userAgent) << " "
+                << "-o " << shellQuote(partFile.string()) << " "
+                << shellQuote(url);
+#endif
+
+        TileFetchResult result;
+        result.attempts = 1;
+        int rc = 0;
+        {
+            HostSlot slot(limiter_, hostOf(url));
+            rc = std::system(command.str().c_str());
+        }
+        std::error_code ec;
+        if (rc != 0)
+        {
+            std::filesystem::remove(partFile, ec);
+            result.error = "curl exited with " + std::to_string(rc);
+            return result;
+        }
+
+        std::ifstream in(partFile, std::ios::binary);
+        result.bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        in.close();
+        std::filesystem::remove(partFile, ec);
+        result.status = TileFetchResult::Status::Ok;
+        result.httpStatus = 200;
+        return result;
+    }
+
+    const char* name() const override { return "curl-process"; }
+
+private:
+    TileSourceConfig cfg_;
+    HostLimiter limiter_;
+    std::atomic<uint64_t> nextTempId_{0};
+};
+
+#if defined(VKGLOBE_HAS_LIBCURL)
+
+// Exponential backoff with up to 25% jitter, so workers that failed together do not retry in lockstep.
+std::chrono::milliseconds backoffDelay(const TileSourceConfig& cfg, int attempt, int retryAfterMs)
+{
+    thread_local std::minstd_rand rng(static_cast<unsigned>(std::hash<std::thread::id>{}(std::this_thread::get_id())));
+    const int base = std::max(1, cfg.initialBackoffMs) << std::min(attempt, 10);
+    const int jitter = std::uniform_int_distribution<int>(0, base / 4)(rng);
+    constexpr int kMaxDelayMs = 10000;
+    return std::chrono::milliseconds(std::min(kMaxDelayMs, std::max(base + jitter, retryAfterMs)));
+}
+
+struct HttpResponse
+{
+    std::vector<uint8_t> bytes;
+    TileValidators validators;
+    int retryAfterMs = 0;
+};
+
+size_t writeBody(char* data, size_t size, size_t count, void* user)
+{
+    auto* response = static_cast<HttpResponse*>(user);
+    response->bytes.insert(response->bytes.end(), data, data + size * count);
+    return size * count;
+}
+
+bool headerIs(const std::string& line, const char* name, std::string& value)
+{
+    const size_t nameLength = std::char_traits<char>::length(name);
+    if (line.size() <= nameLength || line[nameLength] != ':') return false;
+    for (size_t i = 0; i < nameLength; ++i)
+    {
+        if (std::tolower(static_cast<unsigned char>(line[i])) != std::tolower(static_cast<unsigned char>(name[i]))) return false;
+    }
+    size_t begin = nameLength + 1;
+    size_t end = line.size();
+    while (begin < end && std::isspace(static_cast<unsigned char>(line[begin]))) ++begin;
+    while (end > begin && std::isspace(static_cast<unsigned char>(line[end - 1]))) --end;
+    value = line.substr(begin, end - begin);
+    return true;
+}
+
+size_t readHeader(char* data, size_t size, size_t count, void* user)
+{
+    auto* response = static_cast<HttpResponse*>(user);
+    const std::string line(data, size * count);
+    std::string value;
+    if (line.rfind("HTTP/", 0) == 0)
+    {
+        // A new status line (after a redirect): drop the previous response's headers.
+        response->validators = TileValidators{};
+        response->retryAfterMs = 0;
+    }
+    else if (headerIs(line, "ETag", value))
+    {
+        response->validators.etag = value;
+    }
+    else if (headerIs(line, "Last-Modified", value))
+    {
+        response->validators.lastModified = value;
+    }
+    else if (headerIs(line, "Retry-After", value))
+    {
+        response->retryAfterMs = std::atoi(value.c_str()) * 1000;
+    }
+    return size * count;
+}
+
+bool isRetryable(CURLcode rc)
+{
+    switch (rc)
+    {
+    case CURLE_UNSUPPORTED_PROTOCOL:
+    case CURLE_URL_MALFORMAT:
+    case CURLE_FILE_COULDNT_READ_FILE:
+    case CURLE_REMOTE_FILE_NOT_FOUND:
+    case CURLE_TOO_MANY_REDIRECTS:
+        return false;
+    default:
+        return true;
+    }
+}
+
+// libcurl easy handles are pooled and reused. Each keeps its connections alive, so after warmup
+// a fetch is one request on an open TLS connection instead of a process spawn and a handshake.
+class HttpTileSource final : public TileSource
+{
+public:
+    explicit HttpTileSource(TileSourceConfig cfg) : cfg_(std::move(cfg)), limiter_(cfg_.maxConnectionsPerHost)
+    {
+        static std::once_flag globalInit;
+        std::call_once(globalInit, []() { curl_global_init(CURL_GLOBAL_DEFAULT); });
+    }
+
+    ~HttpTileSource() override
+    {
+        for (CURL* handle : idleHandles_) curl_easy_cleanup(handle);
+    }
+
+    TileFetchResult fetch(const TileKey& key, const TileValidators& cached) override
+    {
+        const std::string url = osmTileUrl(cfg_.urlTemplate, key.z, key.x, key.y);
+        const std::string host = hostOf(url);
+        const int maxAttempts = std::max(1, cfg_.maxAttempts);
+
+        TileFetchResult result;
+        for (int attempt = 0; attempt < maxAttempts; ++attempt)
+        {
+            result = TileFetchResult{};
+            result.attempts = attempt + 1;
+            HttpResponse response;
+            CURLcode rc = CURLE_OK;
+            long httpStatus = 0;
+            {
+                HostSlot slot(limiter_, host);
+                CURL* curl = acquireHandle();
+                if (!curl)
+                {
+                    result.error = "curl_easy_init failed";
+                    return result;
+                }
+                curl_slist* headers = nullptr;
+                if (!cached.etag.empty()) headers = curl_slist_append(headers, ("If-None-Match: " + cached.etag).c_str());
+                if (!cached.lastModified.empty()) headers = curl_slist_append(headers, ("If-Modified-Since: " + cached.lastModified).c_str());
+
+                // Reset keeps the handle's live connections and DNS cache.
+                curl_easy_reset(curl);
+                curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+                curl_easy_setopt(curl, CURLOPT_USERAGENT, cfg_.userAgent.c_str());
+                curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+                curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+                curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+                curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, static_cast<long>(cfg_.connectTimeoutMs));
+                curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, static_cast<long>(cfg_.requestTimeoutMs));
+                curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+                curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &writeBody);
+                curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+                curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, &readHeader);
+                curl_easy_setopt(curl, CURLOPT_HEADERDATA, &response);
+                rc = curl_easy_perform(curl);
+                curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpStatus);
+                curl_easy_setopt(curl, CURLOPT_HTTPHEADER, nullptr);
+                curl_slist_free_all(headers);
+                releaseHandle(curl);
+            }
+
+            result.httpStatus = httpStatus;
+            bool retry = false;
+            if (rc != CURLE_OK)
+            {
+                result.error = curl_easy_strerror(rc);
+                retry = isRetryable(rc);
+            }
+            else if (httpStatus == 304)
+            {
+                result.status = TileFetchResult::Status::NotModified;
+                result.validators = std::move(response.validators);
+                return result;
+            }
+            else if (httpStatus == 200 || httpStatus == 0) // 0: file:// URLs have no status
+            {
+                result.status = TileFetchResult::Status::Ok;
+                result.bytes = std::move(response.bytes);
+                result.validators = std::move(response.validators);
+                return result;
+            }
+            else
+            {
+                result.error = "HTTP " + std::to_string(httpStatus);
+                retry = (httpStatus == 429 || httpStatus >= 500);
+            }
+
+            if (!retry) return result;
+            if (attempt + 1 < maxAttempts) std::this_thread::sleep_for(backoffDelay(cfg_, attempt, response.retryAfterMs));
+        }
+        return result;
+    }
+
+    const char* name() const override { return "libcurl"; }
+
+private:
+    CURL* acquireHandle()
+    {
+        {
+            std::lock_guard<std::mutex> lock(handleMutex_);
+            if (!idleHandles_.empty())
+            {
+                CURL* handle = idleHandles_.back();
+                idleHandles_.pop_back();
+                return handle;
+            }
+        }
+        return curl_easy_init();
+    }
+
+    void releaseHandle(CURL* handle)
+    {
+        std::lock_guard<std::mutex> lock(handleMutex_);
+        idleHandles_.push_back(handle);
+    }
+
+    TileSourceConfig cfg_;
+    HostLimiter limiter_;
+    std::mutex handleMutex_;
+    std::vector<CURL*> idleHandles_;
+};
+
+#endif // VKGLOBE_HAS_LIBCURL
+
+// Delays a fast source (a file:// directory or a localhost server) to look like a real link: each
+// response arrives one latency after its request, and response bodies go over the link one at a
+// time at the configured bandwidth. Latency is waited out before the inner fetch; the inner
+// fetch's own time is not subtracted.
+class SimulatedLinkTileSource final : public TileSource
+{
+public:
+    SimulatedLinkTileSource(std::unique_ptr<TileSource> inner, int latencyMs, uint64_t bytesPerSecond) :
+        inner_(std::move(inner)),
+        latency_(std::max(0, latencyMs)),
+        bytesPerSecond_(bytesPerSecond),
+        name_(std::string("simulated ") + inner_->name())
+    {
+    }
+
+    TileFetchResult fetch(const TileKey& key, const TileValidators& cached) override
+    {
+        std::this_thread::sleep_for(latency_);
+        TileFetchResult result = inner_->fetch(key, cached);
+        if (bytesPerSecond_ == 0 || result.bytes.empty()) return result;
+
+        const auto transfer = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(static_cast<double>(result.bytes.size()) / static_cast<double>(bytesPerSecond_)));
+        std::chrono::steady_clock::time_point arrival;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            linkFreeAt_ = std::max(linkFreeAt_, std::chrono::steady_clock::now()) + transfer;
+            arrival = linkFreeAt_;
+        }
+        std::this_thread::sleep_until(arrival);
+        return result;
+    }
+
+    const char* name() const override { return name_.c_str(); }
+
+private:
+    std::unique_ptr<TileSource> inner_;
+    const std::chrono::milliseconds latency_;
+    const uint64_t bytesPerSecond_;
+    const std::string name_;
+    std::mutex mutex_;
+    std::chrono::steady_clock::time_point linkFreeAt_{};
+};
+
+} // namespace
+
+std::string osmTileUrl(const std::string& urlTemplate, int zoom, int x, int y)
+{
+    std::string url = urlTemplate;
+    const std::pair<const char*, int> fields[] = {{"{z}", zoom}, {"{x}", x}, {"{y}", y}};
+    for (const auto& [field, value] : fields)
+    {
+        for (size_t pos = url.find(field); pos != std::string::npos; pos = url.find(field, pos))
+        {
+            const std::string text = std::to_string(value);
+            url.replace(pos, 3, text);
+            pos += text.size();
+        }
+    }
+    return url;
+}
+
+std::unique_ptr<TileSource> createOsmTileSource(const TileSourceConfig& cfg)
+{
+#if defined(VKGLOBE_HAS_LIBCURL)
+    std::unique_ptr<TileSource> source = std::make_unique<HttpTileSource>(cfg);
+#else
+    std::unique_ptr<TileSource> source = std::make_unique<CurlProcessTileSource>(cfg);
+#endif
+    if (cfg.simulatedLatencyMs <= 0 && cfg.simulatedBytesPerSecond == 0) return source;
+    return std::make_unique<SimulatedLinkTileSource>(std::move(source), cfg.simulatedLatencyMs, cfg.simulatedBytesPerSecond);
+}
+
+} // namespace vkglobe
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "vkglobe/OsmTileKey.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace vkglobe {
+
+inline constexpr const char* kDefaultOsmTileUrlTemplate = "https://tile.openstreetmap.org/{z}/{x}/{y}.png";
+
+// Expands {z}, {x} and {y} in urlTemplate.
+std::string osmTileUrl(const std::string& urlTemplate, int zoom, int x, int y);
+
+// Cache validators from an earlier response, sent back as If-None-Match / If-Modified-Since.
+struct TileValidators
+{
+    std::string etag;
+    std::string lastModified;
+
+    bool empty() const { return etag.empty() && lastModified.empty(); }
+};
+
+struct TileFetchResult
+{
+    enum class Status
+    {
+        Ok,          // bytes holds the tile
+        NotModified, // the cached copy matching the validators is still current
+        Failed,
+    };
+
+    Status status = Status::Failed;
+    long httpStatus = 0;
+    int attempts = 0;
+    std::vector<uint8_t> bytes;
+    TileValidators validators;
+    std::string error;
+};
+
+struct TileSourceConfig
+{
+    // Any URL the client understands; file:// templates and localhost servers stand in for the
+    // public tile server in tests and benchmarks.
+    std::string urlTemplate = kDefaultOsmTileUrlTemplate;
+    std::string userAgent = "vkglobe/0.1 (tile prototype)";
+    int maxConnectionsPerHost = 2;
+    int maxAttempts = 3;
+    int initialBackoffMs = 250;
+    int connectTimeoutMs = 5000;
+    int requestTimeoutMs = 20000;
+    // Benchmarks only: every fetch is delayed as if it crossed a link with this round-trip latency
+    // and this much bandwidth, shared by all fetches. 0 leaves that part out.
+    int simulatedLatencyMs = 0;
+    uint64_t simulatedBytesPerSecond = 0;
+};
+
+// Where tiles come from. fetch() blocks and is called concurrently from the pipeline's fetch
+// workers; implementations do their own connection reuse, throttling and retries.
+class TileSource
+{
+public:
+    virtual ~TileSource() = default;
+
+    virtual TileFetchResult fetch(const TileKey& key, const TileValidators& cached) = 0;
+    virtual const char* name() const = 0;
+};
+
+// In-process HTTP client (libcurl, keep-alive handle pool) when built with VKGLOBE_HAS_LIBCURL,
+// otherwise one curl process per tile; wrapped in the simulated link when one is configured.
+std::unique_ptr<TileSource> createOsmTileSource(const TileSourceConfig& cfg);
+
+} // namespace vkglobe
@@ -0,0 +1,643 @@
+#include "vkglobe/OsmTileStore.h"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <system_error>
+#include <utility>
+
+namespace vkglobe {
+
+namespace {
+
+constexpr char kPackMagic[8] = {'V', 'K', 'T', 'P', 'A', 'C', 'K', '1'};
+constexpr char kIndexMagic[8] = {'V', 'K', 'T', 'I', 'D', 'X', '0', '1'};
+constexpr uint32_t kRecordMagic = 0x52544B56; // "VKTR"
+constexpr uint64_t kMinIndexCapacity = 4096;
+// Far above any encoded or decoded tile. A larger record size read from disk means corruption, and
+// is rejected before anything is allocated for it.
+constexpr uint64_t kMaxRecordBytes = uint64_t{16} << 20;
+
+struct PackHeader
+{
+    char magic[8];
+    uint64_t packId;
+};
+
+// packId ties an index to the pack it was built from; packBytes is the published end of the pack,
+// anything after it is an unfinished batch and is truncated on open.
+struct IndexHeader
+{
+    char magic[8];
+    uint64_t packId;
+    uint64_t capacity;
+    uint64_t count;
+    uint64_t packBytes;
+    uint64_t liveBytes;
+    uint64_t reserved[2];
+};
+
+struct IndexSlot
+{
+    uint64_t key; // packed TileKey + 1, 0 marks an empty slot
+    uint64_t offset;
+    uint32_t recordBytes;
+    uint32_t reserved;
+    int64_t storedAt;
+};
+
+// Followed by etagBytes of ETag, lastModifiedBytes of Last-Modified and dataBytes of tile.
+struct RecordHeader
+{
+    uint32_t magic;
+    uint32_t dataBytes;
+    int32_t z;
+    int32_t x;
+    int32_t y;
+    uint16_t etagBytes;
+    uint16_t lastModifiedBytes;
+    int64_t storedAt;
+};
+
+static_assert(sizeof(PackHeader) == 16);
+static_assert(sizeof(IndexHeader) == 64);
+static_assert(sizeof(IndexSlot) == 32);
+static_assert(sizeof(RecordHeader) == 32);
+
+uint64_t slotKey(const TileKey& key)
+{
+    return ((static_cast<uint64_t>(key.z) << 48) | (static_cast<uint64_t>(static_cast<uint32_t>(key.x)) << 24) |
+            static_cast<uint64_t>(static_cast<uint32_t>(key.y))) +
+           1;
+}
+
+uint64_t mixKey(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+}
+
+size_t indexFileBytes(uint64_t capacity)
+{
+    return sizeof(IndexHeader) + static_cast<size_t>(capacity) * sizeof(IndexSlot);
+}
+
+IndexHeader& indexHeader(const core::io::MappedFile& index)
+{
+    return *reinterpret_cast<IndexHeader*>(index.mutableData());
+}
+
+IndexSlot* indexSlots(const core::io::MappedFile& index)
+{
+    return reinterpret_cast<IndexSlot*>(index.mutableData() + sizeof(IndexHeader));
+}
+
+// Linear probing; returns the slot holding key, or the empty slot where it belongs.
+IndexSlot& probe(IndexSlot* slots, uint64_t capacity, uint64_t key)
+{
+    const uint64_t mask = capacity - 1;
+    for (uint64_t i = mixKey(key) & mask;; i = (i + 1) & mask)
+    {
+        if (slots[i].key == key || slots[i].key == 0) return slots[i];
+    }
+}
+
+IndexSlot* findSlot(const core::io::MappedFile& index, const TileKey& key)
+{
+    IndexSlot& slot = probe(indexSlots(index), indexHeader(index).capacity, slotKey(key));
+    return slot.key == 0 ? nullptr : &slot;
+}
+
+bool createIndex(const std::filesystem::path& file, uint64_t capacity, uint64_t packId, core::io::MappedFile& out)
+{
+    std::error_code ec;
+    std::filesystem::remove(file, ec);
+    if (!out.openWritable(file, indexFileBytes(capacity))) return false;
+    IndexHeader& header = indexHeader(out);
+    std::memcpy(header.magic, kIndexMagic, sizeof(kIndexMagic));
+    header.packId = packId;
+    header.capacity = capacity;
+    header.packBytes = sizeof(PackHeader);
+    return true;
+}
+
+int64_t toStoreTime(std::chrono::system_clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+}
+
+std::chrono::system_clock::time_point fromStoreTime(int64_t seconds)
+{
+    return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::seconds(seconds)));
+}
+
+bool parseRecord(const uint8_t* record, size_t size, const TileKey& key, OsmTileStore::Tile& out)
+{
+    if (size < sizeof(RecordHeader)) return false;
+    RecordHeader header{};
+    std::memcpy(&header, record, sizeof(header));
+    const size_t payload = size_t{header.etagBytes} + header.lastModifiedBytes + header.dataBytes;
+    if (header.magic != kRecordMagic || TileKey{header.z, header.x, header.y} != key || sizeof(RecordHeader) + payload != size) return false;
+
+    const char* text = reinterpret_cast<const char*>(record + sizeof(RecordHeader));
+    out.validators.etag.assign(text, header.etagBytes);
+    out.validators.lastModified.assign(text + header.etagBytes, header.lastModifiedBytes);
+    const uint8_t* data = record + sizeof(RecordHeader) + header.etagBytes + header.lastModifiedBytes;
+    out.bytes.assign(data, data + header.dataBytes);
+    out.storedAt = fromStoreTime(header.storedAt);
+    return true;
+}
+
+bool parseTileNumber(const std::string& text, int& out)
+{
+    const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+    return ec == std::errc() && end == text.data() + text.size() && out >= 0;
+}
+
+} // namespace
+
+OsmTileStore::OsmTileStore(std::filesystem::path root, size_t writeBatchBytes) :
+    root_(std::move(root)),
+    writeBatchBytes_(writeBatchBytes)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::error_code ec;
+    std::filesystem::create_directories(root_, ec);
+    if (!lock_.tryLock(root_ / "tiles.lock"))
+    {
+        std::cerr << "[OSM] warning: tile store '" << root_.string() << "' is in use by another process; tiles will not be cached\n";
+        return;
+    }
+    if (!openFiles()) std::cerr << "[OSM] warning: tile store '" << root_.string() << "' could not be opened; tiles will not be cached\n";
+}
+
+OsmTileStore::~OsmTileStore()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    flushLocked();
+    (void)index_.flush();
+}
+
+bool OsmTileStore::openFiles()
+{
+    std::error_code ec;
+    const std::filesystem::path packFile = root_ / "tiles.pack";
+    const std::filesystem::path indexFile = root_ / "tiles.idx";
+
+    PackHeader packHeader{};
+    {
+        std::ifstream in(packFile, std::ios::binary);
+        in.read(reinterpret_cast<char*>(&packHeader), sizeof(packHeader));
+        if (!in || std::memcmp(packHeader.magic, kPackMagic, sizeof(kPackMagic)) != 0)
+        {
+            in.close();
+            std::memcpy(packHeader.magic, kPackMagic, sizeof(kPackMagic));
+            packHeader.packId = (static_cast<uint64_t>(std::random_device{}()) << 32) ^
+                                static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+            std::ofstream out(packFile, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(&packHeader), sizeof(packHeader));
+            if (!out) return false;
+        }
+    }
+    const uint64_t packSize = std::filesystem::file_size(packFile, ec);
+    if (ec) return false;
+
+    bool indexValid = false;
+    const uint64_t indexSize = std::filesystem::file_size(indexFile, ec);
+    if (!ec && indexSize >= sizeof(IndexHeader) && index_.openWritable(indexFile, static_cast<size_t>(indexSize)))
+    {
+        const IndexHeader& header = indexHeader(index_);
+        indexValid = std::memcmp(header.magic, kIndexMagic, sizeof(kIndexMagic)) == 0 && header.packId == packHeader.packId &&
+                     std::has_single_bit(header.capacity) && indexFileBytes(header.capacity) == indexSize &&
+                     header.packBytes >= sizeof(PackHeader) && header.packBytes <= packSize;
+        if (!indexValid) index_.close();
+    }
+
+    if (indexValid)
+    {
+        // Drop a batch that was appended but never published.
+        if (indexHeader(index_).packBytes < packSize) std::filesystem::resize_file(packFile, indexHeader(index_).packBytes, ec);
+    }
+    else if (!rebuildIndex(packHeader.packId, packSize))
+    {
+        return false;
+    }
+
+    pack_.open(packFile, std::ios::binary | std::ios::in | std::ios::out);
+    if (!pack_)
+    {
+        index_.close();
+        return false;
+    }
+    return true;
+}
+
+bool OsmTileStore::rebuildIndex(uint64_t packId, uint64_t packSize)
+{
+    const std::filesystem::path packFile = root_ / "tiles.pack";
+    if (!createIndex(root_ / "tiles.idx", kMinIndexCapacity, packId, index_)) return false;
+
+    // Later records of a tile replace earlier ones, exactly as when they were written.
+    std::ifstream in(packFile, std::ios::binary);
+    uint64_t offset = sizeof(PackHeader);
+    in.seekg(static_cast<std::streamoff>(offset));
+    RecordHeader record{};
+    while (offset + sizeof(RecordHeader) <= packSize && in.read(reinterpret_cast<char*>(&record), sizeof(record)))
+    {
+        const uint64_t recordBytes = sizeof(RecordHeader) + uint64_t{record.etagBytes} + record.lastModifiedBytes + record.dataBytes;
+        if (record.magic != kRecordMagic || recordBytes > kMaxRecordBytes || offset + recordBytes > packSize) break;
+        if (!insertSlot(TileKey{record.z, record.x, record.y}, offset, static_cast<uint32_t>(recordBytes), record.storedAt)) return false;
+        offset += recordBytes;
+        indexHeader(index_).packBytes = offset;
+        in.seekg(static_cast<std::streamoff>(offset));
+    }
+    in.close();
+
+    std::error_code ec;
+    if (offset < packSize) std::filesystem::resize_file(packFile, offset, ec);
+    if (offset > sizeof(PackHeader))
+    {
+        std::cerr << "[OSM] rebuilt tile index tiles=" << indexHeader(index_).count << " pack_bytes=" << offset << "\n";
+    }
+    return index_.flush();
+}
+
+bool OsmTileStore::growIndex()
+{
+    const IndexHeader& header = indexHeader(index_);
+    const std::filesystem::path indexFile = root_ / "tiles.idx";
+    std::filesystem::path grownFile = indexFile;
+    grownFile += ".grow";
+
+    core::io::MappedFile grown;
+    if (!createIndex(grownFile, header.capacity * 2, header.packId, grown)) return false;
+    IndexHeader& grownHeader = indexHeader(grown);
+    IndexSlot* slots = indexSlots(index_);
+    for (uint64_t i = 0; i < header.capacity; ++i)
+    {
+        if (slots[i].key != 0) probe(indexSlots(grown), grownHeader.capacity, slots[i].key) = slots[i];
+    }
+    grownHeader.count = header.count;
+    grownHeader.packBytes = header.packBytes;
+    grownHeader.liveBytes = header.liveBytes;
+    const size_t grownBytes = grown.size();
+    if (!grown.flush()) return false;
+    grown.close();
+
+    // The rename swaps one complete index for another, so a crash leaves either of them.
+    index_.close();
+    std::error_code ec;
+    std::filesystem::rename(grownFile, indexFile, ec);
+    return !ec && index_.openWritable(indexFile, grownBytes);
+}
+
+bool OsmTileStore::insertSlot(const TileKey& key, uint64_t offset, uint32_t recordBytes, int64_t storedAt)
+{
+    if ((indexHeader(index_).count + 1) * 2 > indexHeader(index_).capacity && !growIndex()) return false;
+
+    IndexHeader& header = indexHeader(index_);
+    IndexSlot& slot = probe(indexSlots(index_), header.capacity, slotKey(key));
+    if (slot.key == 0)
+    {
+        slot.key = slotKey(key);
+        ++header.count;
+    }
+    else
+    {
+        header.liveBytes -= slot.recordBytes;
+    }
+    slot.offset = offset;
+    slot.recordBytes = recordBytes;
+    slot.storedAt = storedAt;
+    header.liveBytes += recordBytes;
+    return true;
+}
+
+bool OsmTileStore::contains(const TileKey& key) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_.isOpen() && (pending_.contains(key) || findSlot(index_, key));
+}
+
+bool OsmTileStore::read(const TileKey& key, Tile& out) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return readLocked(key, out);
+}
+
+bool OsmTileStore::readLocked(const TileKey& key, Tile& out) const
+{
+    if (!index_.isOpen()) return false;
+    const auto pending = pending_.find(key);
+    if (pending != pending_.end())
+    {
+        return parseRecord(pendingRecords_.data() + pending->second.offset, pending->second.recordBytes, key, out);
+    }
+
+    const IndexSlot* slot = findSlot(index_, key);
+    const uint64_t packBytes = indexHeader(index_).packBytes;
+    if (!slot || slot->recordBytes > kMaxRecordBytes || slot->recordBytes > packBytes || slot->offset > packBytes - slot->recordBytes) return false;
+    std::vector<uint8_t> record(slot->recordBytes);
+    pack_.clear();
+    pack_.seekg(static_cast<std::streamoff>(slot->offset));
+    pack_.read(reinterpret_cast<char*>(record.data()), static_cast<std::streamsize>(record.size()));
+    if (!pack_ || !parseRecord(record.data(), record.size(), key, out)) return false;
+    // The slot carries the time of the last revalidation, which can be newer than the record.
+    out.storedAt = fromStoreTime(slot->storedAt);
+    return true;
+}
+
+bool OsmTileStore::readInfo(const TileKey& key, TileInfo& out) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    RecordHeader header{};
+    int64_t storedAt = 0;
+    if (!readRecordBytesLocked(key, 0, std::span(reinterpret_cast<uint8_t*>(&header), sizeof(header)), &storedAt) || header.magic != kRecordMagic ||
+        TileKey{header.z, header.x, header.y} != key)
+    {
+        return false;
+    }
+    std::string text(size_t{header.etagBytes} + header.lastModifiedBytes, '\0');
+    if (!readRecordBytesLocked(key, sizeof(header), std::span(reinterpret_cast<uint8_t*>(text.data()), text.size()), nullptr)) return false;
+    out.validators.etag = text.substr(0, header.etagBytes);
+    out.validators.lastModified = text.substr(header.etagBytes);
+    out.storedAt = fromStoreTime(storedAt);
+    out.recordedAt = fromStoreTime(header.storedAt);
+    out.dataBytes = header.dataBytes;
+    return true;
+}
+
+bool OsmTileStore::readData(const TileKey& key, size_t offset, std::span<uint8_t> out) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    RecordHeader header{};
+    if (!readRecordBytesLocked(key, 0, std::span(reinterpret_cast<uint8_t*>(&header), sizeof(header)), nullptr) || header.magic != kRecordMagic ||
+        TileKey{header.z, header.x, header.y} != key || offset > header.dataBytes || out.size() > header.dataBytes - offset)
+    {
+        return false;
+    }
+    return readRecordBytesLocked(key, sizeof(header) + uint64_t{header.etagBytes} + header.lastModifiedBytes + offset, out, nullptr);
+}
+
+bool OsmTileStore::readRecordBytesLocked(const TileKey& key, uint64_t from, std::span<uint8_t> out, int64_t* storedAt) const
+{
+    if (!index_.isOpen()) return false;
+    const auto pending = pending_.find(key);
+    if (pending != pending_.end())
+    {
+        if (from > pending->second.recordBytes || out.size() > pending->second.recordBytes - from) return false;
+        std::memcpy(out.data(), pendingRecords_.data() + pending->second.offset + from, out.size());
+        if (storedAt) *storedAt = pending->second.storedAt;
+        return true;
+    }
+
+    const IndexSlot* slot = findSlot(index_, key);
+    const uint64_t packBytes = indexHeader(index_).packBytes;
+    if (!slot || slot->recordBytes > packBytes || slot->offset > packBytes - slot->recordBytes || from > slot->recordBytes ||
+        out.size() > slot->recordBytes - from)
+    {
+        return false;
+    }
+    pack_.clear();
+    pack_.seekg(static_cast<std::streamoff>(slot->offset + from));
+    pack_.read(reinterpret_cast<char*>(out.data()), static_cast<std::streamsize>(out.size()));
+    if (!pack_) return false;
+    if (storedAt) *storedAt = slot->storedAt;
+    return true;
+}
+
+void OsmTileStore::put(const TileKey& key, std::span<const uint8_t> bytes, const TileValidators& validators,
+                       std::chrono::system_clock::time_point storedAt)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!index_.isOpen()) return;
+    appendRecord(key, bytes, validators, toStoreTime(storedAt));
+}
+
+void OsmTileStore::appendRecord(const TileKey& key, std::span<const uint8_t> bytes, const TileValidators& validators, int64_t storedAt)
+{
+    // A tile this large would be rejected as corrupt when read back, so it is not stored at all.
+    if (sizeof(RecordHeader) + bytes.size() > kMaxRecordBytes) return;
+    // Validators that do not fit the record are dropped; the tile is then simply refetched in full.
+    const bool keepValidators = validators.etag.size() <= UINT16_MAX && validators.lastModified.size() <= UINT16_MAX;
+    RecordHeader header{};
+    header.magic = kRecordMagic;
+    header.dataBytes = static_cast<uint32_t>(bytes.size());
+    header.z = key.z;
+    header.x = key.x;
+    header.y = key.y;
+    header.etagBytes = keepValidators ? static_cast<uint16_t>(validators.etag.size()) : 0;
+    header.lastModifiedBytes = keepValidators ? static_cast<uint16_t>(validators.lastModified.size()) : 0;
+    header.storedAt = storedAt;
+
+    const size_t offset = pendingRecords_.size();
+    const auto* headerBytes = reinterpret_cast<const uint8_t*>(&header);
+    pendingRecords_.insert(pendingRecords_.end(), headerBytes, headerBytes + sizeof(header));
+    pendingRecords_.insert(pendingRecords_.end(), validators.etag.begin(), validators.etag.begin() + header.etagBytes);
+    pendingRecords_.insert(pendingRecords_.end(), validators.lastModified.begin(), validators.lastModified.begin() + header.lastModifiedBytes);
+    pendingRecords_.insert(pendingRecords_.end(), bytes.begin(), bytes.end());
+    pending_[key] = Pending{offset, static_cast<uint32_t>(pendingRecords_.size() - offset), storedAt};
+
+    if (pendingRecords_.size() >= writeBatchBytes_) flushLocked();
+}
+
+bool OsmTileStore::touch(const TileKey& key, const TileValidators& validators)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Tile tile;
+    if (!readLocked(key, tile)) return false;
+
+    const int64_t now = toStoreTime(std::chrono::system_clock::now());
+    const bool sameValidators = tile.validators.etag == validators.etag && tile.validators.lastModified == validators.lastModified;
+    if (sameValidators && !pending_.contains(key))
+    {
+        findSlot(index_, key)->storedAt = now;
+        return true;
+    }
+    appendRecord(key, tile.bytes, validators, now);
+    return true;
+}
+
+void OsmTileStore::flush()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    flushLocked();
+}
+
+void OsmTileStore::flushLocked()
+{
+    if (pendingRecords_.empty() || !index_.isOpen()) return;
+
+    const uint64_t base = indexHeader(index_).packBytes;
+    pack_.clear();
+    pack_.seekp(static_cast<std::streamoff>(base));
+    pack_.write(reinterpret_cast<const char*>(pendingRecords_.data()), static_cast<std::streamsize>(pendingRecords_.size()));
+    pack_.flush();
+    // The index is a shared mapping the OS may write back at any time, so the records must be on
+    // disk before anything in it points at them.
+    if (!pack_ || !core::io::syncFile(root_ / "tiles.pack"))
+    {
+        std::cerr << "[OSM] warning: failed to append " << pending_.size() << " tile(s) to '" << (root_ / "tiles.pack").string() << "'\n";
+        pack_.clear();
+    }
+    else
+    {
+        // Publish the new end first: slots must never point past it.
+        indexHeader(index_).packBytes = base + pendingRecords_.size();
+        for (const auto& [key, pending] : pending_)
+        {
+            if (!insertSlot(key, base + pending.offset, pending.recordBytes, pending.storedAt)) break;
+        }
+    }
+    pendingRecords_.clear();
+    pending_.clear();
+}
+
+bool OsmTileStore::compact(uint64_t keepBytes)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!index_.isOpen()) return false;
+    flushLocked();
+
+    const IndexHeader& header = indexHeader(index_);
+    std::vector<IndexSlot> live;
+    live.reserve(static_cast<size_t>(header.count));
+    const IndexSlot* slots = indexSlots(index_);
+    for (uint64_t i = 0; i < header.capacity; ++i)
+    {
+        if (slots[i].key != 0) live.push_back(slots[i]);
+    }
+    if (header.liveBytes > keepBytes)
+    {
+        // Newest first, then cut where the budget runs out.
+        std::sort(live.begin(), live.end(), [](const IndexSlot& a, const IndexSlot& b) { return a.storedAt > b.storedAt; });
+        uint64_t keptBytes = 0;
+        size_t kept = 0;
+        while (kept < live.size() && keptBytes + live[kept].recordBytes <= keepBytes) keptBytes += live[kept++].recordBytes;
+        live.resize(kept);
+    }
+    std::sort(live.begin(), live.end(), [](const IndexSlot& a, const IndexSlot& b) { return a.offset < b.offset; });
+
+    const std::filesystem::path packFile = root_ / "tiles.pack";
+    const std::filesystem::path indexFile = root_ / "tiles.idx";
+    std::filesystem::path compactPackFile = packFile;
+    compactPackFile += ".compact";
+    std::filesystem::path compactIndexFile = indexFile;
+    compactIndexFile += ".compact";
+
+    PackHeader packHeader{};
+    std::memcpy(packHeader.magic, kPackMagic, sizeof(kPackMagic));
+    packHeader.packId = header.packId + 1;
+    core::io::MappedFile compacted;
+    const uint64_t capacity = std::max(kMinIndexCapacity, std::bit_ceil(static_cast<uint64_t>(live.size()) * 2 + 1));
+    if (!createIndex(compactIndexFile, capacity, packHeader.packId, compacted)) return false;
+    IndexHeader& compactedHeader = indexHeader(compacted);
+
+    std::ofstream out(compactPackFile, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&packHeader), sizeof(packHeader));
+    uint64_t offset = sizeof(PackHeader);
+    std::vector<char> record;
+    for (IndexSlot slot : live)
+    {
+        if (slot.recordBytes > kMaxRecordBytes) continue;
+        record.resize(slot.recordBytes);
+        pack_.clear();
+        pack_.seekg(static_cast<std::streamoff>(slot.offset));
+        pack_.read(record.data(), static_cast<std::streamsize>(record.size()));
+        if (!pack_) continue;
+        out.write(record.data(), static_cast<std::streamsize>(record.size()));
+        slot.offset = offset;
+        probe(indexSlots(compacted), capacity, slot.key) = slot;
+        ++compactedHeader.count;
+        compactedHeader.liveBytes += slot.recordBytes;
+        offset += slot.recordBytes;
+    }
+    out.flush();
+    compactedHeader.packBytes = offset;
+    const bool written = static_cast<bool>(out) && core::io::syncFile(compactPackFile) && compacted.flush();
+    out.close();
+    compacted.close();
+
+    std::error_code ec;
+    if (written)
+    {
+        // Index first: a crash before the pack rename leaves an index whose packId does not match
+        // the old pack, which only costs a rebuild on the next open.
+        pack_.close();
+        index_.close();
+        std::filesystem::rename(compactIndexFile, indexFile, ec);
+        if (!ec) std::filesystem::rename(compactPackFile, packFile, ec);
+        if (!openFiles()) return false;
+    }
+    std::filesystem::remove(compactPackFile, ec);
+    std::filesystem::remove(compactIndexFile, ec);
+    return written;
+}
+
+size_t OsmTileStore::importDirectory(const std::filesystem::path& dir)
+{
+    size_t imported = 0;
+    std::error_code ec;
+    for (auto it = std::filesystem::recursive_directory_iterator(dir, std::filesystem::directory_options::skip_permission_denied, ec);
+         !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec))
+    {
+        if (it.depth() != 2 || !it->is_regular_file(ec)) continue;
+        const std::filesystem::path& file = it->path();
+        const std::string extension = file.extension().string();
+        if (extension == ".meta" || extension == ".part") continue;
+
+        TileKey key{};
+        if (!parseTileNumber(file.parent_path().parent_path().filename().string(), key.z) ||
+            !parseTileNumber(file.parent_path().filename().string(), key.x) || !parseTileNumber(file.stem().string(), key.y))
+        {
+            continue;
+        }
+        if (contains(key)) continue;
+
+        std::ifstream in(file, std::ios::binary);
+        const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if (bytes.empty()) continue;
+
+        TileValidators validators;
+        std::filesystem::path metaFile = file;
+        metaFile += ".meta";
+        std::ifstream meta(metaFile);
+        std::getline(meta, validators.etag);
+        std::getline(meta, validators.lastModified);
+
+        const auto modified = std::filesystem::last_write_time(file, ec);
+        const auto storedAt = ec ? std::chrono::system_clock::now()
+                                 : std::chrono::time_point_cast<std::chrono::system_clock::duration>(std::chrono::file_clock::to_sys(modified));
+        put(key, bytes, validators, storedAt);
+        ++imported;
+    }
+    flush();
+    return imported;
+}
+
+OsmTileStoreStats OsmTileStore::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    OsmTileStoreStats stats{};
+    if (!index_.isOpen()) return stats;
+    const IndexHeader& header = indexHeader(index_);
+    stats.tiles = static_cast<size_t>(header.count);
+    for (const auto& [key, pending] : pending_)
+    {
+        if (!findSlot(index_, key)) ++stats.tiles;
+    }
+    stats.pendingWrites = pending_.size();
+    stats.packBytes = header.packBytes + pendingRecords_.size();
+    stats.liveBytes = header.liveBytes;
+    return stats;
+}
+
+} // namespace vkglobe
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "core/io/FileLock.h"
+#include "core/io/MappedFile.h"
+#include "vkglobe/OsmTileKey.h"
+#include "vkglobe/OsmTileSource.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace vkglobe {
+
+struct OsmTileStoreStats
+{
+    size_t tiles = 0;
+    size_t pendingWrites = 0;
+    uint64_t packBytes = 0;
+    uint64_t liveBytes = 0;
+};
+
+// On-disk tile cache in two files under root:
+//
+// - tiles.pack: append-only log of records (key, store time, validators, encoded tile bytes).
+// - tiles.idx:  open-addressed hash table keyed by TileKey, memory-mapped read-write, that points
+//               at the newest record of every tile.
+//
+// A lookup is one probe sequence in the mapped index and a read is one seek into the pack. put()
+// buffers records in memory (readable immediately) and flush() appends the whole batch with one
+// write and fsyncs the pack before publishing its index slots, so a crash or power loss loses at
+// most the unflushed batch. Replacing a tile leaves its old record behind as garbage until compact().
+//
+// If the index is missing or does not belong to the pack, it is rebuilt by scanning the pack.
+// All methods are thread-safe. One process at a time owns a store: root/tiles.lock is held while
+// it is open, and a store whose lock is taken (e.g. by osmseed while vkglobe runs) does not open.
+class OsmTileStore
+{
+public:
+    // Deepest zoom the index can key: slots pack x and y into 24 bits each.
+    static constexpr int kMaxZoom = 22;
+
+    struct Tile
+    {
+        std::vector<uint8_t> bytes;
+        TileValidators validators;
+        std::chrono::system_clock::time_point storedAt;
+    };
+
+    explicit OsmTileStore(std::filesystem::path root, size_t writeBatchBytes = size_t{1} << 20);
+    ~OsmTileStore();
+
+    OsmTileStore(const OsmTileStore&) = delete;
+    OsmTileStore& operator=(const OsmTileStore&) = delete;
+
+    bool isOpen() const { return index_.isOpen(); }
+    const std::filesystem::path& root() const { return root_; }
+
+    // What read() returns minus the bytes, from the record header alone.
+    struct TileInfo
+    {
+        TileValidators validators;
+        std::chrono::system_clock::time_point storedAt;
+        // When this record was written. Unlike storedAt, touch() leaves it alone, and a new record
+        // gets a new one, so it tells apart successive contents of a tile.
+        std::chrono::system_clock::time_point recordedAt;
+        size_t dataBytes = 0;
+    };
+
+    bool contains(const TileKey& key) const;
+    bool read(const TileKey& key, Tile& out) const;
+    bool readInfo(const TileKey& key, TileInfo& out) const;
+    // Copies bytes [offset, offset + out.size()) of key's tile data straight into out.
+    bool readData(const TileKey& key, size_t offset, std::span<uint8_t> out) const;
+    void put(const TileKey& key, std::span<const uint8_t> bytes, const TileValidators& validators,
+             std::chrono::system_clock::time_point storedAt = std::chrono::system_clock::now());
+    // Marks the stored copy of key as current again (HTTP 304), replacing its validators.
+    bool touch(const TileKey& key, const TileValidators& validators);
+    void flush();
+
+    // Rewrites the pack with only the newest record of every tile and rebuilds the index. When
+    // those records add up to more than keepBytes, the tiles stored longest ago are dropped until
+    // the rest fit. Other callers wait until it finishes.
+    bool compact(uint64_t keepBytes = std::numeric_limits<uint64_t>::max());
+
+    // Imports a per-file cache tree dir/z/x/y.png (with optional y.png.meta validators) and keeps
+    // each file's modification time as its store time. Tiles already in the store are skipped.
+    size_t importDirectory(const std::filesystem::path& dir);
+
+    OsmTileStoreStats stats() const;
+
+private:
+    struct Pending
+    {
+        size_t offset = 0; // into pendingRecords_
+        uint32_t recordBytes = 0;
+        int64_t storedAt = 0;
+    };
+
+    bool openFiles();
+    bool rebuildIndex(uint64_t packId, uint64_t packSize);
+    bool growIndex();
+    bool insertSlot(const TileKey& key, uint64_t offset, uint32_t recordBytes, int64_t storedAt);
+    void appendRecord(const TileKey& key, std::span<const uint8_t> bytes, const TileValidators& validators, int64_t storedAt);
+    void flushLocked();
+    bool readLocked(const TileKey& key, Tile& out) const;
+    // Copies bytes [from, from + out.size()) of key's newest record, pending or published.
+    bool readRecordBytesLocked(const TileKey& key, uint64_t from, std::span<uint8_t> out, int64_t* storedAt) const;
+
+    std::filesystem::path root_;
+    size_t writeBatchBytes_ = 0;
+
+    mutable std::mutex mutex_;
+    core::io::FileLock lock_; // declared first so it is released after the files are closed
+    core::io::MappedFile index_;
+    mutable std::fstream pack_;
+    std::vector<uint8_t> pendingRecords_;
+    std::unordered_map<TileKey, Pending, TileKeyHash> pending_;
+};
+
+} // namespace vkglobe
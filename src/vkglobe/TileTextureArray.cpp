@@ -0,0 +1,177 @@
+#include "vkglobe/TileTextureArray.h"
+
+#include <vsg/all.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+
+namespace vkglobe {
+
+namespace {
+// Syncs a released layer waits before it is reused, so frames still in flight never sample or
+// upload it; comfortably more than the swapchain's frames in flight.
+constexpr uint64_t kLayerReuseDelaySyncs = 4;
+// Sections of the staging ring, one per recording that uploads; a section is written again only
+// once the frames that copied from it have finished, for the same reason.
+constexpr uint64_t kStagingSections = kLayerReuseDelaySyncs;
+
+} // namespace
+
+TileTextureArray::TileTextureArray(uint32_t layerCount, vsg::ref_ptr<vsg::Sampler> sampler) :
+    layerCount_(layerCount),
+    sampler_(std::move(sampler))
+{
+}
+
+bool TileTextureArray::isSupported(const vsg::Data& image)
+{
+    if (image.width() == 0 || image.height() == 0 || image.depth() != 1 || !image.dataPointer()) return false;
+    if (image.properties.origin != vsg::TOP_LEFT || image.dataSize() != size_t{image.width()} * image.height() * 4) return false;
+    return image.properties.format == VK_FORMAT_R8G8B8A8_UNORM || image.properties.format == VK_FORMAT_R8G8B8A8_SRGB;
+}
+
+bool TileTextureArray::configure(const vsg::Data& image)
+{
+    if (configured()) return true;
+    if (!isSupported(image)) return false;
+
+    width_ = image.width();
+    height_ = image.height();
+    image_ = vsg::Image::create();
+    image_->imageType = VK_IMAGE_TYPE_2D;
+    image_->format = image.properties.format;
+    image_->extent = VkExtent3D{width_, height_, 1};
+    image_->mipLevels = 1;
+    image_->arrayLayers = layerCount_;
+    image_->usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+    auto imageView = vsg::ImageView::create(image_, VK_IMAGE_ASPECT_COLOR_BIT);
+    imageView->viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    imageView->subresourceRange.layerCount = layerCount_;
+    imageInfo_ = vsg::ImageInfo::create(sampler_, imageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    // Handed out from the back, lowest layer first.
+    freeLayers_.clear();
+    for (uint32_t layer = layerCount_; layer-- > 0;) freeLayers_.push_back(layer);
+    return true;
+}
+
+bool TileTextureArray::acquire(vsg::ref_ptr<vsg::Data> image, uint32_t& layer)
+{
+    if (!configured() || !image || !isSupported(*image) || !uploadBudgetLeft()) return false;
+    if (image->width() != width_ || image->height() != height_ || image->properties.format != image_->format) return false;
+    while (!released_.empty() && syncCount_ - released_.front().sync >= kLayerReuseDelaySyncs)
+    {
+        freeLayers_.push_back(released_.front().layer);
+        released_.pop_front();
+    }
+    if (freeLayers_.empty()) return false;
+
+    layer = freeLayers_.back();
+    freeLayers_.pop_back();
+    // A layer queued again before the command was recorded (or without a device at all, as in
+    // the replay benchmark) is uploaded once, with its newest image.
+    auto queued = std::find_if(pending_.begin(), pending_.end(), [&](const Upload& upload) { return upload.layer == layer; });
+    if (queued != pending_.end())
+    {
+        queued->image = std::move(image);
+    }
+    else
+    {
+        pending_.push_back(Upload{layer, std::move(image)});
+        ++uploadsThisSync_;
+    }
+    return true;
+}
+
+void TileTextureArray::release(uint32_t layer)
+{
+    released_.push_back(ReleasedLayer{syncCount_, layer});
+}
+
+void TileTextureArray::record(vsg::CommandBuffer& commandBuffer) const
+{
+    if (!image_) return;
+    const uint32_t deviceID = commandBuffer.deviceID;
+    const VkImage vkImage = image_->vk(deviceID);
+    if (vkImage == VK_NULL_HANDLE) return;
+    if (initialized_ && pending_.empty()) return;
+
+    const VkDeviceSize layerBytes = VkDeviceSize{width_} * height_ * 4;
+    const VkDeviceSize sectionBytes = layerBytes * kMaxUploadsPerSync;
+    if (!pending_.empty() && !stagingData_)
+    {
+        const VkDeviceSize stagingBytes = sectionBytes * kStagingSections;
+        staging_ = vsg::createBufferAndMemory(commandBuffer.getDevice(), stagingBytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_SHARING_MODE_EXCLUSIVE,
+                                              VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        void* mapped = nullptr;
+        auto memory = staging_ ? staging_->getDeviceMemory(deviceID) : vsg::ref_ptr<vsg::DeviceMemory>{};
+        if (memory && memory->map(staging_->getMemoryOffset(deviceID), stagingBytes, 0, &mapped) == VK_SUCCESS)
+        {
+            stagingData_ = static_cast<uint8_t*>(mapped);
+        }
+        else
+        {
+            std::cerr << "[OSM] warning: could not map the tile staging buffer; tiles will not be uploaded.\n";
+            staging_ = {};
+            pending_.clear();
+        }
+    }
+
+    // Several syncs without a recording can queue more than one section holds; the rest waits for
+    // the next recording.
+    const size_t uploadCount = std::min<size_t>(pending_.size(), kMaxUploadsPerSync);
+    const VkDeviceSize sectionOffset = uploadCount == 0 ? 0 : sectionBytes * (stagingSection_++ % kStagingSections);
+    std::vector<VkBufferImageCopy> regions;
+    regions.reserve(uploadCount);
+    for (size_t i = 0; i < uploadCount; ++i)
+    {
+        const Upload& upload = pending_[i];
+        const VkDeviceSize offset = sectionOffset + layerBytes * i;
+        std::memcpy(stagingData_ + offset, upload.image->dataPointer(), layerBytes);
+        VkBufferImageCopy region{};
+        region.bufferOffset = offset;
+        region.imageSubresource = VkImageSubresourceLayers{VK_IMAGE_ASPECT_COLOR_BIT, 0, upload.layer, 1};
+        region.imageExtent = VkExtent3D{width_, height_, 1};
+        regions.push_back(region);
+    }
+    pending_.erase(pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(uploadCount));
+
+    // The whole array moves between layouts together; the first transition discards the
+    // undefined contents of every layer.
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = vkImage;
+    barrier.subresourceRange = VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, layerCount_};
+    barrier.oldLayout = initialized_ ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.srcAccessMask = initialized_ ? VK_ACCESS_SHADER_READ_BIT : 0;
+    const VkPipelineStageFlags srcStage = initialized_ ? VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    initialized_ = true;
+
+    if (regions.empty())
+    {
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer, srcStage, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+        return;
+    }
+
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, srcStage, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    vkCmdCopyBufferToImage(commandBuffer, staging_->vk(deviceID), vkImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()),
+                           regions.data());
+
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+} // namespace vkglobe
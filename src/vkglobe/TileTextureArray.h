@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vsg/commands/Command.h>
+#include <vsg/core/Data.h>
+#include <vsg/core/Inherit.h>
+#include <vsg/state/Buffer.h>
+#include <vsg/state/Image.h>
+#include <vsg/state/ImageInfo.h>
+#include <vsg/state/Sampler.h>
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace vkglobe {
+
+// Fixed-capacity 2D array texture with one tile image per layer.
+//
+// The layer size and format are taken from the first image passed to configure(); every later image
+// must match them, so an upload is a plain copy (the producer converts its images beforehand).
+// acquire() only queues the image, at most kMaxUploadsPerSync per sync: the command itself,
+// recorded ahead of the render pass, copies queued images into a small staging ring and from there
+// into their layers. A released layer is handed out again only after enough syncs that no frame in
+// flight can still sample or upload it.
+class TileTextureArray : public vsg::Inherit<vsg::Command, TileTextureArray>
+{
+public:
+    // Bounds the staging memory (this many layers per frame in flight) and the copying per frame.
+    static constexpr uint32_t kMaxUploadsPerSync = 16;
+
+    TileTextureArray(uint32_t layerCount, vsg::ref_ptr<vsg::Sampler> sampler);
+
+    // Tightly packed 8-bit RGBA images, rows top to bottom.
+    static bool isSupported(const vsg::Data& image);
+
+    bool configure(const vsg::Data& image);
+    bool configured() const { return imageInfo_.valid(); }
+    vsg::ref_ptr<vsg::ImageInfo> imageInfo() const { return imageInfo_; }
+
+    // Call once per scene sync; paces the reuse of released layers.
+    void beginSync()
+    {
+        ++syncCount_;
+        uploadsThisSync_ = 0;
+    }
+    // False once kMaxUploadsPerSync images were queued this sync; acquire() fails until the next.
+    bool uploadBudgetLeft() const { return uploadsThisSync_ < kMaxUploadsPerSync; }
+    bool acquire(vsg::ref_ptr<vsg::Data> image, uint32_t& layer);
+    void release(uint32_t layer);
+    size_t freeLayerCount() const { return freeLayers_.size() + released_.size(); }
+
+    void record(vsg::CommandBuffer& commandBuffer) const override;
+
+private:
+    struct Upload
+    {
+        uint32_t layer = 0;
+        vsg::ref_ptr<vsg::Data> image;
+    };
+
+    struct ReleasedLayer
+    {
+        uint64_t sync = 0;
+        uint32_t layer = 0;
+    };
+
+    uint32_t layerCount_ = 0;
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    vsg::ref_ptr<vsg::Sampler> sampler_;
+    vsg::ref_ptr<vsg::Image> image_;
+    vsg::ref_ptr<vsg::ImageInfo> imageInfo_;
+
+    std::vector<uint32_t> freeLayers_;
+    std::deque<ReleasedLayer> released_;
+    uint64_t syncCount_ = 0;
+    uint32_t uploadsThisSync_ = 0;
+
+    // Touched while recording.
+    mutable std::vector<Upload> pending_;
+    mutable vsg::ref_ptr<vsg::Buffer> staging_;
+    mutable uint8_t* stagingData_ = nullptr;
+    mutable uint64_t stagingSection_ = 0;
+    mutable bool initialized_ = false;
+};
+
+} // namespace vkglobe
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "vkglobe/OsmTileCache.h"
+
 #include <vsgImGui/imgui.h>
 
 namespace vkglobe {
@@ -13,7 +15,7 @@ public:
     const char* presentModeName = "IMMEDIATE (requested)";
 
     void draw(bool wireframeEnabled, bool textureFromFile, bool osmEnabled, bool osmActive, int osmZoom, double osmAltitudeFt,
-              size_t osmVisibleTiles, size_t osmCachedTiles)
+              size_t osmVisibleTiles, size_t osmCachedTiles, const OsmTileCacheStats& osmCacheStats)
     {
         ImGui::Begin("Globe Controls");
         ImGui::Text("LMB drag: rotate globe at origin");
@@ -31,7 +33,13 @@ public:
         ImGui::Text("OSM zoom: %d", osmZoom);
         ImGui::Text("OSM altitude: %.1f ft", osmAltitudeFt);
         ImGui::Text("OSM visible tiles: %llu", static_cast<unsigned long long>(osmVisibleTiles));
-        ImGui::Text("OSM cached tiles: %llu", static_cast<unsigned long long>(osmCachedTiles));
+        ImGui::Text("OSM cached tiles: %llu (%.1f / %.0f MiB)", static_cast<unsigned long long>(osmCachedTiles),
+                    static_cast<double>(osmCacheStats.bytes) / (1024.0 * 1024.0), static_cast<double>(osmCacheStats.budgetBytes) / (1024.0 * 1024.0));
+        const uint64_t lookups = osmCacheStats.hits + osmCacheStats.misses;
+        ImGui::Text("OSM cache hits %llu misses %llu (%.1f%%) evictions %llu", static_cast<unsigned long long>(osmCacheStats.hits),
+                    static_cast<unsigned long long>(osmCacheStats.misses),
+                    lookups > 0 ? 100.0 * static_cast<double>(osmCacheStats.hits) / static_cast<double>(lookups) : 0.0,
+                    static_cast<unsigned long long>(osmCacheStats.evictions));
         ImGui::End();
 
         if (showDemoWindow)
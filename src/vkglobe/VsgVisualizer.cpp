@@ -1,7 +1,10 @@
 #include "vkglobe/VsgVisualizer.h"
 #include "vkglobe/OsmTileManager.h"
 #include "vkglobe/GlobeTileLayer.h"
+#include "vkglobe/OsmProjection.h"
+#include "vkglobe/OsmTileStore.h"
 #include "vkglobe/UIObject.h"
+#include "core/image/ProceduralEarthTexture.h"
 
 #include <vsg/all.h>
 #include <vsgImGui/RenderImGui.h>
@@ -12,16 +15,27 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <memory>
+#include <numeric>
+#include <optional>
 #include <regex>
 #include <sstream>
 #include <string>
+#include <thread>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
 
 namespace
 {
@@ -65,6 +79,7 @@ struct AppState : public vsg::Inherit<vsg::Object, AppState>
     double osmAltitudeFt = 0.0;
     size_t osmVisibleTiles = 0;
     size_t osmCachedTiles = 0;
+    vkglobe::OsmTileCacheStats osmCacheStats{};
 };
 
 class GlobeInputHandler : public vsg::Inherit<vsg::Visitor, GlobeInputHandler>
@@ -322,7 +337,7 @@ public:
             bool changed = false;
             changed |= ImGui::Checkbox("Enable OSM Tiles", &state->osmEnabledSetting);
             changed |= ImGui::SliderInt("OSM Max Zoom", &state->osmMaxZoomSetting, 1, 22);
-            changed |= ImGui::SliderInt("OSM Tile Radius", &state->osmTileRadiusSetting, 1, 12);
+            changed |= ImGui::SliderInt("OSM Tile Budget (radius)", &state->osmTileRadiusSetting, 1, vkglobe::OsmTileManager::kMaxTileRadius);
             changed |= ImGui::InputFloat("OSM Alt Threshold (ft)", &state->osmAltThresholdFtSetting, 1000.0f, 10000.0f, "%.0f");
             state->osmAltThresholdFtSetting = std::max(0.0f, state->osmAltThresholdFtSetting);
             ImGui::TextUnformatted("Tiles ON at or below threshold, OFF above threshold.");
@@ -338,7 +353,7 @@ public:
             ImGui::End();
         }
         state->ui.draw(state->wireframe, state->textureFromFile, state->osmEnabled, state->osmActive, state->osmZoom,
-                       state->osmAltitudeFt, state->osmVisibleTiles, state->osmCachedTiles);
+                       state->osmAltitudeFt, state->osmVisibleTiles, state->osmCachedTiles, state->osmCacheStats);
     }
 
 private:
@@ -347,59 +362,27 @@ private:
 
 vsg::ref_ptr<vsg::Data> createProceduralEarthTexture()
 {
-    const uint32_t width = 2048;
-    const uint32_t height = 1024;
-    auto tex = vsg::ubvec4Array2D::create(width, height, vsg::Data::Properties{VK_FORMAT_R8G8B8A8_UNORM});
-
-    for (uint32_t y = 0; y < height; ++y)
-    {
-        const double v = static_cast<double>(y) / static_cast<double>(height - 1);
-        const double lat = (0.5 - v) * vsg::PI;
-        const double polar = std::pow(std::abs(std::sin(lat)), 6.0);
-
-        for (uint32_t x = 0; x < width; ++x)
-        {
-            const double u = static_cast<double>(x) / static_cast<double>(width - 1);
-            const double lon = (u * 2.0 - 1.0) * vsg::PI;
-
-            const double continent = 0.5 + 0.5 * std::sin(5.0 * lon) * std::cos(3.0 * lat);
-            const bool isLand = continent > 0.62 || (std::abs(lat) > vsg::radians(52.0) && continent > 0.48);
-
-            vsg::ubvec4 color;
-            if (polar > 0.82)
-            {
-                color = vsg::ubvec4(236, 244, 252, 255);
-            }
-            else if (isLand)
-            {
-                const uint8_t g = static_cast<uint8_t>(90 + 80 * (1.0 - polar));
-                color = vsg::ubvec4(45, g, 52, 255);
-            }
-            else
-            {
-                const uint8_t b = static_cast<uint8_t>(130 + 70 * (1.0 - polar));
-                color = vsg::ubvec4(20, 65, b, 255);
-            }
-
-            tex->set(x, y, color);
-        }
-    }
+    const core::image::ProceduralEarthParams params{core::image::ProceduralEarthStyle::Continents, 2048, 1024};
+    const core::image::ProceduralEarthImage earth = core::image::loadOrGenerateProceduralEarth(params, core::image::kProceduralCacheDir);
 
+    auto tex = vsg::ubvec4Array2D::create(earth.width(), earth.height(), vsg::Data::Properties{VK_FORMAT_R8G8B8A8_UNORM});
+    std::memcpy(tex->dataPointer(), earth.data(), earth.size());
     tex->dirty();
     return tex;
 }
 
 vsg::ref_ptr<vsg::Data> createOsmTileFallbackTexture()
 {
-    constexpr uint32_t w = 64;
-    constexpr uint32_t h = 64;
+    // Tile-sized, so it shares the tile texture array.
+    constexpr uint32_t w = vkglobe::OsmTilePipeline::kTilePixels;
+    constexpr uint32_t h = vkglobe::OsmTilePipeline::kTilePixels;
     auto tex = vsg::ubvec4Array2D::create(w, h, vsg::Data::Properties{VK_FORMAT_R8G8B8A8_UNORM});
     for (uint32_t y = 0; y < h; ++y)
     {
         for (uint32_t x = 0; x < w; ++x)
         {
-            const bool edge = (x < 2) || (y < 2) || (x >= w - 2) || (y >= h - 2);
-            const bool checker = (((x / 8) + (y / 8)) % 2) == 0;
+            const bool edge = (x < 8) || (y < 8) || (x >= w - 8) || (y >= h - 8);
+            const bool checker = (((x / 32) + (y / 32)) % 2) == 0;
             const vsg::ubvec4 c = edge ? vsg::ubvec4(255, 40, 40, 255)
                                        : (checker ? vsg::ubvec4(240, 230, 80, 255) : vsg::ubvec4(20, 20, 20, 255));
             tex->set(x, y, c);
@@ -414,6 +397,7 @@ struct SavedSettings
     std::string earthTexturePath;
     bool osmEnabled = false;
     std::string osmCachePath = "cache/osm";
+    std::string osmUrlTemplate = vkglobe::kDefaultOsmTileUrlTemplate;
     double osmEnableAltFt = 10000.0;
     double osmDisableAltFt = 15000.0;
     int osmMaxZoom = 19;
@@ -437,10 +421,29 @@ void printUsage(std::ostream& out)
         << "  --earth-texture <path>     Earth texture image path.\n"
         << "  --osm                      Enable OSM tiles.\n"
         << "  --osm-cache <path>         OSM cache directory.\n"
+        << "  --osm-url <template>       OSM tile URL with {z}/{x}/{y}; file:// or a localhost\n"
+        << "                             server can stand in for the public tile server.\n"
         << "  --osm-enable-alt-ft <num>  OSM on threshold (feet).\n"
         << "  --osm-disable-alt-ft <num> OSM off threshold (feet).\n"
         << "  --osm-max-zoom <int>       OSM max zoom.\n"
-        << "  --osm-tile-radius <int>    OSM tile radius around center tile.\n"
+        << "  --osm-tile-radius <int>    OSM tile budget: at most (2r+1)^2 tiles are drawn (r <= 7).\n"
+        << "  --osm-memory-mb <int>      Decoded OSM tile memory budget (default 256).\n"
+        << "  --osm-decoded-cache-mb <int> Disk budget for decoded OSM tiles under --osm-cache\n"
+        << "                             (default 1024, 0 disables).\n"
+        << "  --osm-fetch-bench <count>  Fetch <count> tiles from --osm-url, print [BENCH] and exit.\n"
+        << "  --osm-decode-bench <count> Decode <count> tiles from --osm-url with and without the\n"
+        << "                             decoded tile cache, print [BENCH] and exit.\n"
+        << "  --osm-prefetch-bench <s>   Fly a scripted low-altitude path for <s> seconds with tile\n"
+        << "                             prediction off and on, print [BENCH] and exit.\n"
+        << "  --record-camera <path>     Record the camera path to <path> for --osm-replay.\n"
+        << "  --osm-replay <path>        Replay a recorded camera path headless against --osm-url through\n"
+        << "                             a fresh tile store, write results to --osm-replay-json and exit.\n"
+        << "  --osm-replay-json <path>   Replay results file (default osm-replay.json).\n"
+        << "  --osm-sim-latency-ms <int> Replay: simulated link latency per tile request.\n"
+        << "  --osm-sim-bandwidth-kib <int> Replay: simulated link bandwidth in KiB/s (0 = unlimited).\n"
+        << "  --osm-import-cache <dir>   Pack a per-file dir/z/x/y.png tile cache into the --osm-cache\n"
+        << "                             tile store and exit.\n"
+        << "  --osm-compact              Drop replaced tiles from the --osm-cache tile store and exit.\n"
         << std::endl;
 }
 
@@ -535,6 +538,7 @@ bool loadSavedSettings(const std::string& path, SavedSettings& settings)
     parseJsonStringField(text, "earth_texture", settings.earthTexturePath);
     parseJsonBoolField(text, "osm_enabled", settings.osmEnabled);
     parseJsonStringField(text, "osm_cache", settings.osmCachePath);
+    parseJsonStringField(text, "osm_url", settings.osmUrlTemplate);
     parseJsonDoubleField(text, "osm_enable_alt_ft", settings.osmEnableAltFt);
     parseJsonDoubleField(text, "osm_disable_alt_ft", settings.osmDisableAltFt);
     parseJsonIntField(text, "osm_max_zoom", settings.osmMaxZoom);
@@ -554,6 +558,7 @@ bool saveSavedSettings(const std::string& path, const SavedSettings& settings)
         << "  \"earth_texture\": \"" << jsonEscape(settings.earthTexturePath) << "\",\n"
         << "  \"osm_enabled\": " << (settings.osmEnabled ? "true" : "false") << ",\n"
         << "  \"osm_cache\": \"" << jsonEscape(settings.osmCachePath) << "\",\n"
+        << "  \"osm_url\": \"" << jsonEscape(settings.osmUrlTemplate) << "\",\n"
         << "  \"osm_enable_alt_ft\": " << settings.osmEnableAltFt << ",\n"
         << "  \"osm_disable_alt_ft\": " << settings.osmDisableAltFt << ",\n"
         << "  \"osm_max_zoom\": " << settings.osmMaxZoom << ",\n"
@@ -741,6 +746,462 @@ double latestVsgGpuFrameMs(const vsg::Profiler& profiler)
     return 0.0;
 }
 
+// The tileCount tiles of zoom closest to the start location, in rings around it.
+std::vector<vkglobe::TileKey> benchmarkTileKeys(int zoom, int tileCount)
+{
+    const int tiles = vkglobe::tileCountForZoom(zoom);
+    const int centerX = static_cast<int>(vkglobe::lonToTileX(kStartLonDeg, zoom));
+    const int centerY = static_cast<int>(vkglobe::latToTileY(kStartLatDeg, zoom));
+    std::vector<vkglobe::TileKey> keys;
+    for (int radius = 0; static_cast<int>(keys.size()) < tileCount; ++radius)
+    {
+        for (int oy = -radius; oy <= radius && static_cast<int>(keys.size()) < tileCount; ++oy)
+        {
+            for (int ox = -radius; ox <= radius && static_cast<int>(keys.size()) < tileCount; ++ox)
+            {
+                if (std::max(std::abs(ox), std::abs(oy)) != radius) continue;
+                keys.push_back(vkglobe::TileKey{zoom, vkglobe::wrapTileX(centerX + ox, tiles), std::clamp(centerY + oy, 0, tiles - 1)});
+            }
+        }
+    }
+    return keys;
+}
+
+// Fetches tileCount tiles around the start location through the configured TileSource, without
+// touching the disk cache, and reports throughput. Point --osm-url at a localhost server or a
+// file:// directory for repeatable numbers.
+int runOsmFetchBenchmark(const std::string& urlTemplate, int tileCount, int threadCount)
+{
+    const std::vector<vkglobe::TileKey> keys = benchmarkTileKeys(14, tileCount);
+
+    vkglobe::TileSourceConfig sourceConfig{};
+    sourceConfig.urlTemplate = urlTemplate;
+    auto source = vkglobe::createOsmTileSource(sourceConfig);
+
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> ok{0};
+    std::atomic<size_t> failed{0};
+    std::atomic<uint64_t> bytes{0};
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int i = 0; i < std::max(1, threadCount); ++i)
+    {
+        workers.emplace_back([&]() {
+            for (size_t index = next++; index < keys.size(); index = next++)
+            {
+                const vkglobe::TileFetchResult result = source->fetch(keys[index], {});
+                if (result.status == vkglobe::TileFetchResult::Status::Failed)
+                {
+                    ++failed;
+                    continue;
+                }
+                ++ok;
+                bytes += result.bytes.size();
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "[BENCH] osm_fetch source=" << source->name()
+              << " url=" << urlTemplate
+              << " threads=" << std::max(1, threadCount)
+              << " tiles=" << keys.size()
+              << " ok=" << ok.load()
+              << " failed=" << failed.load()
+              << " seconds=" << seconds
+              << " tiles_per_s=" << (seconds > 0.0 ? static_cast<double>(keys.size()) / seconds : 0.0)
+              << " mib_per_s=" << (seconds > 0.0 ? static_cast<double>(bytes.load()) / (1024.0 * 1024.0) / seconds : 0.0)
+              << std::endl;
+    return failed.load() == 0 ? 0 : 1;
+}
+
+// Scripted low-altitude flight for the prefetch benchmark, t seconds into a pathSeconds run: a fast
+// eastward pan at 2000 ft, a descent to 600 ft heading north, then a westward pan.
+void prefetchBenchmarkCamera(double t, double pathSeconds, double& latDeg, double& lonDeg, double& altitudeFt)
+{
+    const double pan = std::min(t, 0.4 * pathSeconds);
+    const double descent = std::clamp(t - 0.4 * pathSeconds, 0.0, 0.3 * pathSeconds);
+    const double panBack = std::max(0.0, t - 0.7 * pathSeconds);
+    latDeg = kStartLatDeg + 0.006 * descent;
+    lonDeg = kStartLonDeg + 0.008 * pan - 0.004 * panBack;
+    altitudeFt = 2000.0 * std::pow(600.0 / 2000.0, descent / (0.3 * pathSeconds));
+}
+
+// Replays the scripted flight in real time at 60 Hz through a fresh tile store, once with tile
+// prediction off and once with it on, and reports the fraction of tiles that were already
+// resident when they entered the visible window. Point --osm-url at a localhost server or a
+// file:// directory for repeatable numbers.
+int runOsmPrefetchBenchmark(const std::string& urlTemplate, double pathSeconds)
+{
+    auto options = vsg::Options::create();
+#ifdef VKVSG_HAS_VSGXCHANGE
+    options->add(vsgXchange::all::create());
+#endif
+    const std::filesystem::path cacheRoot = std::filesystem::temp_directory_path() / "vkglobe-prefetch-bench";
+    for (const double lookaheadSeconds : {0.0, vkglobe::OsmTileManager::Config{}.prefetchLookaheadSeconds})
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(cacheRoot, ec);
+        vkglobe::OsmTileManager::Config cfg{};
+        cfg.cacheRoot = cacheRoot;
+        cfg.urlTemplate = urlTemplate;
+        cfg.prefetchLookaheadSeconds = lookaheadSeconds;
+        auto tiles = vkglobe::OsmTileManager::create(options, cfg);
+        tiles->setEnabled(true);
+
+        const vsg::dmat4 projection = vsg::perspective(vsg::radians(35.0), 1280.0 / 720.0, 1.0, 1.0e8);
+        const auto frame = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / 60.0));
+        const auto start = std::chrono::steady_clock::now();
+        uint64_t frames = 0;
+        for (auto next = start + frame;; next += frame)
+        {
+            const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (t >= pathSeconds) break;
+            double latDeg = 0.0;
+            double lonDeg = 0.0;
+            double altitudeFt = 0.0;
+            prefetchBenchmarkCamera(t, pathSeconds, latDeg, lonDeg, altitudeFt);
+            const vsg::dvec3 surface(std::sin(vsg::radians(lonDeg)) * std::cos(vsg::radians(latDeg)) * kWgs84EquatorialRadiusFeet,
+                                     -std::cos(vsg::radians(lonDeg)) * std::cos(vsg::radians(latDeg)) * kWgs84EquatorialRadiusFeet,
+                                     std::sin(vsg::radians(latDeg)) * kWgs84PolarRadiusFeet);
+            const vsg::dvec3 eye = vsg::normalize(worldFromLatLon(latDeg, lonDeg)) * (vsg::length(surface) + altitudeFt);
+            // Straight down with north up, through the viewer's default lens on a 720p window.
+            const vsg::dmat4 view = vsg::lookAt(eye, vsg::dvec3(0.0, 0.0, 0.0), vsg::dvec3(0.0, 0.0, 1.0));
+            tiles->update(eye, vsg::dmat4(), kWgs84EquatorialRadiusFeet, kWgs84PolarRadiusFeet, projection, view, 720.0);
+            ++frames;
+            std::this_thread::sleep_until(next);
+        }
+
+        const vkglobe::OsmTileCacheStats stats = tiles->cacheStats();
+        const uint64_t newlyVisible = stats.hits + stats.misses;
+        std::cout << "[BENCH] osm_prefetch lookahead_s=" << lookaheadSeconds
+                  << " seconds=" << pathSeconds
+                  << " frames=" << frames
+                  << " newly_visible=" << newlyVisible
+                  << " resident=" << stats.hits
+                  << " resident_pct=" << (newlyVisible > 0 ? 100.0 * static_cast<double>(stats.hits) / static_cast<double>(newlyVisible) : 0.0)
+                  << " cancelled=" << tiles->cancelledTileCount()
+                  << std::endl;
+        tiles = {};
+        std::filesystem::remove_all(cacheRoot, ec);
+    }
+    return 0;
+}
+
+// Loads tileCount tiles from urlTemplate through three fresh pipelines sharing one tile store: with
+// the decoded cache off, filling it, and loading from it. Reports the decode workers' CPU time per
+// tile for each pass; fetching is not included.
+int runOsmDecodeBenchmark(const std::string& urlTemplate, int tileCount)
+{
+    auto options = vsg::Options::create();
+#ifdef VKVSG_HAS_VSGXCHANGE
+    options->add(vsgXchange::all::create());
+#endif
+    const std::vector<vkglobe::TileKey> keys = benchmarkTileKeys(16, tileCount);
+    const std::filesystem::path cacheRoot = std::filesystem::temp_directory_path() / "vkglobe-decode-bench";
+    std::error_code ec;
+    std::filesystem::remove_all(cacheRoot, ec);
+
+    struct Pass
+    {
+        const char* mode;
+        uint64_t decodedCacheBytes;
+    };
+    const uint64_t decodedCacheBytes = vkglobe::OsmTilePipeline::Config{}.decodedCacheBytes;
+    int status = 0;
+    for (const Pass& pass : {Pass{"png", 0}, Pass{"decoded_cache_fill", decodedCacheBytes}, Pass{"decoded_cache", decodedCacheBytes}})
+    {
+        vkglobe::OsmTilePipeline::Config cfg{};
+        cfg.cacheRoot = cacheRoot;
+        cfg.decodedCacheBytes = pass.decodedCacheBytes;
+        vkglobe::TileSourceConfig sourceConfig{};
+        sourceConfig.urlTemplate = urlTemplate;
+        vkglobe::OsmTilePipeline pipeline(options, cfg, vkglobe::createOsmTileSource(sourceConfig));
+        pipeline.schedule(keys);
+
+        size_t done = 0;
+        size_t failed = 0;
+        vkglobe::OsmTilePipeline::Result result;
+        while (done < keys.size())
+        {
+            if (!pipeline.popCompleted(result))
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            ++done;
+            if (!result.image) ++failed;
+        }
+
+        const vkglobe::OsmDecodeStats stats = pipeline.decodeStats();
+        const uint64_t decoded = stats.pngDecodes + stats.cacheLoads;
+        std::cout << "[BENCH] osm_decode mode=" << pass.mode
+                  << " tiles=" << keys.size()
+                  << " failed=" << failed
+                  << " png_decodes=" << stats.pngDecodes
+                  << " cache_loads=" << stats.cacheLoads
+                  << " cpu_ms_per_tile=" << (decoded > 0 ? (stats.pngDecodeMs + stats.cacheLoadMs) / static_cast<double>(decoded) : 0.0)
+                  << std::endl;
+        if (failed > 0) status = 1;
+    }
+    std::filesystem::remove_all(cacheRoot, ec);
+    return status;
+}
+
+// One frame of a recorded camera path: what OsmTileManager::update() was given that frame, in the
+// globe frame so a replay does not depend on the globe's rotation.
+struct CameraPathFrame
+{
+    double seconds = 0.0;
+    vsg::dvec3 eye;
+    vsg::dmat4 view;
+    vsg::dmat4 projection;
+    double viewportHeight = 0.0;
+};
+
+// One comma-separated line per frame: seconds, eye (3), view (16, column-major), projection (16),
+// viewport height.
+void writeCameraPathFrame(std::ostream& out, const CameraPathFrame& frame)
+{
+    out << frame.seconds << ',' << frame.eye.x << ',' << frame.eye.y << ',' << frame.eye.z;
+    for (const vsg::dmat4* m : {&frame.view, &frame.projection})
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            for (int r = 0; r < 4; ++r) out << ',' << (*m)[c][r];
+        }
+    }
+    out << ',' << frame.viewportHeight << '\n';
+}
+
+bool loadCameraPath(const std::string& path, std::vector<CameraPathFrame>& frames)
+{
+    std::ifstream in(path);
+    if (!in) return false;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (line.empty() || line[0] == '#') continue;
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream fields(line);
+        CameraPathFrame frame{};
+        fields >> frame.seconds >> frame.eye.x >> frame.eye.y >> frame.eye.z;
+        for (vsg::dmat4* m : {&frame.view, &frame.projection})
+        {
+            for (int c = 0; c < 4; ++c)
+            {
+                for (int r = 0; r < 4; ++r) fields >> (*m)[c][r];
+            }
+        }
+        fields >> frame.viewportHeight;
+        if (!fields) return false;
+        frames.push_back(frame);
+    }
+    return !frames.empty();
+}
+
+// Peak resident set size of the process, or -1 where it is not available.
+int64_t peakResidentBytes()
+{
+#if defined(_WIN32)
+    return -1;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#if defined(__APPLE__)
+    return static_cast<int64_t>(usage.ru_maxrss);
+#else
+    return static_cast<int64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+// Nearest-rank percentile of values, p in [0, 1].
+double percentile(std::vector<double> values, double p)
+{
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    return values[static_cast<size_t>(std::ceil(p * static_cast<double>(values.size()))) - (p > 0.0 ? 1 : 0)];
+}
+
+struct OsmReplaySettings
+{
+    std::string pathFile;
+    std::string jsonPath;
+    std::string urlTemplate;
+    int latencyMs = 0;
+    int bandwidthKiBps = 0;
+    int maxZoom = 19;
+    int tileRadius = 6;
+};
+
+// Replays a camera path recorded with --record-camera through a fresh tile store in real time,
+// driving OsmTileManager::update() and GlobeTileLayer::syncFromTileWindow() at the recorded frame
+// times without a window. The tile source is --osm-url (a file:// directory or a localhost
+// server) behind a simulated link. Writes tile throughput, how long the visible window stays
+// incomplete after it changes, per-frame tile work, cache hit ratios and peak memory as JSON.
+// Texture uploads are not recorded without a device, so the staging copy is not in the tile work.
+int runOsmReplayBenchmark(const OsmReplaySettings& settings)
+{
+    std::vector<CameraPathFrame> frames;
+    if (!loadCameraPath(settings.pathFile, frames))
+    {
+        std::cerr << "[OSM] could not read a camera path from '" << settings.pathFile << "'" << std::endl;
+        return 1;
+    }
+
+    auto options = vsg::Options::create();
+#ifdef VKVSG_HAS_VSGXCHANGE
+    options->add(vsgXchange::all::create());
+#endif
+    const std::filesystem::path cacheRoot = std::filesystem::temp_directory_path() / "vkglobe-replay-bench";
+    std::error_code ec;
+    std::filesystem::remove_all(cacheRoot, ec);
+
+    vkglobe::OsmTileManager::Config cfg{};
+    cfg.cacheRoot = cacheRoot;
+    cfg.urlTemplate = settings.urlTemplate;
+    cfg.simulatedLatencyMs = std::max(0, settings.latencyMs);
+    cfg.simulatedBytesPerSecond = static_cast<uint64_t>(std::max(0, settings.bandwidthKiBps)) * 1024;
+    cfg.maxZoom = std::clamp(settings.maxZoom, cfg.minZoom, 22);
+    cfg.tileRadius = std::clamp(settings.tileRadius, 1, vkglobe::OsmTileManager::kMaxTileRadius);
+    auto tiles = vkglobe::OsmTileManager::create(options, cfg);
+    tiles->setEnabled(true);
+    auto layer = vkglobe::GlobeTileLayer::create(kWgs84EquatorialRadiusFeet * 1.00001, kWgs84PolarRadiusFeet * 1.00001, createOsmTileFallbackTexture());
+
+    // A frame whose tile work takes a quarter of a 60 Hz frame counts as a hitch.
+    constexpr double kHitchMs = 1000.0 / 60.0 / 4.0;
+    std::vector<double> tileWorkMs;
+    tileWorkMs.reserve(frames.size());
+    std::vector<double> windowCompleteMs;
+    std::optional<std::chrono::steady_clock::time_point> incompleteSince;
+    size_t peakCacheBytes = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (const CameraPathFrame& frame : frames)
+    {
+        std::this_thread::sleep_until(start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                                  std::chrono::duration<double>(frame.seconds - frames.front().seconds)));
+        const auto workStart = std::chrono::steady_clock::now();
+        tiles->update(frame.eye, vsg::dmat4(), kWgs84EquatorialRadiusFeet, kWgs84PolarRadiusFeet, frame.projection, frame.view, frame.viewportHeight);
+        (void)layer->syncFromTileWindow(tiles->currentTileWindow());
+        const auto workEnd = std::chrono::steady_clock::now();
+        tileWorkMs.push_back(std::chrono::duration<double, std::milli>(workEnd - workStart).count());
+
+        // Failed tiles leave the window incomplete; a local source should not have any.
+        const bool complete = tiles->loadedVisibleTiles().size() == tiles->visibleTileCount();
+        if (!complete && !incompleteSince) incompleteSince = workEnd;
+        if (complete && incompleteSince)
+        {
+            windowCompleteMs.push_back(std::chrono::duration<double, std::milli>(workEnd - *incompleteSince).count());
+            incompleteSince.reset();
+        }
+        peakCacheBytes = std::max(peakCacheBytes, tiles->cacheStats().bytes);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const vkglobe::OsmTileCacheStats cacheStats = tiles->cacheStats();
+    const vkglobe::OsmDecodeStats decodeStats = tiles->decodeStats();
+    const uint64_t lookups = cacheStats.hits + cacheStats.misses;
+    const uint64_t decodes = decodeStats.pngDecodes + decodeStats.cacheLoads;
+    const size_t hitchFrames = static_cast<size_t>(std::count_if(tileWorkMs.begin(), tileWorkMs.end(), [](double ms) { return ms >= kHitchMs; }));
+    const double windowCompleteMean =
+        windowCompleteMs.empty() ? 0.0 : std::accumulate(windowCompleteMs.begin(), windowCompleteMs.end(), 0.0) / static_cast<double>(windowCompleteMs.size());
+    const int64_t peakRss = peakResidentBytes();
+    const double tilesPerSecond = seconds > 0.0 ? static_cast<double>(tiles->completedTileCount()) / seconds : 0.0;
+
+    std::ofstream out(settings.jsonPath, std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << "[OSM] could not write '" << settings.jsonPath << "'" << std::endl;
+        return 1;
+    }
+    out << "{\n"
+        << "  \"benchmark\": \"osm_replay\",\n"
+        << "  \"path\": \"" << jsonEscape(settings.pathFile) << "\",\n"
+        << "  \"frames\": " << frames.size() << ",\n"
+        << "  \"seconds\": " << seconds << ",\n"
+        << "  \"source\": {\"url\": \"" << jsonEscape(settings.urlTemplate) << "\", \"name\": \"" << jsonEscape(tiles->tileSourceName())
+        << "\", \"latency_ms\": " << cfg.simulatedLatencyMs << ", \"bandwidth_kib_per_s\": " << std::max(0, settings.bandwidthKiBps) << "},\n"
+        << "  \"tiles\": {\"completed\": " << tiles->completedTileCount() << ", \"per_second\": " << tilesPerSecond
+        << ", \"cancelled\": " << tiles->cancelledTileCount() << "},\n"
+        << "  \"window_complete_ms\": {\"count\": " << windowCompleteMs.size() << ", \"mean\": " << windowCompleteMean
+        << ", \"p95\": " << percentile(windowCompleteMs, 0.95) << ", \"max\": " << percentile(windowCompleteMs, 1.0)
+        << ", \"incomplete_at_end\": " << (incompleteSince ? "true" : "false") << "},\n"
+        << "  \"tile_work_ms\": {\"p50\": " << percentile(tileWorkMs, 0.5) << ", \"p95\": " << percentile(tileWorkMs, 0.95)
+        << ", \"p99\": " << percentile(tileWorkMs, 0.99) << ", \"max\": " << percentile(tileWorkMs, 1.0) << ", \"hitch_threshold_ms\": " << kHitchMs
+        << ", \"hitch_frames\": " << hitchFrames << "},\n"
+        << "  \"cache\": {\"memory_hits\": " << cacheStats.hits << ", \"memory_misses\": " << cacheStats.misses << ", \"memory_hit_ratio\": "
+        << (lookups > 0 ? static_cast<double>(cacheStats.hits) / static_cast<double>(lookups) : 0.0) << ", \"evictions\": " << cacheStats.evictions
+        << ", \"png_decodes\": " << decodeStats.pngDecodes << ", \"decoded_loads\": " << decodeStats.cacheLoads << ", \"decoded_hit_ratio\": "
+        << (decodes > 0 ? static_cast<double>(decodeStats.cacheLoads) / static_cast<double>(decodes) : 0.0) << "},\n"
+        << "  \"memory\": {\"peak_tile_cache_bytes\": " << peakCacheBytes << ", \"peak_rss_bytes\": ";
+    if (peakRss >= 0)
+        out << peakRss;
+    else
+        out << "null";
+    out << "}\n"
+        << "}\n";
+
+    std::cout << "[BENCH] osm_replay frames=" << frames.size()
+              << " seconds=" << seconds
+              << " tiles_per_s=" << tilesPerSecond
+              << " window_complete_p95_ms=" << percentile(windowCompleteMs, 0.95)
+              << " tile_work_p99_ms=" << percentile(tileWorkMs, 0.99)
+              << " hitch_frames=" << hitchFrames
+              << " json=" << settings.jsonPath
+              << std::endl;
+
+    tiles = {};
+    std::filesystem::remove_all(cacheRoot, ec);
+    return out.good() ? 0 : 1;
+}
+
+// Offline maintenance of the tile store under cachePath: imports a per-file cache tree and/or
+// compacts the pack, and the decoded tile store's with it. The viewer must not be running on the
+// same cache.
+int runOsmStoreMaintenance(const std::string& cachePath, const std::string& importDir, bool compact)
+{
+    vkglobe::OsmTileStore store(cachePath);
+    if (!store.isOpen()) return 1;
+
+    if (!importDir.empty())
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const size_t imported = store.importDirectory(importDir);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "[OSM] import dir=" << importDir << " store=" << cachePath << " imported=" << imported
+                  << " store_tiles=" << store.stats().tiles << " seconds=" << seconds << std::endl;
+    }
+    if (compact)
+    {
+        const uint64_t before = store.stats().packBytes;
+        if (!store.compact())
+        {
+            std::cerr << "[OSM] compact failed for '" << cachePath << "'" << std::endl;
+            return 1;
+        }
+        std::cout << "[OSM] compact store=" << cachePath << " tiles=" << store.stats().tiles << " pack_bytes_before=" << before
+                  << " pack_bytes_after=" << store.stats().packBytes << std::endl;
+
+        const std::filesystem::path decodedPath = std::filesystem::path(cachePath) / "decoded";
+        if (std::filesystem::exists(decodedPath))
+        {
+            vkglobe::OsmTileStore decoded(decodedPath);
+            const uint64_t decodedBefore = decoded.stats().packBytes;
+            if (!decoded.isOpen() || !decoded.compact())
+            {
+                std::cerr << "[OSM] compact failed for '" << decodedPath.string() << "'" << std::endl;
+                return 1;
+            }
+            std::cout << "[OSM] compact store=" << decodedPath.string() << " tiles=" << decoded.stats().tiles
+                      << " pack_bytes_before=" << decodedBefore << " pack_bytes_after=" << decoded.stats().packBytes << std::endl;
+        }
+    }
+    return 0;
+}
+
 } // namespace
 
 int vkglobe::VsgVisualizer::run(int argc, char** argv)
@@ -759,6 +1220,7 @@ int vkglobe::VsgVisualizer::run(int argc, char** argv)
         std::string earthTexturePath;
         bool osmEnabled = false;
         std::string osmCachePath = "cache/osm";
+        std::string osmUrlTemplate = kDefaultOsmTileUrlTemplate;
         double osmEnableAltFt = 10000.0;
         double osmDisableAltFt = 15000.0;
         int osmMaxZoom = 19;
@@ -782,6 +1244,7 @@ int vkglobe::VsgVisualizer::run(int argc, char** argv)
             earthTexturePath = savedSettings.earthTexturePath;
             osmEnabled = savedSettings.osmEnabled;
             osmCachePath = savedSettings.osmCachePath;
+            osmUrlTemplate = savedSettings.osmUrlTemplate;
             osmEnableAltFt = savedSettings.osmEnableAltFt;
             osmDisableAltFt = savedSettings.osmDisableAltFt;
             osmMaxZoom = savedSettings.osmMaxZoom;
@@ -791,12 +1254,46 @@ int vkglobe::VsgVisualizer::run(int argc, char** argv)
         while (arguments.read("--earth-texture", earthTexturePath)) {}
         while (arguments.read("--osm")) { osmEnabled = true; }
         while (arguments.read("--osm-cache", osmCachePath)) {}
+        while (arguments.read("--osm-url", osmUrlTemplate)) {}
         while (arguments.read("--osm-enable-alt-ft", osmEnableAltFt)) {}
         while (arguments.read("--osm-disable-alt-ft", osmDisableAltFt)) {}
         while (arguments.read("--osm-max-zoom", osmMaxZoom)) {}
         while (arguments.read("--osm-tile-radius", osmTileRadius)) {}
+        int osmMemoryMb = 256;
+        while (arguments.read("--osm-memory-mb", osmMemoryMb)) {}
+        int osmDecodedCacheMb = 1024;
+        while (arguments.read("--osm-decoded-cache-mb", osmDecodedCacheMb)) {}
+        int osmFetchBenchTiles = 0;
+        while (arguments.read("--osm-fetch-bench", osmFetchBenchTiles)) {}
+        int osmDecodeBenchTiles = 0;
+        while (arguments.read("--osm-decode-bench", osmDecodeBenchTiles)) {}
+        double osmPrefetchBenchSeconds = 0.0;
+        while (arguments.read("--osm-prefetch-bench", osmPrefetchBenchSeconds)) {}
+        std::string cameraRecordPath;
+        while (arguments.read("--record-camera", cameraRecordPath)) {}
+        OsmReplaySettings osmReplay{};
+        osmReplay.jsonPath = "osm-replay.json";
+        while (arguments.read("--osm-replay", osmReplay.pathFile)) {}
+        while (arguments.read("--osm-replay-json", osmReplay.jsonPath)) {}
+        while (arguments.read("--osm-sim-latency-ms", osmReplay.latencyMs)) {}
+        while (arguments.read("--osm-sim-bandwidth-kib", osmReplay.bandwidthKiBps)) {}
+        std::string osmImportDir;
+        while (arguments.read("--osm-import-cache", osmImportDir)) {}
+        bool osmCompact = false;
+        while (arguments.read("--osm-compact")) { osmCompact = true; }
 
         if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+        if (osmFetchBenchTiles > 0) return runOsmFetchBenchmark(osmUrlTemplate, osmFetchBenchTiles, OsmTileManager::Config{}.fetchThreads);
+        if (osmDecodeBenchTiles > 0) return runOsmDecodeBenchmark(osmUrlTemplate, osmDecodeBenchTiles);
+        if (osmPrefetchBenchSeconds > 0.0) return runOsmPrefetchBenchmark(osmUrlTemplate, osmPrefetchBenchSeconds);
+        if (!osmReplay.pathFile.empty())
+        {
+            osmReplay.urlTemplate = osmUrlTemplate;
+            osmReplay.maxZoom = osmMaxZoom;
+            osmReplay.tileRadius = osmTileRadius;
+            return runOsmReplayBenchmark(osmReplay);
+        }
+        if (!osmImportDir.empty() || osmCompact) return runOsmStoreMaintenance(osmCachePath, osmImportDir, osmCompact);
 
         if (!std::filesystem::exists(configPath))
         {
@@ -804,6 +1301,7 @@ int vkglobe::VsgVisualizer::run(int argc, char** argv)
             initialSettings.earthTexturePath = earthTexturePath;
             initialSettings.osmEnabled = osmEnabled;
             initialSettings.osmCachePath = osmCachePath;
+            initialSettings.osmUrlTemplate = osmUrlTemplate;
             initialSettings.osmEnableAltFt = osmEnableAltFt;
             initialSettings.osmDisableAltFt = osmDisableAltFt;
             initialSettings.osmMaxZoom = osmMaxZoom;
@@ -850,17 +1348,10 @@ int vkglobe::VsgVisualizer::run(int argc, char** argv)
             return 1;
         }
         auto osmTileFallback = createOsmTileFallbackTexture();
-        auto tileStateTemplate = vsg::clone(globeStateGroup).cast<vsg::StateGroup>();
-        if (!tileStateTemplate)
-        {
-            std::cerr << "Failed to clone globe state template for OSM tiles." << std::endl;
-            return 1;
-        }
         globeTransform->addChild(globeNode);
         // Keep shell offset small so tiles don't get clipped at low altitude startup.
-        auto osmTileLayer = GlobeTileLayer::create(kWgs84EquatorialRadiusFeet * 1.00001, kWgs84PolarRadiusFeet * 1.00001,
-                                                   tileStateTemplate, osmTileFallback);
-        globeStateGroup->addChild(osmTileLayer->root());
+        auto osmTileLayer = GlobeTileLayer::create(kWgs84EquatorialRadiusFeet * 1.00001, kWgs84PolarRadiusFeet * 1.00001, osmTileFallback);
+        globeTransform->addChild(osmTileLayer->root());
 
         const double aspect = static_cast<double>(window->extent2D().width) / static_cast<double>(window->extent2D().height);
         const double startAltitudeFt = 3.2099e+06;
@@ -887,10 +1378,13 @@ int vkglobe::VsgVisualizer::run(int argc, char** argv)
 #endif
         OsmTileManager::Config osmConfig{};
         osmConfig.cacheRoot = osmCachePath;
+        osmConfig.urlTemplate = osmUrlTemplate;
         osmConfig.enableAltitudeFt = osmEnableAltFt;
         osmConfig.disableAltitudeFt = osmDisableAltFt;
         osmConfig.maxZoom = std::clamp(osmMaxZoom, osmConfig.minZoom, 22);
-        osmConfig.tileRadius = std::clamp(osmTileRadius, 1, 16);
+        osmConfig.tileRadius = std::clamp(osmTileRadius, 1, OsmTileManager::kMaxTileRadius);
+        osmConfig.memoryBudgetBytes = static_cast<size_t>(std::max(16, osmMemoryMb)) * 1024 * 1024;
+        osmConfig.decodedCacheBytes = static_cast<uint64_t>(std::max(0, osmDecodedCacheMb)) * 1024 * 1024;
         appState->osmMaxZoomSetting = osmConfig.maxZoom;
         appState->osmTileRadiusSetting = osmConfig.tileRadius;
         auto osmTiles = OsmTileManager::create(runtimeOptions, osmConfig);
@@ -898,6 +1392,8 @@ int vkglobe::VsgVisualizer::run(int argc, char** argv)
 
         auto commandGraph = vsg::CommandGraph::create(window);
         auto renderGraph = vsg::RenderGraph::create(window);
+        // Tile uploads are transfer commands and must be recorded outside the render pass.
+        commandGraph->addChild(osmTileLayer->uploadCommand());
         commandGraph->addChild(renderGraph);
 
         auto view = vsg::View::create(camera);
@@ -914,6 +1410,8 @@ int vkglobe::VsgVisualizer::run(int argc, char** argv)
                   << " texture=" << (appState->textureFromFile ? "file" : "procedural")
                   << " osm=" << (osmEnabled ? "on" : "off")
                   << " osm_cache=" << osmCachePath
+                  << " osm_url=" << osmUrlTemplate
+                  << " osm_source=" << osmTiles->tileSourceName()
                   << " osm_enable_alt_ft=" << osmEnableAltFt
                   << " osm_disable_alt_ft=" << osmDisableAltFt
                   << " osm_max_zoom=" << osmConfig.maxZoom
@@ -945,20 +1443,23 @@ int vkglobe::VsgVisualizer::run(int argc, char** argv)
 
         if (osmTiles->enabled())
         {
-            // Startup warmup: preload and assign cached/decoded OSM tiles around the
-            // initial view before the first viewer->compile() so the first rendered
-            // frame can start "active" instead of waiting on frame-loop churn.
-            constexpr int kStartupWarmupPasses = 96;
-            for (int pass = 0; pass < kStartupWarmupPasses; ++pass)
+            // Startup warmup: give the background pipeline a short head start on the
+            // tiles around the initial view before the first viewer->compile() so the
+            // first rendered frame can start "active" instead of waiting on frame-loop churn.
+            constexpr auto kStartupWarmupTimeout = std::chrono::seconds(3);
+            const auto warmupDeadline = std::chrono::steady_clock::now() + kStartupWarmupTimeout;
+            for (int pass = 0; std::chrono::steady_clock::now() < warmupDeadline; ++pass)
             {
-                osmTiles->update(lookAt->eye, globeTransform->matrix, kWgs84EquatorialRadiusFeet, kWgs84PolarRadiusFeet);
+                osmTiles->update(lookAt->eye, globeTransform->matrix, kWgs84EquatorialRadiusFeet, kWgs84PolarRadiusFeet,
+                                 camera->projectionMatrix->transform(), camera->viewMatrix->transform(), camera->getViewport().height);
                 osmTileLayer->syncFromTileWindow(osmTiles->currentTileWindow());
 
                 if (!osmTiles->active()) break;
 
+                // Settled once nothing is queued or in flight: failed tiles draw their parent.
                 const size_t visible = osmTiles->visibleTileCount();
                 const size_t loaded = osmTiles->loadedVisibleTiles().size();
-                if (visible > 0 && loaded >= visible)
+                if (visible > 0 && osmTiles->pendingTileCount() == 0)
                 {
                     if (pass > 0)
                     {
@@ -968,12 +1469,22 @@ int vkglobe::VsgVisualizer::run(int argc, char** argv)
                     }
                     break;
                 }
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
             }
         }
 
         viewer->assignRecordAndSubmitTaskAndPresentation({commandGraph});
         viewer->compile();
 
+        std::ofstream cameraRecord;
+        if (!cameraRecordPath.empty())
+        {
+            cameraRecord.open(cameraRecordPath, std::ios::trunc);
+            if (!cameraRecord) std::cerr << "[OSM] could not write camera path '" << cameraRecordPath << "'" << std::endl;
+            cameraRecord << std::setprecision(17)
+                         << "# vkglobe camera path: seconds, eye (3), view (16, column-major), projection (16), viewport height; globe frame\n";
+        }
+
         const auto start = std::chrono::steady_clock::now();
         auto last = start;
 
@@ -1015,9 +1526,9 @@ int vkglobe::VsgVisualizer::run(int argc, char** argv)
                 }
                 globeNode = rebuilt;
                 globeStateGroup = rebuiltStateGroup;
-                globeStateGroup->addChild(osmTileLayer->root());
                 globeTransform->children.clear();
                 globeTransform->addChild(globeNode);
+                globeTransform->addChild(osmTileLayer->root());
             }
 
             appState->ui.deltaTimeMs = 1000.0f * delta;
@@ -1041,6 +1552,7 @@ int vkglobe::VsgVisualizer::run(int argc, char** argv)
                 toSave.earthTexturePath = appState->earthTexturePathSetting;
                 toSave.osmEnabled = appState->osmEnabledSetting;
                 toSave.osmCachePath = appState->osmCachePathSetting;
+                toSave.osmUrlTemplate = osmUrlTemplate;
                 toSave.osmEnableAltFt = appState->osmAltThresholdFtSetting;
                 toSave.osmDisableAltFt = appState->osmAltThresholdFtSetting + 1.0;
                 toSave.osmMaxZoom = appState->osmMaxZoomSetting;
@@ -1051,9 +1563,21 @@ int vkglobe::VsgVisualizer::run(int argc, char** argv)
                 }
             }
 
+            if (cameraRecord.is_open())
+            {
+                const vsg::dmat4 globe = globeTransform->matrix;
+                const vsg::dvec4 eyeLocal = vsg::inverse(globe) * vsg::dvec4(lookAt->eye.x, lookAt->eye.y, lookAt->eye.z, 1.0);
+                writeCameraPathFrame(cameraRecord, CameraPathFrame{std::chrono::duration<double>(now - start).count(),
+                                                                   vsg::dvec3(eyeLocal.x, eyeLocal.y, eyeLocal.z),
+                                                                   camera->viewMatrix->transform() * globe,
+                                                                   camera->projectionMatrix->transform(),
+                                                                   static_cast<double>(camera->getViewport().height)});
+            }
+
             if (osmTiles->enabled())
             {
-                osmTiles->update(lookAt->eye, globeTransform->matrix, kWgs84EquatorialRadiusFeet, kWgs84PolarRadiusFeet);
+                osmTiles->update(lookAt->eye, globeTransform->matrix, kWgs84EquatorialRadiusFeet, kWgs84PolarRadiusFeet,
+                                 camera->projectionMatrix->transform(), camera->viewMatrix->transform(), camera->getViewport().height);
                 const auto tileWindow = osmTiles->currentTileWindow();
                 const bool tileSceneChanged = osmTileLayer->syncFromTileWindow(tileWindow);
                 if (tileSceneChanged && viewer->compileManager)
@@ -1068,15 +1592,28 @@ int vkglobe::VsgVisualizer::run(int argc, char** argv)
                 }
                 if ((frameCount % 120) == 0)
                 {
+                    const vkglobe::OsmDecodeStats decodeStats = osmTiles->decodeStats();
                     std::cout << "[OSM] active=" << (osmTiles->active() ? "yes" : "no")
                               << " zoom=" << osmTiles->currentZoom()
                               << " lat=" << osmTiles->currentLatDeg()
                               << " lon=" << osmTiles->currentLonDeg()
                               << " alt_ft=" << osmTiles->currentAltitudeFt()
                               << " visible_tiles=" << osmTiles->visibleTileCount()
+                              << " predicted_tiles=" << osmTiles->predictedTileCount()
                               << " window_tiles=" << tileWindow.size()
                               << " loaded_visible_tiles=" << osmTiles->loadedVisibleTiles().size()
                               << " cached_tiles=" << osmTiles->cachedTileCount()
+                              << " cache_mib=" << osmTiles->cacheStats().bytes / (1024 * 1024)
+                              << " cache_hits=" << osmTiles->cacheStats().hits
+                              << " cache_misses=" << osmTiles->cacheStats().misses
+                              << " cache_evictions=" << osmTiles->cacheStats().evictions
+                              << " pending_tiles=" << osmTiles->pendingTileCount()
+                              << " cancelled_tiles=" << osmTiles->cancelledTileCount()
+                              << " store_tiles=" << osmTiles->storeStats().tiles
+                              << " png_decodes=" << decodeStats.pngDecodes
+                              << " png_decode_ms=" << (decodeStats.pngDecodes > 0 ? decodeStats.pngDecodeMs / static_cast<double>(decodeStats.pngDecodes) : 0.0)
+                              << " decoded_loads=" << decodeStats.cacheLoads
+                              << " decoded_load_ms=" << (decodeStats.cacheLoads > 0 ? decodeStats.cacheLoadMs / static_cast<double>(decodeStats.cacheLoads) : 0.0)
                               << std::endl;
                 }
             }
@@ -1086,6 +1623,7 @@ int vkglobe::VsgVisualizer::run(int argc, char** argv)
             appState->osmAltitudeFt = osmTiles->currentAltitudeFt();
             appState->osmVisibleTiles = osmTiles->visibleTileCount();
             appState->osmCachedTiles = osmTiles->cachedTileCount();
+            appState->osmCacheStats = osmTiles->cacheStats();
 
             viewer->update();
             viewer->recordAndSubmit();
@@ -1099,6 +1637,7 @@ int vkglobe::VsgVisualizer::run(int argc, char** argv)
         toSave.earthTexturePath = appState->earthTexturePathSetting;
         toSave.osmEnabled = appState->osmEnabledSetting;
         toSave.osmCachePath = appState->osmCachePathSetting;
+        toSave.osmUrlTemplate = osmUrlTemplate;
         toSave.osmEnableAltFt = appState->osmAltThresholdFtSetting;
         toSave.osmDisableAltFt = appState->osmAltThresholdFtSetting + 1.0;
         toSave.osmMaxZoom = appState->osmMaxZoomSetting;
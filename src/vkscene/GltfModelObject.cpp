@@ -1,284 +1,63 @@
 #include "vkscene/GltfModelObject.h"
 
+#include "core/io/ContentHash.h"
+#include "core/io/JsonDocument.h"
+#include "core/io/MappedFile.h"
+
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 #include <algorithm>
 #include <array>
 #include <cctype>
 #include <charconv>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
-#include <fstream>
+#include <filesystem>
+#include <iostream>
 #include <limits>
-#include <map>
 #include <optional>
+#include <span>
 #include <stdexcept>
+#include <string>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VKSCENE_GLTF_SSE2 1
+#else
+#define VKSCENE_GLTF_SSE2 0
+#endif
+
 namespace vkscene {
 namespace {
 
-enum class JsonType {
-    Null,
-    Bool,
-    Number,
-    String,
-    Array,
-    Object,
-};
-
-struct JsonValue {
-    JsonType type = JsonType::Null;
-    bool b = false;
-    double n = 0.0;
-    std::string s;
-    std::vector<JsonValue> a;
-    std::map<std::string, JsonValue> o;
-
-    const JsonValue* get(const std::string& key) const
-    {
-        if (type != JsonType::Object) return nullptr;
-        auto it = o.find(key);
-        return (it == o.end()) ? nullptr : &it->second;
-    }
-
-    const JsonValue* at(size_t i) const
-    {
-        if (type != JsonType::Array || i >= a.size()) return nullptr;
-        return &a[i];
-    }
-
-    std::optional<int64_t> asInt() const
-    {
-        if (type != JsonType::Number) return std::nullopt;
-        return static_cast<int64_t>(n);
-    }
-
-    std::optional<double> asNumber() const
-    {
-        if (type != JsonType::Number) return std::nullopt;
-        return n;
-    }
-
-    std::optional<std::string> asString() const
-    {
-        if (type != JsonType::String) return std::nullopt;
-        return s;
-    }
-};
-
-class JsonParser {
-public:
-    explicit JsonParser(std::string_view text)
-        : text_(text) {}
-
-    JsonValue parse()
-    {
-        skipWs();
-        JsonValue v = parseValue();
-        skipWs();
-        if (pos_ != text_.size()) throw std::runtime_error("unexpected trailing json text");
-        return v;
-    }
-
-private:
-    JsonValue parseValue()
-    {
-        skipWs();
-        if (pos_ >= text_.size()) throw std::runtime_error("unexpected end of json");
-        const char c = text_[pos_];
-        if (c == '{') return parseObject();
-        if (c == '[') return parseArray();
-        if (c == '"') return parseString();
-        if (c == 't') return parseTrue();
-        if (c == 'f') return parseFalse();
-        if (c == 'n') return parseNull();
-        if (c == '-' || std::isdigit(static_cast<unsigned char>(c))) return parseNumber();
-        throw std::runtime_error("invalid json token");
-    }
-
-    JsonValue parseObject()
-    {
-        JsonValue v;
-        v.type = JsonType::Object;
-        ++pos_; // {
-        skipWs();
-        if (peek('}')) {
-            ++pos_;
-            return v;
-        }
-        while (true) {
-            JsonValue key = parseString();
-            skipWs();
-            expect(':');
-            JsonValue value = parseValue();
-            v.o.emplace(key.s, std::move(value));
-            skipWs();
-            if (peek('}')) {
-                ++pos_;
-                break;
-            }
-            expect(',');
-            skipWs();
-        }
-        return v;
-    }
-
-    JsonValue parseArray()
-    {
-        JsonValue v;
-        v.type = JsonType::Array;
-        ++pos_; // [
-        skipWs();
-        if (peek(']')) {
-            ++pos_;
-            return v;
-        }
-        while (true) {
-            v.a.push_back(parseValue());
-            skipWs();
-            if (peek(']')) {
-                ++pos_;
-                break;
-            }
-            expect(',');
-            skipWs();
-        }
-        return v;
-    }
-
-    JsonValue parseString()
-    {
-        expect('"');
-        JsonValue v;
-        v.type = JsonType::String;
-        while (pos_ < text_.size()) {
-            const char c = text_[pos_++];
-            if (c == '"') return v;
-            if (c == '\\') {
-                if (pos_ >= text_.size()) throw std::runtime_error("bad json escape");
-                const char e = text_[pos_++];
-                switch (e) {
-                    case '"': v.s.push_back('"'); break;
-                    case '\\': v.s.push_back('\\'); break;
-                    case '/': v.s.push_back('/'); break;
-                    case 'b': v.s.push_back('\b'); break;
-                    case 'f': v.s.push_back('\f'); break;
-                    case 'n': v.s.push_back('\n'); break;
-                    case 'r': v.s.push_back('\r'); break;
-                    case 't': v.s.push_back('\t'); break;
-                    case 'u': throw std::runtime_error("unicode escape not supported in minimal parser");
-                    default: throw std::runtime_error("invalid json escape");
-                }
-            } else {
-                v.s.push_back(c);
-            }
-        }
-        throw std::runtime_error("unterminated json string");
-    }
-
-    JsonValue parseTrue()
-    {
-        consumeLiteral("true");
-        JsonValue v;
-        v.type = JsonType::Bool;
-        v.b = true;
-        return v;
-    }
-
-    JsonValue parseFalse()
-    {
-        consumeLiteral("false");
-        JsonValue v;
-        v.type = JsonType::Bool;
-        v.b = false;
-        return v;
-    }
-
-    JsonValue parseNull()
-    {
-        consumeLiteral("null");
-        JsonValue v;
-        v.type = JsonType::Null;
-        return v;
-    }
-
-    JsonValue parseNumber()
-    {
-        const size_t start = pos_;
-        if (peek('-')) ++pos_;
-        if (peek('0')) {
-            ++pos_;
-        } else {
-            if (pos_ >= text_.size() || !std::isdigit(static_cast<unsigned char>(text_[pos_]))) throw std::runtime_error("bad number");
-            while (pos_ < text_.size() && std::isdigit(static_cast<unsigned char>(text_[pos_]))) ++pos_;
-        }
-        if (peek('.')) {
-            ++pos_;
-            if (pos_ >= text_.size() || !std::isdigit(static_cast<unsigned char>(text_[pos_]))) throw std::runtime_error("bad fraction");
-            while (pos_ < text_.size() && std::isdigit(static_cast<unsigned char>(text_[pos_]))) ++pos_;
-        }
-        if (peek('e') || peek('E')) {
-            ++pos_;
-            if (peek('+') || peek('-')) ++pos_;
-            if (pos_ >= text_.size() || !std::isdigit(static_cast<unsigned char>(text_[pos_]))) throw std::runtime_error("bad exponent");
-            while (pos_ < text_.size() && std::isdigit(static_cast<unsigned char>(text_[pos_]))) ++pos_;
-        }
-        const std::string_view sv = text_.substr(start, pos_ - start);
-        JsonValue v;
-        v.type = JsonType::Number;
-        std::string temp(sv);
-        char* end = nullptr;
-        v.n = std::strtod(temp.c_str(), &end);
-        if (!end || *end != '\0') throw std::runtime_error("failed number parse");
-        return v;
-    }
-
-    void consumeLiteral(const char* lit)
-    {
-        const size_t len = std::strlen(lit);
-        if (text_.substr(pos_, len) != lit) throw std::runtime_error("invalid json literal");
-        pos_ += len;
-    }
-
-    void skipWs()
-    {
-        while (pos_ < text_.size()) {
-            if (!std::isspace(static_cast<unsigned char>(text_[pos_]))) break;
-            ++pos_;
-        }
-    }
-
-    void expect(char c)
-    {
-        if (pos_ >= text_.size() || text_[pos_] != c) throw std::runtime_error("unexpected json character");
-        ++pos_;
-    }
-
-    bool peek(char c) const { return pos_ < text_.size() && text_[pos_] == c; }
+using core::io::JsonDocument;
+using core::io::JsonType;
+using core::io::JsonValue;
 
-    std::string_view text_;
-    size_t pos_ = 0;
+// Bytes of every glTF buffer, as views into memory-mapped .glb/.bin files. Moving a MappedFile
+// keeps its mapping address, so the views stay valid for as long as this object lives.
+struct GltfBuffers {
+    std::vector<core::io::MappedFile> files;
+    std::vector<std::span<const uint8_t>> views;
 };
 
-std::vector<uint8_t> readBinaryFile(const std::string& path)
+std::span<const uint8_t> mapFile(const std::string& path, std::vector<core::io::MappedFile>& files)
 {
-    std::ifstream f(path, std::ios::binary | std::ios::ate);
-    if (!f) throw std::runtime_error("failed to open file: " + path);
-    const std::streamsize size = f.tellg();
-    if (size <= 0) return {};
-    f.seekg(0, std::ios::beg);
-    std::vector<uint8_t> data(static_cast<size_t>(size));
-    if (!f.read(reinterpret_cast<char*>(data.data()), size)) throw std::runtime_error("failed to read file: " + path);
-    return data;
-}
-
-std::string readTextFile(const std::string& path)
-{
-    const std::vector<uint8_t> bytes = readBinaryFile(path);
-    return std::string(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    core::io::MappedFile file;
+    if (!file.open(path)) {
+        std::error_code ec;
+        if (std::filesystem::file_size(path, ec) == 0 && !ec) return {};
+        throw std::runtime_error("failed to map file: " + path);
+    }
+    const std::span<const uint8_t> bytes = file.bytes();
+    files.push_back(std::move(file));
+    return bytes;
 }
 
 std::string directoryOf(const std::string& path)
@@ -312,7 +91,7 @@ struct AccessorView {
     bool normalized = false;
 };
 
-int componentCountFromType(const std::string& type)
+int componentCountFromType(std::string_view type)
 {
     if (type == "SCALAR") return 1;
     if (type == "VEC2") return 2;
@@ -337,68 +116,115 @@ size_t componentSize(int componentType)
     }
 }
 
-float readComponentAsFloat(const uint8_t* p, int componentType, bool normalized)
+template <typename T, bool Normalized>
+float componentToFloat(T v)
 {
-    switch (componentType) {
-        case 5126: {
-            float v;
-            std::memcpy(&v, p, sizeof(float));
-            return v;
-        }
-        case 5121: {
-            const uint8_t v = *p;
-            return normalized ? static_cast<float>(v) / 255.0f : static_cast<float>(v);
-        }
-        case 5123: {
-            uint16_t v;
-            std::memcpy(&v, p, sizeof(uint16_t));
-            return normalized ? static_cast<float>(v) / 65535.0f : static_cast<float>(v);
-        }
-        case 5125: {
-            uint32_t v;
-            std::memcpy(&v, p, sizeof(uint32_t));
-            return static_cast<float>(v);
-        }
-        case 5120: {
-            int8_t v;
-            std::memcpy(&v, p, sizeof(int8_t));
-            if (!normalized) return static_cast<float>(v);
-            return std::max(-1.0f, static_cast<float>(v) / 127.0f);
-        }
-        case 5122: {
-            int16_t v;
-            std::memcpy(&v, p, sizeof(int16_t));
-            if (!normalized) return static_cast<float>(v);
-            return std::max(-1.0f, static_cast<float>(v) / 32767.0f);
+    if constexpr (!Normalized) {
+        return static_cast<float>(v);
+    } else if constexpr (std::is_signed_v<T>) {
+        return std::max(-1.0f, static_cast<float>(v) / static_cast<float>(std::numeric_limits<T>::max()));
+    } else {
+        return static_cast<float>(v) / static_cast<float>(std::numeric_limits<T>::max());
+    }
+}
+
+// Writes the first N components of accessor elements [first, first + count) as floats into the
+// member at byte offset `member` of out[0, count). One instantiation per component type,
+// normalization and width, picked once per accessor, so the per-element loop has no switches.
+using AttributeConverter = void (*)(const AccessorView& view, size_t first, size_t count, core::Vertex* out, size_t member);
+
+template <typename T, bool Normalized, int N>
+void convertAttribute(const AccessorView& view, size_t first, size_t count, core::Vertex* out, size_t member)
+{
+    const uint8_t* src = view.data + first * view.stride;
+    auto* dst = reinterpret_cast<uint8_t*>(out) + member;
+    for (size_t i = 0; i < count; ++i, src += view.stride, dst += sizeof(core::Vertex)) {
+        std::array<float, N> values;
+        if constexpr (std::is_same_v<T, float>) {
+            std::memcpy(values.data(), src, sizeof(values));
+        } else {
+            std::array<T, N> raw;
+            std::memcpy(raw.data(), src, sizeof(raw));
+            for (int c = 0; c < N; ++c) values[c] = componentToFloat<T, Normalized>(raw[c]);
         }
-        default: return 0.0f;
+        std::memcpy(dst, values.data(), sizeof(values));
+    }
+}
+
+#if VKSCENE_GLTF_SSE2
+// Normalized UNSIGNED_BYTE/UNSIGNED_SHORT, the usual encoding of quantized colors and texcoords:
+// widen and scale all components of an element at once. Dividing, as componentToFloat does, keeps
+// the result bit-identical to the scalar path.
+template <typename T, int N>
+void convertNormalizedSse2(const AccessorView& view, size_t first, size_t count, core::Vertex* out, size_t member)
+{
+    static_assert(std::is_same_v<T, uint8_t> || std::is_same_v<T, uint16_t>);
+    const __m128 maxValue = _mm_set1_ps(static_cast<float>(std::numeric_limits<T>::max()));
+    const __m128i zero = _mm_setzero_si128();
+    const uint8_t* src = view.data + first * view.stride;
+    auto* dst = reinterpret_cast<uint8_t*>(out) + member;
+    for (size_t i = 0; i < count; ++i, src += view.stride, dst += sizeof(core::Vertex)) {
+        uint64_t bits = 0;
+        std::memcpy(&bits, src, sizeof(T) * N);
+        __m128i lanes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&bits));
+        if constexpr (std::is_same_v<T, uint8_t>) lanes = _mm_unpacklo_epi8(lanes, zero);
+        lanes = _mm_unpacklo_epi16(lanes, zero);
+        alignas(16) float values[4];
+        _mm_store_ps(values, _mm_div_ps(_mm_cvtepi32_ps(lanes), maxValue));
+        std::memcpy(dst, values, sizeof(float) * N);
+    }
+}
+#endif
+
+// Null when the accessor has fewer than N components or an unknown component type.
+template <int N>
+AttributeConverter selectConverter(const AccessorView& view)
+{
+    if (view.componentCount < N) return nullptr;
+    switch (view.componentType) {
+        case 5126: return &convertAttribute<float, false, N>;
+        case 5125: return &convertAttribute<uint32_t, false, N>;
+#if VKSCENE_GLTF_SSE2
+        case 5121: return view.normalized ? &convertNormalizedSse2<uint8_t, N> : &convertAttribute<uint8_t, false, N>;
+        case 5123: return view.normalized ? &convertNormalizedSse2<uint16_t, N> : &convertAttribute<uint16_t, false, N>;
+#else
+        case 5121: return view.normalized ? &convertAttribute<uint8_t, true, N> : &convertAttribute<uint8_t, false, N>;
+        case 5123: return view.normalized ? &convertAttribute<uint16_t, true, N> : &convertAttribute<uint16_t, false, N>;
+#endif
+        case 5120: return view.normalized ? &convertAttribute<int8_t, true, N> : &convertAttribute<int8_t, false, N>;
+        case 5122: return view.normalized ? &convertAttribute<int16_t, true, N> : &convertAttribute<int16_t, false, N>;
+        default: return nullptr;
+    }
+}
+
+// Writes base + index for indices [first, first + count) to out and returns the largest index read.
+using IndexConverter = uint32_t (*)(const AccessorView& view, size_t first, size_t count, uint32_t base, uint32_t* out);
+
+template <typename T>
+uint32_t convertIndices(const AccessorView& view, size_t first, size_t count, uint32_t base, uint32_t* out)
+{
+    const uint8_t* src = view.data + first * view.stride;
+    uint32_t maxIndex = 0;
+    for (size_t i = 0; i < count; ++i, src += view.stride) {
+        T index;
+        std::memcpy(&index, src, sizeof(T));
+        maxIndex = std::max<uint32_t>(maxIndex, index);
+        out[i] = base + index;
     }
+    return maxIndex;
 }
 
-uint32_t readIndex(const uint8_t* p, int componentType)
+IndexConverter selectIndexConverter(int componentType)
 {
     switch (componentType) {
-        case 5121: {
-            uint8_t v;
-            std::memcpy(&v, p, sizeof(uint8_t));
-            return static_cast<uint32_t>(v);
-        }
-        case 5123: {
-            uint16_t v;
-            std::memcpy(&v, p, sizeof(uint16_t));
-            return static_cast<uint32_t>(v);
-        }
-        case 5125: {
-            uint32_t v;
-            std::memcpy(&v, p, sizeof(uint32_t));
-            return v;
-        }
-        default:
-            throw std::runtime_error("unsupported index component type");
+        case 5121: return &convertIndices<uint8_t>;
+        case 5123: return &convertIndices<uint16_t>;
+        case 5125: return &convertIndices<uint32_t>;
+        default: throw std::runtime_error("unsupported index component type");
     }
 }
 
-AccessorView makeAccessorView(const JsonValue& doc, const std::vector<std::vector<uint8_t>>& buffers, int accessorIndex)
+AccessorView makeAccessorView(const JsonValue& doc, const GltfBuffers& buffers, int accessorIndex)
 {
     const JsonValue* accessors = doc.get("accessors");
     const JsonValue* bufferViews = doc.get("bufferViews");
@@ -419,28 +245,44 @@ AccessorView makeAccessorView(const JsonValue& doc, const std::vector<std::vecto
     const JsonValue* bufferField = bv->get("buffer");
     if (!bufferField) throw std::runtime_error("bufferView missing buffer field");
     const int bufferIndex = static_cast<int>(bufferField->asInt().value_or(-1));
-    if (bufferIndex < 0 || static_cast<size_t>(bufferIndex) >= buffers.size()) throw std::runtime_error("invalid buffer index");
+    if (bufferIndex < 0 || static_cast<size_t>(bufferIndex) >= buffers.views.size()) throw std::runtime_error("invalid buffer index");
 
     const JsonValue* componentField = acc->get("componentType");
     const JsonValue* typeField = acc->get("type");
     const JsonValue* countField = acc->get("count");
     if (!componentField || !typeField || !countField) throw std::runtime_error("accessor missing required fields");
     const int componentType = static_cast<int>(componentField->asInt().value_or(0));
-    const std::string type = typeField->asString().value_or("");
+    const std::string_view type = typeField->asString().value_or("");
     const int compCount = componentCountFromType(type);
     if (compCount <= 0) throw std::runtime_error("unsupported accessor type");
     const size_t compSize = componentSize(componentType);
     if (compSize == 0) throw std::runtime_error("unsupported accessor component type");
 
-    const size_t count = static_cast<size_t>(countField->asInt().value_or(0));
-    const size_t accessorOffset = static_cast<size_t>(acc->get("byteOffset") ? acc->get("byteOffset")->asInt().value_or(0) : 0);
-    const size_t viewOffset = static_cast<size_t>(bv->get("byteOffset") ? bv->get("byteOffset")->asInt().value_or(0) : 0);
-    const size_t stride = static_cast<size_t>(bv->get("byteStride") ? bv->get("byteStride")->asInt().value_or(0) : compSize * compCount);
+    // Sizes and offsets come from the manifest: negative ones are rejected before they become
+    // size_t, and the bounds check below is written so that nothing in it can overflow.
+    const auto intField = [](const JsonValue& object, std::string_view key, int64_t fallback) {
+        const JsonValue* field = object.get(key);
+        return field ? field->asInt().value_or(-1) : fallback;
+    };
+    const int64_t countValue = countField->asInt().value_or(-1);
+    const int64_t accessorOffsetValue = intField(*acc, "byteOffset", 0);
+    const int64_t viewOffsetValue = intField(*bv, "byteOffset", 0);
+    const int64_t strideValue = intField(*bv, "byteStride", static_cast<int64_t>(compSize) * compCount);
+    if (countValue < 0 || accessorOffsetValue < 0 || viewOffsetValue < 0 || strideValue < 0) {
+        throw std::runtime_error("accessor count, byteOffset or byteStride is not a non-negative integer");
+    }
+    const size_t count = static_cast<size_t>(countValue);
+    const size_t accessorOffset = static_cast<size_t>(accessorOffsetValue);
+    const size_t viewOffset = static_cast<size_t>(viewOffsetValue);
+    const size_t stride = static_cast<size_t>(strideValue);
+    if (stride < compSize * static_cast<size_t>(compCount)) throw std::runtime_error("bufferView byteStride smaller than accessor element");
     const bool normalized = acc->get("normalized") && acc->get("normalized")->type == JsonType::Bool && acc->get("normalized")->b;
 
-    const std::vector<uint8_t>& buf = buffers[static_cast<size_t>(bufferIndex)];
+    // stride > 0 here, since it covers at least one component.
+    const std::span<const uint8_t> buf = buffers.views[static_cast<size_t>(bufferIndex)];
+    if (viewOffset > buf.size() || accessorOffset > buf.size() - viewOffset) throw std::runtime_error("accessor points outside buffer");
     const size_t begin = viewOffset + accessorOffset;
-    if (begin + count * stride > buf.size()) throw std::runtime_error("accessor points outside buffer");
+    if (count > (buf.size() - begin) / stride) throw std::runtime_error("accessor points outside buffer");
 
     return AccessorView{
         .data = buf.data() + begin,
@@ -452,40 +294,52 @@ AccessorView makeAccessorView(const JsonValue& doc, const std::vector<std::vecto
     };
 }
 
-std::vector<std::vector<uint8_t>> loadBuffersFromDocument(const JsonValue& doc, const std::string& modelPath)
+void loadBuffersFromDocument(const JsonValue& doc, const std::string& modelPath, GltfBuffers& out)
 {
     const JsonValue* buffers = doc.get("buffers");
     if (!buffers || buffers->type != JsonType::Array) throw std::runtime_error("gltf missing buffers array");
-    std::vector<std::vector<uint8_t>> out;
-    out.reserve(buffers->a.size());
+    out.views.reserve(buffers->size());
     const std::string baseDir = directoryOf(modelPath);
 
-    for (size_t i = 0; i < buffers->a.size(); ++i) {
-        const JsonValue& b = buffers->a[i];
+    for (size_t i = 0; i < buffers->size(); ++i) {
+        const JsonValue& b = *buffers->at(i);
         if (b.type != JsonType::Object) throw std::runtime_error("invalid buffer entry");
-        const std::string uri = b.get("uri") ? b.get("uri")->asString().value_or("") : "";
+        const std::string uri(b.get("uri") ? b.get("uri")->asString().value_or("") : "");
         if (uri.empty()) {
             throw std::runtime_error("external .gltf missing buffer uri for buffer " + std::to_string(i));
         }
         if (uri.rfind("data:", 0) == 0) {
             throw std::runtime_error("data URI buffers are not supported in minimal loader");
         }
-        out.push_back(readBinaryFile(baseDir + "/" + uri));
+        out.views.push_back(mapFile(baseDir + "/" + uri, out.files));
     }
-    return out;
 }
 
-void loadMeshFromDocument(const JsonValue& doc, const std::vector<std::vector<uint8_t>>& buffers, std::vector<core::Vertex>& outVertices,
-                          std::vector<uint32_t>& outIndices)
-{
-    const JsonValue* meshes = doc.get("meshes");
-    if (!meshes || meshes->type != JsonType::Array || meshes->a.empty()) throw std::runtime_error("gltf has no meshes");
+struct Bounds {
+    glm::vec3 min{std::numeric_limits<float>::max()};
+    glm::vec3 max{std::numeric_limits<float>::lowest()};
+
+    bool valid() const { return min.x <= max.x; }
+    void add(const glm::vec3& p)
+    {
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+    }
+};
 
-    const JsonValue& mesh0 = meshes->a[0];
-    const JsonValue* prims = mesh0.get("primitives");
-    if (!prims || prims->type != JsonType::Array || prims->a.empty()) throw std::runtime_error("mesh has no primitives");
+// Everything a GltfModelObject keeps: the unique meshes, concatenated, and the node tree that
+// places them.
+struct LoadedModel {
+    std::vector<core::Vertex> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<MeshRange> meshRanges;
+    std::vector<ObjectNode> nodes;
+};
 
-    const JsonValue& prim = prims->a[0];
+// Appends one triangle primitive, with its indices offset to address outVertices as a whole.
+void appendPrimitive(const JsonValue& doc, const GltfBuffers& buffers, const JsonValue& prim, std::vector<core::Vertex>& outVertices,
+                     std::vector<uint32_t>& outIndices, Bounds& bounds)
+{
     const JsonValue* attrs = prim.get("attributes");
     if (!attrs || attrs->type != JsonType::Object) throw std::runtime_error("primitive missing attributes");
 
@@ -502,70 +356,291 @@ void loadMeshFromDocument(const JsonValue& doc, const std::vector<std::vector<ui
     std::optional<AccessorView> uv;
     if (uvAcc >= 0) uv = makeAccessorView(doc, buffers, uvAcc);
 
-    outVertices.clear();
-    outVertices.reserve(pos.count);
-
-    glm::vec3 minP(std::numeric_limits<float>::max());
-    glm::vec3 maxP(std::numeric_limits<float>::lowest());
-
-    for (size_t i = 0; i < pos.count; ++i) {
-        const uint8_t* p = pos.data + i * pos.stride;
-        glm::vec3 vtxPos(
-            readComponentAsFloat(p + 0 * componentSize(pos.componentType), pos.componentType, pos.normalized),
-            readComponentAsFloat(p + 1 * componentSize(pos.componentType), pos.componentType, pos.normalized),
-            readComponentAsFloat(p + 2 * componentSize(pos.componentType), pos.componentType, pos.normalized));
-
-        glm::vec3 col(1.0f, 1.0f, 1.0f);
-        if (color.has_value() && i < color->count) {
-            const uint8_t* c = color->data + i * color->stride;
-            const size_t csz = componentSize(color->componentType);
-            col.r = readComponentAsFloat(c + 0 * csz, color->componentType, color->normalized);
-            col.g = (color->componentCount > 1) ? readComponentAsFloat(c + 1 * csz, color->componentType, color->normalized) : col.r;
-            col.b = (color->componentCount > 2) ? readComponentAsFloat(c + 2 * csz, color->componentType, color->normalized) : col.r;
+    const size_t baseVertex = outVertices.size();
+    if (baseVertex + pos.count > std::numeric_limits<uint32_t>::max()) throw std::runtime_error("model has too many vertices");
+
+    const AttributeConverter convertPos = selectConverter<3>(pos);
+    if (!convertPos) throw std::runtime_error("unsupported POSITION component type");
+    // Colors with fewer than three components repeat the first one into the missing channels.
+    AttributeConverter convertColor = nullptr;
+    int colorComponents = 0;
+    if (color.has_value()) {
+        colorComponents = std::min(color->componentCount, 3);
+        if (colorComponents == 3) convertColor = selectConverter<3>(*color);
+        else if (colorComponents == 2) convertColor = selectConverter<2>(*color);
+        else convertColor = selectConverter<1>(*color);
+    }
+    AttributeConverter convertUv = nullptr;
+    int uvComponents = 0;
+    if (uv.has_value()) {
+        uvComponents = std::min(uv->componentCount, 2);
+        convertUv = uvComponents == 2 ? selectConverter<2>(*uv) : selectConverter<1>(*uv);
+    }
+    const size_t colorCount = convertColor ? std::min(color->count, pos.count) : 0;
+    const size_t uvCount = convertUv ? std::min(uv->count, pos.count) : 0;
+
+    // Convert a block at a time into a buffer small enough to stay in cache, so each vertex
+    // reaches outVertices in a single write however many attribute passes fill it.
+    constexpr size_t kBlockVertices = 2048;
+    const core::Vertex defaults{glm::vec3(0.0f), glm::vec3(1.0f), glm::vec2(0.0f)};
+    std::vector<core::Vertex> block(std::min(kBlockVertices, pos.count));
+    for (size_t first = 0; first < pos.count; first += kBlockVertices) {
+        const size_t n = std::min(kBlockVertices, pos.count - first);
+        std::fill_n(block.begin(), n, defaults);
+        convertPos(pos, first, n, block.data(), offsetof(core::Vertex, pos));
+        if (first < colorCount) {
+            const size_t m = std::min(n, colorCount - first);
+            convertColor(*color, first, m, block.data(), offsetof(core::Vertex, color));
+            if (colorComponents < 3) {
+                for (size_t i = 0; i < m; ++i) {
+                    glm::vec3& c = block[i].color;
+                    if (colorComponents == 1) c.g = c.r;
+                    c.b = c.r;
+                }
+            }
         }
-
-        glm::vec2 tex(0.0f, 0.0f);
-        if (uv.has_value() && i < uv->count) {
-            const uint8_t* t = uv->data + i * uv->stride;
-            const size_t tsz = componentSize(uv->componentType);
-            tex.x = readComponentAsFloat(t + 0 * tsz, uv->componentType, uv->normalized);
-            tex.y = (uv->componentCount > 1) ? readComponentAsFloat(t + 1 * tsz, uv->componentType, uv->normalized) : 0.0f;
+        if (first < uvCount) {
+            convertUv(*uv, first, std::min(n, uvCount - first), block.data(), offsetof(core::Vertex, uv));
         }
-
-        minP = glm::min(minP, vtxPos);
-        maxP = glm::max(maxP, vtxPos);
-        outVertices.push_back(core::Vertex{vtxPos, col, tex});
-    }
-
-    const glm::vec3 extent = maxP - minP;
-    const float maxExtent = std::max(extent.x, std::max(extent.y, extent.z));
-    if (maxExtent > 0.0f) {
-        const glm::vec3 center = (maxP + minP) * 0.5f;
-        const float scale = 80.0f / maxExtent;
-        for (auto& v : outVertices) {
-            v.pos = (v.pos - center) * scale;
+        glm::vec3 lo = bounds.min;
+        glm::vec3 hi = bounds.max;
+        for (size_t i = 0; i < n; ++i) {
+            const glm::vec3& p = block[i].pos;
+            lo.x = std::min(lo.x, p.x);
+            lo.y = std::min(lo.y, p.y);
+            lo.z = std::min(lo.z, p.z);
+            hi.x = std::max(hi.x, p.x);
+            hi.y = std::max(hi.y, p.y);
+            hi.z = std::max(hi.z, p.z);
         }
+        bounds.min = lo;
+        bounds.max = hi;
+        outVertices.insert(outVertices.end(), block.begin(), block.begin() + static_cast<std::ptrdiff_t>(n));
     }
 
-    outIndices.clear();
+    const uint32_t base = static_cast<uint32_t>(baseVertex);
     const int idxAcc = static_cast<int>(prim.get("indices") ? prim.get("indices")->asInt().value_or(-1) : -1);
     if (idxAcc >= 0) {
         const AccessorView idx = makeAccessorView(doc, buffers, idxAcc);
         if (idx.componentCount != 1) throw std::runtime_error("index accessor must be scalar");
-        outIndices.reserve(idx.count);
-        for (size_t i = 0; i < idx.count; ++i) {
-            const uint8_t* p = idx.data + i * idx.stride;
-            outIndices.push_back(readIndex(p, idx.componentType));
+        const IndexConverter convertIdx = selectIndexConverter(idx.componentType);
+        const size_t firstIndex = outIndices.size();
+        outIndices.resize(firstIndex + idx.count);
+        uint32_t maxIndex = 0;
+        for (size_t first = 0; first < idx.count; first += kBlockVertices) {
+            const size_t n = std::min(kBlockVertices, idx.count - first);
+            maxIndex = std::max(maxIndex, convertIdx(idx, first, n, base, outIndices.data() + firstIndex + first));
+        }
+        if (idx.count > 0 && maxIndex >= pos.count) throw std::runtime_error("primitive index out of range");
+    } else {
+        for (uint32_t i = 0; i < static_cast<uint32_t>(pos.count); ++i) outIndices.push_back(base + i);
+    }
+}
+
+template <size_t N>
+bool readNumbers(const JsonValue* array, std::array<float, N>& out)
+{
+    if (!array || array->size() != N) return false;
+    for (size_t i = 0; i < N; ++i) {
+        const std::optional<double> value = array->at(i)->asNumber();
+        if (!value) return false;
+        out[i] = static_cast<float>(*value);
+    }
+    return true;
+}
+
+glm::mat4 nodeLocalTransform(const JsonValue& node)
+{
+    std::array<float, 16> matrix{};
+    if (readNumbers(node.get("matrix"), matrix)) {
+        glm::mat4 m(1.0f);
+        for (int c = 0; c < 4; ++c) {
+            for (int r = 0; r < 4; ++r) m[c][r] = matrix[static_cast<size_t>(c * 4 + r)];
+        }
+        return m;
+    }
+
+    glm::mat4 m(1.0f);
+    std::array<float, 3> translation{};
+    if (readNumbers(node.get("translation"), translation)) m = glm::translate(m, glm::vec3(translation[0], translation[1], translation[2]));
+    std::array<float, 4> rotation{}; // x, y, z, w
+    if (readNumbers(node.get("rotation"), rotation)) m = m * glm::mat4_cast(glm::quat(rotation[3], rotation[0], rotation[1], rotation[2]));
+    std::array<float, 3> scale{};
+    if (readNumbers(node.get("scale"), scale)) m = glm::scale(m, glm::vec3(scale[0], scale[1], scale[2]));
+    return m;
+}
+
+// Flattens the default scene's node tree in pre-order under a root node. A node reachable along
+// several paths (invalid glTF) is kept once, which also breaks cycles. Files without nodes get one
+// node per mesh, so a bare mesh library still shows something.
+void loadNodesFromDocument(const JsonValue& doc, size_t meshCount, std::vector<ObjectNode>& outNodes)
+{
+    outNodes.push_back(ObjectNode{"GltfRoot", -1, glm::mat4(1.0f), -1});
+
+    const JsonValue* nodes = doc.get("nodes");
+    const size_t nodeCount = (nodes && nodes->type == JsonType::Array) ? nodes->size() : 0;
+
+    std::vector<size_t> roots;
+    const JsonValue* scenes = doc.get("scenes");
+    const int64_t sceneIndex = doc.get("scene") ? doc.get("scene")->asInt().value_or(0) : 0;
+    const JsonValue* scene = (scenes && sceneIndex >= 0) ? scenes->at(static_cast<size_t>(sceneIndex)) : nullptr;
+    if (scene && scene->get("nodes")) {
+        const JsonValue* sceneNodes = scene->get("nodes");
+        for (size_t i = 0; i < sceneNodes->size(); ++i) {
+            const int64_t node = sceneNodes->at(i)->asInt().value_or(-1);
+            if (node >= 0 && static_cast<size_t>(node) < nodeCount) roots.push_back(static_cast<size_t>(node));
         }
     } else {
-        outIndices.reserve(outVertices.size());
-        for (uint32_t i = 0; i < static_cast<uint32_t>(outVertices.size()); ++i) outIndices.push_back(i);
+        std::vector<bool> isChild(nodeCount, false);
+        for (size_t i = 0; i < nodeCount; ++i) {
+            const JsonValue* children = nodes->at(i)->get("children");
+            for (size_t c = 0; children && c < children->size(); ++c) {
+                const int64_t child = children->at(c)->asInt().value_or(-1);
+                if (child >= 0 && static_cast<size_t>(child) < nodeCount) isChild[static_cast<size_t>(child)] = true;
+            }
+        }
+        for (size_t i = 0; i < nodeCount; ++i) {
+            if (!isChild[i]) roots.push_back(i);
+        }
+    }
+
+    struct PendingNode {
+        size_t node;
+        int32_t parent;
+    };
+    std::vector<PendingNode> stack;
+    for (auto it = roots.rbegin(); it != roots.rend(); ++it) stack.push_back(PendingNode{*it, 0});
+    std::vector<bool> visited(nodeCount, false);
+    while (!stack.empty()) {
+        const PendingNode pending = stack.back();
+        stack.pop_back();
+        if (visited[pending.node]) continue;
+        visited[pending.node] = true;
+
+        const JsonValue& node = *nodes->at(pending.node);
+        const int64_t mesh = node.get("mesh") ? node.get("mesh")->asInt().value_or(-1) : -1;
+        const std::optional<std::string_view> name = node.get("name") ? node.get("name")->asString() : std::nullopt;
+        const int32_t index = static_cast<int32_t>(outNodes.size());
+        outNodes.push_back(ObjectNode{
+            .name = name ? std::string(*name) : "node" + std::to_string(pending.node),
+            .parent = pending.parent,
+            .localTransform = nodeLocalTransform(node),
+            .mesh = (mesh >= 0 && static_cast<size_t>(mesh) < meshCount) ? static_cast<int32_t>(mesh) : -1,
+        });
+
+        const JsonValue* children = node.get("children");
+        for (size_t c = children ? children->size() : 0; c > 0; --c) {
+            const int64_t child = children->at(c - 1)->asInt().value_or(-1);
+            if (child >= 0 && static_cast<size_t>(child) < nodeCount) stack.push_back(PendingNode{static_cast<size_t>(child), index});
+        }
+    }
+
+    if (nodeCount == 0) {
+        for (size_t m = 0; m < meshCount; ++m) {
+            outNodes.push_back(ObjectNode{"mesh" + std::to_string(m), 0, glm::mat4(1.0f), static_cast<int32_t>(m)});
+        }
+    }
+}
+
+// Element count of the accessor at index, or 0 when there is none. The count is validated against
+// the buffer, so a hostile manifest cannot size the storage beyond what the file holds.
+size_t accessorCount(const JsonValue& doc, const GltfBuffers& buffers, const JsonValue* index)
+{
+    const int accessor = static_cast<int>(index ? index->asInt().value_or(-1) : -1);
+    return accessor >= 0 ? makeAccessorView(doc, buffers, accessor).count : 0;
+}
+
+bool isTriangleList(const JsonValue& prim)
+{
+    // Only triangle lists; points, lines and strips/fans (rare in practice) are skipped.
+    return (prim.get("mode") ? prim.get("mode")->asInt().value_or(4) : 4) == 4;
+}
+
+// Loads every mesh some node references, once, then scales the whole node tree to the 80-unit
+// extent the single-mesh loader used to bake into the vertices.
+void loadModelFromDocument(const JsonValue& doc, const GltfBuffers& buffers, LoadedModel& out)
+{
+    const JsonValue* meshes = doc.get("meshes");
+    if (!meshes || meshes->type != JsonType::Array || meshes->size() == 0) throw std::runtime_error("gltf has no meshes");
+
+    loadNodesFromDocument(doc, meshes->size(), out.nodes);
+    std::vector<bool> referenced(meshes->size(), false);
+    for (const ObjectNode& node : out.nodes) {
+        if (node.mesh >= 0) referenced[static_cast<size_t>(node.mesh)] = true;
+    }
+
+    // Size both arrays once, so large multi-primitive models are not copied on every growth step.
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    for (size_t m = 0; m < meshes->size(); ++m) {
+        const JsonValue* prims = referenced[m] ? meshes->at(m)->get("primitives") : nullptr;
+        for (size_t p = 0; prims && p < prims->size(); ++p) {
+            const JsonValue& prim = *prims->at(p);
+            if (!isTriangleList(prim)) continue;
+            const JsonValue* attrs = prim.get("attributes");
+            const size_t vertices = accessorCount(doc, buffers, attrs ? attrs->get("POSITION") : nullptr);
+            vertexCount += vertices;
+            indexCount += prim.get("indices") ? accessorCount(doc, buffers, prim.get("indices")) : vertices;
+        }
+    }
+    out.vertices.reserve(vertexCount);
+    out.indices.reserve(indexCount);
+
+    out.meshRanges.assign(meshes->size(), MeshRange{});
+    std::vector<Bounds> meshBounds(meshes->size());
+    for (size_t m = 0; m < meshes->size(); ++m) {
+        if (!referenced[m]) continue;
+        const JsonValue* prims = meshes->at(m)->get("primitives");
+        if (!prims || prims->type != JsonType::Array) throw std::runtime_error("mesh has no primitives");
+        const size_t firstIndex = out.indices.size();
+        for (size_t p = 0; p < prims->size(); ++p) {
+            const JsonValue& prim = *prims->at(p);
+            if (!isTriangleList(prim)) continue;
+            appendPrimitive(doc, buffers, prim, out.vertices, out.indices, meshBounds[m]);
+        }
+        out.meshRanges[m] = MeshRange{static_cast<uint32_t>(firstIndex), static_cast<uint32_t>(out.indices.size() - firstIndex)};
+    }
+    if (out.indices.empty()) throw std::runtime_error("gltf has no triangle meshes");
+
+    Bounds sceneBounds;
+    std::vector<glm::mat4> world(out.nodes.size(), glm::mat4(1.0f));
+    for (size_t i = 1; i < out.nodes.size(); ++i) {
+        const ObjectNode& node = out.nodes[i];
+        world[i] = world[static_cast<size_t>(node.parent)] * node.localTransform;
+        if (node.mesh < 0 || !meshBounds[static_cast<size_t>(node.mesh)].valid()) continue;
+        const Bounds& b = meshBounds[static_cast<size_t>(node.mesh)];
+        for (int corner = 0; corner < 8; ++corner) {
+            const glm::vec4 p((corner & 1) ? b.max.x : b.min.x, (corner & 2) ? b.max.y : b.min.y, (corner & 4) ? b.max.z : b.min.z, 1.0f);
+            const glm::vec4 w = world[i] * p;
+            sceneBounds.add(glm::vec3(w.x, w.y, w.z));
+        }
+    }
+
+    if (sceneBounds.valid()) {
+        const glm::vec3 extent = sceneBounds.max - sceneBounds.min;
+        const float maxExtent = std::max(extent.x, std::max(extent.y, extent.z));
+        if (maxExtent > 0.0f) {
+            const glm::vec3 center = (sceneBounds.max + sceneBounds.min) * 0.5f;
+            const float scale = 80.0f / maxExtent;
+            out.nodes[0].localTransform = glm::translate(glm::scale(glm::mat4(1.0f), glm::vec3(scale)), -center);
+        }
     }
 }
 
-void loadFromGlb(const std::string& path, std::vector<core::Vertex>& outVertices, std::vector<uint32_t>& outIndices)
+// The files a model is loaded from, mapped, and its manifest. Opening a source reads no more than
+// it must to find every file: a .glb is one file, a .gltf names its buffers in its JSON.
+struct GltfSource {
+    GltfBuffers buffers{}; // files holds the .glb, or the .gltf followed by its buffer files
+    std::string_view jsonText{};
+    std::optional<JsonDocument> doc{};
+};
+
+// The JSON chunk is parsed in place and the BIN chunk becomes buffer 0, both straight from the
+// mapping; nothing of the file is copied before accessor conversion.
+void openGlb(const std::string& path, GltfSource& source)
 {
-    const std::vector<uint8_t> bytes = readBinaryFile(path);
+    GltfBuffers& buffers = source.buffers;
+    const std::span<const uint8_t> bytes = mapFile(path, buffers.files);
     if (bytes.size() < 20) throw std::runtime_error("glb file too small");
 
     const uint32_t magic = readU32LE(bytes.data() + 0);
@@ -575,8 +650,7 @@ void loadFromGlb(const std::string& path, std::vector<core::Vertex>& outVertices
     if (version != 2) throw std::runtime_error("unsupported glb version");
     if (length > bytes.size()) throw std::runtime_error("invalid glb length");
 
-    std::string jsonText;
-    std::vector<std::vector<uint8_t>> buffers;
+    std::string_view& jsonText = source.jsonText;
 
     size_t offset = 12;
     while (offset + 8 <= length) {
@@ -586,46 +660,84 @@ void loadFromGlb(const std::string& path, std::vector<core::Vertex>& outVertices
         if (offset + chunkLen > length) throw std::runtime_error("corrupt glb chunk");
 
         if (chunkType == 0x4E4F534A) {
-            jsonText.assign(reinterpret_cast<const char*>(bytes.data() + offset), chunkLen);
-            while (!jsonText.empty() && (jsonText.back() == '\0' || std::isspace(static_cast<unsigned char>(jsonText.back())))) jsonText.pop_back();
+            jsonText = std::string_view(reinterpret_cast<const char*>(bytes.data() + offset), chunkLen);
+            while (!jsonText.empty() && (jsonText.back() == '\0' || std::isspace(static_cast<unsigned char>(jsonText.back())))) jsonText.remove_suffix(1);
         } else if (chunkType == 0x004E4942) {
-            buffers.push_back(std::vector<uint8_t>(bytes.begin() + static_cast<std::ptrdiff_t>(offset),
-                                                   bytes.begin() + static_cast<std::ptrdiff_t>(offset + chunkLen)));
+            buffers.views.push_back(bytes.subspan(offset, chunkLen));
         }
         offset += chunkLen;
     }
 
     if (jsonText.empty()) throw std::runtime_error("glb missing JSON chunk");
-    if (buffers.empty()) buffers.emplace_back();
+    if (buffers.views.empty()) buffers.views.emplace_back();
+}
 
-    const JsonValue doc = JsonParser(jsonText).parse();
-    loadMeshFromDocument(doc, buffers, outVertices, outIndices);
+void openGltf(const std::string& path, GltfSource& source)
+{
+    const std::span<const uint8_t> text = mapFile(path, source.buffers.files);
+    source.jsonText = std::string_view(reinterpret_cast<const char*>(text.data()), text.size());
+    source.doc.emplace(source.jsonText);
+    loadBuffersFromDocument(source.doc->root(), path, source.buffers);
+}
+
+void loadModel(GltfSource& source, LoadedModel& out)
+{
+    if (!source.doc) source.doc.emplace(source.jsonText);
+    loadModelFromDocument(source.doc->root(), source.buffers, out);
 }
 
-void loadFromGltf(const std::string& path, std::vector<core::Vertex>& outVertices, std::vector<uint32_t>& outIndices)
+// Bump whenever the loader's output for the same file changes, so older cooked meshes are rebuilt.
+constexpr uint32_t kMeshCacheLoaderVersion = 1;
+
+MeshCacheKey meshCacheKey(const GltfSource& source)
 {
-    const std::string jsonText = readTextFile(path);
-    const JsonValue doc = JsonParser(jsonText).parse();
-    const std::vector<std::vector<uint8_t>> buffers = loadBuffersFromDocument(doc, path);
-    loadMeshFromDocument(doc, buffers, outVertices, outIndices);
+    MeshCacheKey key{.loaderVersion = kMeshCacheLoaderVersion};
+    for (const core::io::MappedFile& file : source.buffers.files) {
+        key.sourceHash = core::io::hashContent(file.bytes(), key.sourceHash);
+        key.sourceSize += file.size();
+    }
+    return key;
 }
 
 } // namespace
 
-GltfModelObject::GltfModelObject(std::string path, uint32_t textureSlot)
+GltfModelObject::GltfModelObject(std::string path, uint32_t textureSlot, MeshCacheOptions cacheOptions)
     : RenderObject("GltfModelObject", PrimitiveType::Triangles, ShaderSet{"cube.vert.spv", "cube.frag.spv"},
                    Material{.textureSlot = textureSlot, .baseColor = glm::vec4(1.0f)}),
       path_(std::move(path))
 {
     try {
+        GltfSource source;
         if (endsWith(path_, ".glb")) {
-            loadFromGlb(path_, vertices_, indices_);
+            openGlb(path_, source);
         } else if (endsWith(path_, ".gltf")) {
-            loadFromGltf(path_, vertices_, indices_);
+            openGltf(path_, source);
         } else {
             throw std::runtime_error("model extension must be .gltf or .glb");
         }
-        loaded_ = !vertices_.empty() && !indices_.empty();
+
+        MeshCacheKey cacheKey{};
+        std::filesystem::path cachePath;
+        if (cacheOptions.enabled) {
+            cacheKey = meshCacheKey(source);
+            cachePath = meshCachePath(path_, cacheOptions.directory);
+            if (cache_.open(cachePath, cacheKey)) {
+                meshRanges_ = cache_.meshRanges();
+                nodes_ = cache_.nodes();
+            }
+        }
+        if (!cache_.isOpen()) {
+            LoadedModel model;
+            loadModel(source, model);
+            vertices_ = std::move(model.vertices);
+            indices_ = std::move(model.indices);
+            meshRanges_ = std::move(model.meshRanges);
+            nodes_ = std::move(model.nodes);
+            if (cacheOptions.enabled && !writeMeshCache(cachePath, cacheKey, vertices_, indices_, meshRanges_, nodes_)) {
+                std::cerr << "warning: could not write mesh cache '" << cachePath.string() << "'\n";
+            }
+        }
+        loaded_ = vertexCount() > 0 && indexCount() > 0;
         if (!loaded_) {
             error_ = "loaded model has no vertices/indices";
         } else {
@@ -641,8 +753,25 @@ GltfModelObject::GltfModelObject(std::string path, uint32_t textureSlot)
 
 void GltfModelObject::buildMesh(std::vector<core::Vertex>& outVertices, std::vector<uint32_t>& outIndices) const
 {
-    outVertices = vertices_;
-    outIndices = indices_;
+    if (!cache_.isOpen()) {
+        outVertices = vertices_;
+        outIndices = indices_;
+        return;
+    }
+    outVertices.resize(cache_.vertexCount());
+    outIndices.resize(cache_.indexCount());
+    std::memcpy(outVertices.data(), cache_.vertexBytes().data(), cache_.vertexBytes().size());
+    std::memcpy(outIndices.data(), cache_.indexBytes().data(), cache_.indexBytes().size());
+}
+
+size_t GltfModelObject::vertexCount() const
+{
+    return cache_.isOpen() ? cache_.vertexCount() : vertices_.size();
+}
+
+size_t GltfModelObject::indexCount() const
+{
+    return cache_.isOpen() ? cache_.indexCount() : indices_.size();
 }
 
 void GltfModelObject::update(float /*deltaSeconds*/, float elapsedSeconds)
@@ -1,26 +1,39 @@
 #pragma once
 
+#include "vkscene/MeshCache.h"
 #include "vkscene/RenderObject.h"
 
 #include <string>
 
 namespace vkscene {
 
+// A glTF model: every mesh some node of the default scene references, loaded once, and the node
+// tree that places (and possibly repeats) them. The converted meshes are cooked into a mesh cache
+// on first load; while the model's files are unchanged, later loads map the cache instead.
 class GltfModelObject final : public RenderObject {
 public:
-    explicit GltfModelObject(std::string path, uint32_t textureSlot = 0);
+    explicit GltfModelObject(std::string path, uint32_t textureSlot = 0, MeshCacheOptions cacheOptions = {});
 
     bool loaded() const { return loaded_; }
     const std::string& error() const { return error_; }
+    // True when the meshes came from the mesh cache rather than the glTF.
+    bool fromCache() const { return cache_.isOpen(); }
+    size_t vertexCount() const;
+    size_t indexCount() const;
 
     void buildMesh(std::vector<core::Vertex>& outVertices,
                    std::vector<uint32_t>& outIndices) const override;
+    std::span<const MeshRange> meshRanges() const override { return meshRanges_; }
+    std::span<const ObjectNode> nodes() const override { return nodes_; }
     void update(float deltaSeconds, float elapsedSeconds) override;
 
 private:
     std::string path_{};
+    MeshCache cache_{}; // when open, holds the vertices and indices instead of vertices_/indices_
     std::vector<core::Vertex> vertices_{};
     std::vector<uint32_t> indices_{};
+    std::vector<MeshRange> meshRanges_{};
+    std::vector<ObjectNode> nodes_{};
     bool loaded_ = false;
     std::string error_{};
     glm::vec3 baseTranslation_{70.0f, 0.0f, 0.0f};
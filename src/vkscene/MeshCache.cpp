@@ -0,0 +1,220 @@
+#include "vkscene/MeshCache.h"
+
+#include "core/io/ContentHash.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <system_error>
+
+namespace vkscene {
+
+namespace {
+
+constexpr uint32_t kMeshCacheMagic = 0x434D4B56; // "VKMC"
+constexpr uint32_t kMeshCacheVersion = 1;
+constexpr uint64_t kSectionAlignment = 16;
+
+struct MeshCacheHeader {
+    uint32_t magic = kMeshCacheMagic;
+    uint32_t version = kMeshCacheVersion;
+    uint32_t loaderVersion = 0;
+    uint32_t vertexStride = sizeof(core::Vertex);
+    uint64_t sourceHash = 0;
+    uint64_t sourceSize = 0;
+    uint64_t vertexCount = 0;
+    uint64_t indexCount = 0;
+    uint32_t meshRangeCount = 0;
+    uint32_t nodeCount = 0;
+    uint64_t vertexOffset = 0;
+    uint64_t indexOffset = 0;
+    uint64_t meshRangeOffset = 0;
+    uint64_t nodeOffset = 0;
+    uint64_t nodeBytes = 0;
+};
+static_assert(sizeof(MeshCacheHeader) == 96, "mesh cache header layout changed");
+
+// Followed by nameLength bytes of name.
+struct NodeRecord {
+    int32_t parent = -1;
+    int32_t mesh = -1;
+    float localTransform[16] = {};
+    uint32_t nameLength = 0;
+};
+static_assert(sizeof(NodeRecord) == 76, "mesh cache node record layout changed");
+static_assert(sizeof(MeshRange) == 8, "mesh cache range layout changed");
+
+uint64_t alignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1U) & ~(alignment - 1U);
+}
+
+bool inFile(uint64_t offset, uint64_t size, uint64_t fileSize)
+{
+    return offset <= fileSize && size <= fileSize - offset;
+}
+
+} // namespace
+
+std::filesystem::path meshCachePath(const std::string& modelPath, const std::string& directory)
+{
+    const std::filesystem::path model(modelPath);
+    if (directory.empty()) {
+        std::filesystem::path path = model;
+        path += ".vkmesh";
+        return path;
+    }
+    std::error_code ec;
+    const std::string absolute = std::filesystem::absolute(model, ec).lexically_normal().string();
+    const uint64_t pathHash = core::io::hashContent({reinterpret_cast<const uint8_t*>(absolute.data()), absolute.size()});
+    std::ostringstream name;
+    name << model.filename().string() << '-' << std::hex << std::setw(16) << std::setfill('0') << pathHash << ".vkmesh";
+    return std::filesystem::path(directory) / name.str();
+}
+
+bool writeMeshCache(const std::filesystem::path& path, const MeshCacheKey& key, std::span<const core::Vertex> vertices,
+                    std::span<const uint32_t> indices, std::span<const MeshRange> meshRanges, std::span<const ObjectNode> nodes)
+{
+    std::vector<uint8_t> nodeSection;
+    for (const ObjectNode& node : nodes) {
+        NodeRecord record{};
+        record.parent = node.parent;
+        record.mesh = node.mesh;
+        std::memcpy(record.localTransform, &node.localTransform[0][0], sizeof(record.localTransform));
+        record.nameLength = static_cast<uint32_t>(node.name.size());
+        const size_t at = nodeSection.size();
+        nodeSection.resize(at + sizeof(record) + node.name.size());
+        std::memcpy(nodeSection.data() + at, &record, sizeof(record));
+        std::memcpy(nodeSection.data() + at + sizeof(record), node.name.data(), node.name.size());
+    }
+
+    MeshCacheHeader header{};
+    header.loaderVersion = key.loaderVersion;
+    header.sourceHash = key.sourceHash;
+    header.sourceSize = key.sourceSize;
+    header.vertexCount = vertices.size();
+    header.indexCount = indices.size();
+    header.meshRangeCount = static_cast<uint32_t>(meshRanges.size());
+    header.nodeCount = static_cast<uint32_t>(nodes.size());
+    header.vertexOffset = alignUp(sizeof(header), kSectionAlignment);
+    header.indexOffset = alignUp(header.vertexOffset + vertices.size_bytes(), kSectionAlignment);
+    header.meshRangeOffset = alignUp(header.indexOffset + indices.size_bytes(), kSectionAlignment);
+    header.nodeOffset = alignUp(header.meshRangeOffset + meshRanges.size_bytes(), kSectionAlignment);
+    header.nodeBytes = nodeSection.size();
+
+    std::error_code ec;
+    if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path(), ec);
+    std::filesystem::path tmpPath = path;
+    tmpPath += ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        uint64_t written = 0;
+        const auto write = [&](uint64_t offset, const void* data, size_t size) {
+            static const char zeros[kSectionAlignment] = {};
+            out.write(zeros, static_cast<std::streamsize>(offset - written));
+            out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            written = offset + size;
+        };
+        write(0, &header, sizeof(header));
+        write(header.vertexOffset, vertices.data(), vertices.size_bytes());
+        write(header.indexOffset, indices.data(), indices.size_bytes());
+        write(header.meshRangeOffset, meshRanges.data(), meshRanges.size_bytes());
+        write(header.nodeOffset, nodeSection.data(), nodeSection.size());
+        if (!out) {
+            out.close();
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+    }
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+bool MeshCache::open(const std::filesystem::path& path, const MeshCacheKey& key)
+{
+    close();
+    if (!file_.open(path) || file_.size() < sizeof(MeshCacheHeader)) {
+        close();
+        return false;
+    }
+
+    MeshCacheHeader header{};
+    std::memcpy(&header, file_.data(), sizeof(header));
+    const uint64_t size = file_.size();
+    const bool current = header.magic == kMeshCacheMagic && header.version == kMeshCacheVersion && header.loaderVersion == key.loaderVersion &&
+                         header.vertexStride == sizeof(core::Vertex) && header.sourceHash == key.sourceHash && header.sourceSize == key.sourceSize;
+    const bool counts = header.vertexCount <= size / sizeof(core::Vertex) && header.indexCount <= size / sizeof(uint32_t);
+    if (!current || !counts || !inFile(header.vertexOffset, header.vertexCount * sizeof(core::Vertex), size) ||
+        !inFile(header.indexOffset, header.indexCount * sizeof(uint32_t), size) ||
+        !inFile(header.meshRangeOffset, uint64_t{header.meshRangeCount} * sizeof(MeshRange), size) || !inFile(header.nodeOffset, header.nodeBytes, size)) {
+        close();
+        return false;
+    }
+    vertexBytes_ = file_.bytes().subspan(static_cast<size_t>(header.vertexOffset), static_cast<size_t>(header.vertexCount * sizeof(core::Vertex)));
+    indexBytes_ = file_.bytes().subspan(static_cast<size_t>(header.indexOffset), static_cast<size_t>(header.indexCount * sizeof(uint32_t)));
+
+    // The source hash says the cache is current, not that it is intact: check everything that
+    // would make a draw read outside the buffers.
+    uint32_t maxIndex = 0;
+    for (size_t i = 0; i < indexBytes_.size(); i += sizeof(uint32_t)) {
+        uint32_t index;
+        std::memcpy(&index, indexBytes_.data() + i, sizeof(index));
+        maxIndex = std::max(maxIndex, index);
+    }
+    if (header.indexCount > 0 && maxIndex >= header.vertexCount) {
+        close();
+        return false;
+    }
+
+    meshRanges_.resize(header.meshRangeCount);
+    if (!meshRanges_.empty()) std::memcpy(meshRanges_.data(), file_.data() + header.meshRangeOffset, meshRanges_.size() * sizeof(MeshRange));
+    for (const MeshRange& range : meshRanges_) {
+        if (range.firstIndex > header.indexCount || range.indexCount > header.indexCount - range.firstIndex) {
+            close();
+            return false;
+        }
+    }
+
+    const uint8_t* p = file_.data() + header.nodeOffset;
+    const uint8_t* const end = p + header.nodeBytes;
+    nodes_.reserve(header.nodeCount);
+    for (uint32_t i = 0; i < header.nodeCount; ++i) {
+        NodeRecord record{};
+        if (static_cast<size_t>(end - p) < sizeof(record)) break;
+        std::memcpy(&record, p, sizeof(record));
+        p += sizeof(record);
+        const bool linked = record.parent >= -1 && record.parent < static_cast<int32_t>(i) && record.mesh >= -1 &&
+                            record.mesh < static_cast<int32_t>(header.meshRangeCount);
+        if (!linked || record.nameLength > static_cast<size_t>(end - p)) break;
+        ObjectNode node;
+        node.name.assign(reinterpret_cast<const char*>(p), record.nameLength);
+        p += record.nameLength;
+        node.parent = record.parent;
+        node.mesh = record.mesh;
+        std::memcpy(&node.localTransform[0][0], record.localTransform, sizeof(record.localTransform));
+        nodes_.push_back(std::move(node));
+    }
+    if (nodes_.size() != header.nodeCount) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MeshCache::close()
+{
+    file_.close();
+    vertexBytes_ = {};
+    indexBytes_ = {};
+    meshRanges_.clear();
+    nodes_.clear();
+}
+
+} // namespace vkscene
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "core/RenderTypes.h"
+#include "core/io/MappedFile.h"
+#include "vkscene/RenderObject.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace vkscene {
+
+// What a cooked mesh was made from. A cache is only used when all three match the source as it
+// is now: the hash and size of every source file, and the version of the loader that cooked it.
+struct MeshCacheKey {
+    uint64_t sourceHash = 0;
+    uint64_t sourceSize = 0;
+    uint32_t loaderVersion = 0;
+};
+
+// Where the cooked mesh of a model lives; an empty directory means next to the model.
+struct MeshCacheOptions {
+    bool enabled = true;
+    std::string directory{};
+};
+
+// path/to/model.glb.vkmesh, or directory/model.glb-<hash of the model path>.vkmesh so that models
+// of the same name in different folders do not evict each other.
+std::filesystem::path meshCachePath(const std::string& modelPath, const std::string& directory);
+
+// Writes a .vkmesh file (via a temporary file and rename, so readers never see a partial one):
+//   header (96 bytes): "VKMC", version, loaderVersion, vertexStride, sourceHash, sourceSize,
+//                      vertexCount, indexCount, meshRangeCount, nodeCount, section offsets
+//   vertices (core::Vertex), indices (u32), mesh ranges {firstIndex, indexCount},
+//   nodes {parent, mesh, localTransform, nameLength, name}, each section 16-byte aligned.
+bool writeMeshCache(const std::filesystem::path& path, const MeshCacheKey& key, std::span<const core::Vertex> vertices,
+                    std::span<const uint32_t> indices, std::span<const MeshRange> meshRanges, std::span<const ObjectNode> nodes);
+
+// Read-only view of a mapped .vkmesh file. The vertex and index blobs stay in the mapping, ready to
+// be copied into upload memory; mesh ranges and nodes are small and decoded on open.
+class MeshCache {
+public:
+    // Maps and validates path against key; on failure returns false and leaves the cache closed.
+    bool open(const std::filesystem::path& path, const MeshCacheKey& key);
+    void close();
+
+    bool isOpen() const { return file_.isOpen(); }
+    size_t vertexCount() const { return vertexBytes_.size() / sizeof(core::Vertex); }
+    size_t indexCount() const { return indexBytes_.size() / sizeof(uint32_t); }
+    std::span<const uint8_t> vertexBytes() const { return vertexBytes_; }
+    std::span<const uint8_t> indexBytes() const { return indexBytes_; }
+    const std::vector<MeshRange>& meshRanges() const { return meshRanges_; }
+    const std::vector<ObjectNode>& nodes() const { return nodes_; }
+
+private:
+    core::io::MappedFile file_{};
+    std::span<const uint8_t> vertexBytes_{};
+    std::span<const uint8_t> indexBytes_{};
+    std::vector<MeshRange> meshRanges_{};
+    std::vector<ObjectNode> nodes_{};
+};
+
+} // namespace vkscene
@@ -4,7 +4,9 @@
 
 #include <glm/glm.hpp>
 
+#include <cstdint>
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -25,6 +27,21 @@ struct Material {
     glm::vec4 baseColor{1.0f};
 };
 
+// Index range of one mesh within an object's buildMesh output.
+struct MeshRange {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+};
+
+// A node of an object's own hierarchy, such as a glTF node tree. Scene mirrors these as scene
+// graph nodes under the object's node; a node with a mesh draws that mesh at its world transform.
+struct ObjectNode {
+    std::string name;
+    int32_t parent = -1; // earlier index into the object's nodes, or -1 for the object's own node
+    glm::mat4 localTransform{1.0f};
+    int32_t mesh = -1; // index into meshRanges(), or -1
+};
+
 class RenderObject {
 public:
     virtual ~RenderObject() = default;
@@ -38,6 +55,10 @@ public:
     virtual void buildMesh(std::vector<core::Vertex>& outVertices,
                            std::vector<uint32_t>& outIndices) const = 0;
 
+    // Objects without nodes draw their whole buildMesh output once, at modelMatrix().
+    virtual std::span<const MeshRange> meshRanges() const { return {}; }
+    virtual std::span<const ObjectNode> nodes() const { return {}; }
+
     virtual void update(float /*deltaSeconds*/, float /*elapsedSeconds*/) {}
 
 protected:
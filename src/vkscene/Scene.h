@@ -4,13 +4,21 @@
 #include "core/SceneGraph.h"
 #include "vkscene/RenderObject.h"
 
+#include <cstdint>
 #include <memory>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 namespace vkscene {
 
+// A scene graph node drawing one of its object's meshes.
+struct MeshInstance {
+    core::SceneNodeId node = 0;
+    uint32_t mesh = 0;
+};
+
 class Scene {
 public:
     core::SceneNodeId rootNode() const { return sceneGraph_.root(); }
@@ -27,9 +35,18 @@ public:
 
         const core::SceneNodeId node = sceneGraph_.createNode(nodeName, parent, entity);
         objects_[node] = object;
+        addObjectNodes(node, *object);
         return node;
     }
 
+    // Mesh-bearing nodes of the object at node, in the object's node order.
+    std::span<const MeshInstance> meshInstances(core::SceneNodeId node) const
+    {
+        auto it = meshInstances_.find(node);
+        if (it == meshInstances_.end()) return {};
+        return it->second;
+    }
+
     RenderObjectPtr object(core::SceneNodeId node) const
     {
         auto it = objects_.find(node);
@@ -70,9 +87,28 @@ public:
     const core::EcsWorld& ecs() const { return ecs_; }
 
 private:
+    // Object nodes only carry static local transforms; they follow the object's node through
+    // updateWorldTransforms().
+    void addObjectNodes(core::SceneNodeId objectNode, const RenderObject& object)
+    {
+        const std::span<const ObjectNode> nodes = object.nodes();
+        if (nodes.empty()) return;
+        std::vector<core::SceneNodeId> ids(nodes.size(), objectNode);
+        std::vector<MeshInstance>& instances = meshInstances_[objectNode];
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            const ObjectNode& desc = nodes[i];
+            const bool parentValid = desc.parent >= 0 && static_cast<size_t>(desc.parent) < i;
+            const core::SceneNodeId parent = parentValid ? ids[static_cast<size_t>(desc.parent)] : objectNode;
+            ids[i] = sceneGraph_.createNode(desc.name, parent, 0);
+            sceneGraph_.find(ids[i])->localTransform = desc.localTransform;
+            if (desc.mesh >= 0) instances.push_back(MeshInstance{ids[i], static_cast<uint32_t>(desc.mesh)});
+        }
+    }
+
     core::SceneGraph sceneGraph_{};
     core::EcsWorld ecs_{};
     std::unordered_map<core::SceneNodeId, RenderObjectPtr> objects_{};
+    std::unordered_map<core::SceneNodeId, std::vector<MeshInstance>> meshInstances_{};
 };
 
 } // namespace vkscene
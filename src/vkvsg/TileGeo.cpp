@@ -1,4 +1,5 @@
 #include "vkvsg/TileGeo.h"
+#include "core/image/ProceduralEarthTexture.h"
 
 #include <vsg/all.h>
 #ifdef VKVSG_HAS_VSGXCHANGE
@@ -6,6 +7,7 @@
 #endif
 
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <string>
 
@@ -14,44 +16,11 @@ namespace
 
 vsg::ref_ptr<vsg::Data> createProceduralEarthTexture()
 {
-    const uint32_t width = 2048;
-    const uint32_t height = 1024;
-    auto tex = vsg::ubvec4Array2D::create(width, height, vsg::Data::Properties{VK_FORMAT_R8G8B8A8_UNORM});
-
-    for (uint32_t y = 0; y < height; ++y)
-    {
-        const double v = static_cast<double>(y) / static_cast<double>(height - 1);
-        const double lat = (0.5 - v) * vsg::PI;
-        const double polar = std::pow(std::abs(std::sin(lat)), 6.0);
-
-        for (uint32_t x = 0; x < width; ++x)
-        {
-            const double u = static_cast<double>(x) / static_cast<double>(width - 1);
-            const double lon = (u * 2.0 - 1.0) * vsg::PI;
-
-            const double continent = 0.5 + 0.5 * std::sin(5.0 * lon) * std::cos(3.0 * lat);
-            const bool isLand = continent > 0.62 || (std::abs(lat) > vsg::radians(52.0) && continent > 0.48);
-
-            vsg::ubvec4 color;
-            if (polar > 0.82)
-            {
-                color = vsg::ubvec4(236, 244, 252, 255);
-            }
-            else if (isLand)
-            {
-                const uint8_t g = static_cast<uint8_t>(90 + 80 * (1.0 - polar));
-                color = vsg::ubvec4(45, g, 52, 255);
-            }
-            else
-            {
-                const uint8_t b = static_cast<uint8_t>(130 + 70 * (1.0 - polar));
-                color = vsg::ubvec4(20, 65, b, 255);
-            }
-
-            tex->set(x, y, color);
-        }
-    }
+    const core::image::ProceduralEarthParams params{core::image::ProceduralEarthStyle::Continents, 2048, 1024};
+    const core::image::ProceduralEarthImage earth = core::image::loadOrGenerateProceduralEarth(params, core::image::kProceduralCacheDir);
 
+    auto tex = vsg::ubvec4Array2D::create(earth.width(), earth.height(), vsg::Data::Properties{VK_FORMAT_R8G8B8A8_UNORM});
+    std::memcpy(tex->dataPointer(), earth.data(), earth.size());
     tex->dirty();
     return tex;
 }